@@ -0,0 +1,147 @@
+#include "FormesSynthetiques.h"
+#include "ImageView.h"
+
+#include <random>
+#include <stdexcept>
+
+const vector<string> &noms_formes_synthetiques()
+{
+	static const vector<string> noms = { "disques", "taches", "texte" };
+	return noms;
+}
+
+/*--------------------------------------------------------------
+ * Disques : le rayon suit la taille de l'image, de 1/64 à 1/8,
+ * et on ajoute des disques jusqu'à couvrir ~1/3 de l'image
+ * (estimation par les aires, sans compter les chevauchements).
+ * ------------------------------------------------------------*/
+static void generer_disques (ImageView<int> img, mt19937 &alea)
+{
+	int n = img._cols();
+	uniform_int_distribution<int> pos(0, n-1), rayon(max(1, n/64), max(1, n/8));
+	double aire = 0;
+
+	while (aire < n * double(n) / 3)
+	{
+		int cx = pos(alea), cy = pos(alea), r = rayon(alea);
+		aire += 3.14159 * r * r;
+		for (int y = max(0, cy-r); y <= min(n-1, cy+r); y++)
+		{
+			int *l = img.ligne(y);
+			int dy = y - cy;
+			for (int x = max(0, cx-r); x <= min(n-1, cx+r); x++)
+			{
+				int dx = x - cx;
+				if (dx*dx + dy*dy <= r*r) l[x] = 255;
+			}
+		}
+	}
+}
+
+/*--------------------------------------------------------------
+ * Taches : valeurs aléatoires sur une grille de pas @pas,
+ * interpolées en bilinéaire, pixel forme si la valeur dépasse
+ * 0.55. Le pas fixe (32 pixels) garde des taches de même
+ * échelle à toutes les tailles : le nombre de contours croît
+ * comme la surface.
+ * ------------------------------------------------------------*/
+static void generer_taches (ImageView<int> img, mt19937 &alea)
+{
+	const int pas = 32;
+	int n = img._cols(), m = n / pas + 2;
+	uniform_real_distribution<float> val(0, 1);
+	vector<float> grille(m * m);
+	for (unsigned i = 0; i < grille.size(); i++) grille[i] = val(alea);
+
+	for (int y = 0; y < n; y++)
+	{
+		int *l = img.ligne(y);
+		int gy = y / pas;
+		float fy = (y % pas) / float(pas);
+		const float *g0 = &grille[gy * m], *g1 = &grille[(gy+1) * m];
+		for (int x = 0; x < n; x++)
+		{
+			int gx = x / pas;
+			float fx = (x % pas) / float(pas);
+			float haut = g0[gx] + fx * (g0[gx+1] - g0[gx]);
+			float bas  = g1[gx] + fx * (g1[gx+1] - g1[gx]);
+			l[x] = (haut + fy * (bas - haut)) > 0.55f ? 255 : 0;
+		}
+	}
+}
+
+/*--------------------------------------------------------------
+ * Police 5x7 : une ligne de 5 bits par rangée, bit 4 à gauche.
+ * ------------------------------------------------------------*/
+struct Glyphe
+{
+	char c;
+	unsigned char rangs[7];
+};
+
+static const Glyphe POLICE[] = {
+	{ 'C', { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E } },
+	{ 'D', { 0x1E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1E } },
+	{ 'E', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F } },
+	{ 'G', { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F } },
+	{ 'I', { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+	{ 'M', { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 } },
+	{ 'O', { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+	{ 'R', { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 } },
+	{ 'S', { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E } },
+	{ 'T', { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+};
+
+static const Glyphe *chercher_glyphe (char c)
+{
+	for (unsigned i = 0; i < sizeof(POLICE) / sizeof(POLICE[0]); i++)
+		if (POLICE[i].c == c) return &POLICE[i];
+	return nullptr;		// espace
+}
+
+/*--------------------------------------------------------------
+ * Texte : une case de 6x9 par caractère, agrandie d'un facteur
+ * taille/256 (au moins 1) ; chaque ligne reprend la phrase avec
+ * un décalage aléatoire pour ne pas aligner les lettres.
+ * ------------------------------------------------------------*/
+static void generer_texte (ImageView<int> img, mt19937 &alea)
+{
+	const string phrase = "GEOMETRIE DISCRETE ";
+	int n = img._cols();
+	int echelle = max(1, n / 256);
+	int larg = 6 * echelle, haut = 9 * echelle;
+	uniform_int_distribution<int> decalage(0, int(phrase.size()) - 1);
+
+	for (int y0 = echelle; y0 + 7 * echelle <= n; y0 += haut)
+	{
+		int debut = decalage(alea);
+		for (int k = 0; (k + 1) * larg <= n; k++)
+		{
+			const Glyphe *g = chercher_glyphe(phrase[(debut + k) % phrase.size()]);
+			if (!g) continue;
+			for (int r = 0; r < 7 * echelle; r++)
+			{
+				int *l = img.ligne(y0 + r);
+				unsigned char bits = g->rangs[r / echelle];
+				for (int c = 0; c < 5 * echelle; c++)
+					if (bits & (0x10 >> (c / echelle))) l[k * larg + c] = 255;
+			}
+		}
+	}
+}
+
+cv::Mat generer_forme_synthetique (const string &nom, int taille, unsigned graine)
+{
+	if (taille <= 0)
+		throw runtime_error("forme synthétique : taille invalide " + to_string(taille));
+
+	cv::Mat img(taille, taille, CV_32SC1);
+	img.setTo(0);
+	mt19937 alea(graine);
+
+	if      (nom == "disques")	generer_disques(img, alea);
+	else if (nom == "taches")	generer_taches(img, alea);
+	else if (nom == "texte")	generer_texte(img, alea);
+	else throw runtime_error("forme synthétique inconnue : '" + nom + "'");
+	return img;
+}
@@ -0,0 +1,36 @@
+#ifndef FORMES_SYNTHETIQUES_H
+#define FORMES_SYNTHETIQUES_H
+
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Images binaires synthétiques pour les mesures : CV_32SC1 de
+ * taille @taille x @taille, forme à 255 et fond à 0, comme après
+ * le seuillage des TP. Le résultat ne dépend que de la forme, de
+ * la taille et de la graine.
+ *
+ *  - "disques" : disques pleins de rayons variés, qui peuvent se
+ *    chevaucher ; environ un tiers de l'image est forme ;
+ *  - "taches"  : bruit de valeur (grille aléatoire interpolée)
+ *    seuillé : grandes taches aux bords irréguliers, avec trous
+ *    et composantes isolées ;
+ *  - "texte"   : lignes de texte en police bitmap 5x7, agrandie
+ *    avec l'image : beaucoup de contours courts et de traits
+ *    fins.
+ * ------------------------------------------------------------*/
+
+const int FORMES_GRAINE = 2018;
+
+const vector<string> &noms_formes_synthetiques();
+
+// runtime_error si @nom n'est pas une forme connue
+cv::Mat generer_forme_synthetique (const string &nom, int taille,
+	unsigned graine = FORMES_GRAINE);
+
+#endif // FORMES_SYNTHETIQUES_H
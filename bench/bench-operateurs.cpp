@@ -0,0 +1,482 @@
+/*
+ * bench-operateurs.cpp - mesure des opérateurs des TP
+ *
+ * Chaque mesure applique un opérateur à une forme synthétique
+ * (voir FormesSynthetiques.h) d'une taille donnée :
+ *
+ *     operateur[:param]/forme/taille    ex. dt:3-4/disques/1024
+ *
+ * L'entrée est recopiée avant chaque itération, hors chrono ; on
+ * répète jusqu'à avoir chronométré au moins -temps_min secondes.
+ * Chaque mesure tourne dans un processus fils : le pic de mémoire
+ * (ru_maxrss) est le sien, et un opérateur qui plante ne fait
+ * échouer que sa mesure.
+ *
+ * La sortie JSON suit le format de Google Benchmark (context,
+ * benchmarks[].name, iterations, real_time, cpu_time, time_unit)
+ * pour être relue par ses outils de comparaison, avec en plus :
+ *     mpix_par_s       mégapixels de l'image traités par seconde
+ *     pic_rss_octets   pic de mémoire résidente du processus
+ *
+ * usage : bench-operateurs [-tailles 256,1024,4096] [-formes f,...]
+ *         [-filtre regex] [-temps_min s] [--threads N] [-o fichier]
+ *         [-liste]
+ */
+
+#include <iostream>
+#include <cstring>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <opencv2/opencv.hpp>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "FormesSynthetiques.h"
+#include "ImageView.h"
+#include "MarquageContours.h"
+#include "SuiviContours.h"
+#include "ContoursF8.h"
+#include "ApproxPolygonale.h"
+#include "DemiMasque.h"
+#include "Chanfrein.h"
+#include "Sedt.h"
+#include "NiveauxSedt.h"
+#include "PoolThreads.h"
+#include "Morphologie.h"
+#include "ImageBinaire.h"
+
+#include <vector>
+using namespace std;
+
+//------------------------ M E S    D O N N E E S -----------------------------
+
+const double BENCH_TEMPS_MIN = 0.5;		// secondes chronométrées par mesure
+const int BENCH_TAILLE_MAX = 16384;		// côté maximal des images
+const long BENCH_ITER_MAX = 1000000;
+
+/*--------------------------------------------------------------
+ * Mesure installée sur une forme : @preparer remet l'entrée en
+ * place (hors chrono), @mesurer est chronométré.
+ * ------------------------------------------------------------*/
+struct Mesure
+{
+	function<void()> preparer;
+	function<void()> mesurer;
+};
+
+struct Operateur
+{
+	string nom;
+	function<Mesure(cv::Mat forme)> installer;
+};
+
+struct Resultat
+{
+	long iterations;
+	double temps_reel, temps_cpu, temps_min;	// par itération, en secondes
+	double mpix_par_s;
+	long pic_rss;
+};
+
+//------------------------- O P E R A T E U R S -------------------------------
+
+/*--------------------------------------------------------------
+ * Opérateur sur place sur une copie de la forme ; @inverser
+ * passe à la convention du TP7 (forme à 0, fond à 255).
+ * ------------------------------------------------------------*/
+static function<Mesure(cv::Mat)> sur_place (function<void(cv::Mat)> op, bool inverser = false)
+{
+	return [op, inverser](cv::Mat forme)
+	{
+		shared_ptr<cv::Mat> entree = make_shared<cv::Mat>(forme.clone());
+		shared_ptr<cv::Mat> travail = make_shared<cv::Mat>(forme.clone());
+		if (inverser)
+		{
+			ImageView<int> e(*entree);
+			for (int y = 0; y < e._rows(); y++)
+			for (int x = 0; x < e._cols(); x++)
+				e(y, x) = 255 - e(y, x);
+		}
+		Mesure m;
+		m.preparer = [entree, travail]() { entree->copyTo(*travail); };
+		m.mesurer = [op, travail]() { op(*travail); };
+		return m;
+	};
+}
+
+// Élément structurant du TP7 (forme à 0) : carré k x k ou disque de rayon r
+static cv::Mat element_structurant (const string &type, int t)
+{
+	int k = type == "carre" ? t : 2*t + 1;
+	cv::Mat es(k, k, CV_32SC1);
+	for (int y = 0; y < k; y++)
+	for (int x = 0; x < k; x++)
+	{
+		int dx = x - k/2, dy = y - k/2;
+		bool dedans = type == "carre" || dx*dx + dy*dy <= t*t;
+		es.at<int>(y, x) = dedans ? 0 : 255;
+	}
+	return es;
+}
+
+static void ajouter_morphologie (vector<Operateur> &ops, const string &type, int t)
+{
+	string param = ":" + type + ":" + to_string(t);
+	cv::Mat es = element_structurant(type, t);
+	cv::Point centre(es.cols/2, es.rows/2);
+
+	// Morphologie est construite à chaque appel, comme dans le TP7
+	ops.push_back({ "dilatation" + param, sur_place([es, centre](cv::Mat img) {
+		Morphologie(es, centre).dilatation(img); }, true) });
+	ops.push_back({ "erosion" + param, sur_place([es, centre](cv::Mat img) {
+		Morphologie(es, centre).erosion(img); }, true) });
+
+	if (type != "disque") return;
+	ops.push_back({ "dilatation_bin" + param, sur_place([es, centre](cv::Mat img) {
+		Morphologie morpho(es, centre);
+		ImageBinaire bin(img);
+		bin.dilatation(morpho.get_segments());
+		bin.vers_img_niv(img); }, true) });
+	ops.push_back({ "erosion_bin" + param, sur_place([es, centre](cv::Mat img) {
+		Morphologie morpho(es, centre);
+		ImageBinaire bin(img);
+		bin.erosion(morpho.get_segments());
+		bin.vers_img_niv(img); }, true) });
+}
+
+/*--------------------------------------------------------------
+ * Approximation polygonale de tous les contours de la forme :
+ * les contours sont suivis une fois à l'installation, la mesure
+ * décode chaque chaîne de Freeman et l'approxime (comme le TP3).
+ * ------------------------------------------------------------*/
+static function<Mesure(cv::Mat)> approximation (bool enveloppe, double seuil)
+{
+	return [enveloppe, seuil](cv::Mat forme)
+	{
+		cv::Mat img = forme.clone();
+		shared_ptr<ContoursF8> contours = make_shared<ContoursF8>();
+		suivre_contours_c8(img, *contours);
+		shared_ptr<ApproxPolygonale> approx = make_shared<ApproxPolygonale>(enveloppe);
+		shared_ptr<vector<cv::Point> > pts = make_shared<vector<cv::Point> >();
+		shared_ptr<vector<int> > flag = make_shared<vector<int> >();
+
+		Mesure m;
+		m.preparer = []() {};
+		m.mesurer = [=]()
+		{
+			for (int c = 0; c < contours->_nb_contours(); c++)
+			{
+				pts->clear();
+				for (ContoursF8::Iterateur it = contours->debut(c); it != contours->fin(c); ++it)
+					pts->push_back(*it);
+				approx->approximer_ferme(pts->data(), int(pts->size()), seuil, *flag);
+			}
+		};
+		return m;
+	};
+}
+
+static vector<Operateur> catalogue_operateurs()
+{
+	vector<Operateur> ops;
+	const char *noms_masques[] = {"d4", "d8", "2-3", "3-4", "5-7-11"};
+
+	ops.push_back({ "marquage:c8", sur_place([](cv::Mat img) { marquer_contours(img, 8); }) });
+	ops.push_back({ "marquage:c4", sur_place([](cv::Mat img) { marquer_contours(img, 4); }) });
+
+	ops.push_back({ "suivi:c8", sur_place([](cv::Mat img) {
+		ContoursF8 contours;
+		suivre_contours_c8(img, contours); }) });
+
+	for (int i = 0; i < M_LAST; i++)
+	{
+		shared_ptr<DemiMasque> dm = make_shared<DemiMasque>(NumeroMasque(i));
+		ops.push_back({ string("dt:") + noms_masques[i],
+			sur_place([dm](cv::Mat img) { calculer_dt_chanfrein(img, *dm); }) });
+	}
+
+	ops.push_back({ "sedt", sur_place([](cv::Mat img) { calculer_sedt_meijster(img, false); }) });
+
+	// Entrée : la SEDT de la forme, calculée à l'installation
+	ops.push_back({ "niveaux_sedt", [](cv::Mat forme) {
+		cv::Mat sedt = forme.clone();
+		calculer_sedt_meijster(sedt, false);
+		return sur_place([](cv::Mat img) {
+			NiveauxSedt niveaux;
+			calculer_niveaux_sedt(img, niveaux); })(sedt); } });
+
+	for (int i = M_3_4; i <= M_5_7_11; i++)
+	{
+		shared_ptr<DemiMasque> dm = make_shared<DemiMasque>(NumeroMasque(i));
+		ops.push_back({ string("axe_median:") + noms_masques[i],
+			sur_place([dm](cv::Mat img) { filtrer_axe_median_chanfrein(img, *dm, 0, true); }) });
+	}
+	// Même chaîne en euclidien exact : SEDT, axe, REDT, couleurs
+	ops.push_back({ "axe_median:sedt", sur_place([](cv::Mat img) {
+		cv::Mat sedt = img.clone();
+		calculer_sedt_meijster(sedt, false);
+		filtrer_axe_median_sedt(img, sedt, 0); }) });
+
+	ajouter_morphologie(ops, "carre", 3);
+	ajouter_morphologie(ops, "carre", 15);
+	ajouter_morphologie(ops, "carre", 63);
+	ajouter_morphologie(ops, "disque", 1);
+	ajouter_morphologie(ops, "disque", 7);
+	ajouter_morphologie(ops, "disque", 31);
+
+	ops.push_back({ "approx:balayage", approximation(false, 2.0) });
+	ops.push_back({ "approx:enveloppe", approximation(true, 2.0) });
+
+	return ops;
+}
+
+//------------------------------ M E S U R E S --------------------------------
+
+static double secondes_cpu()
+{
+	timespec t;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static Resultat executer_mesure (const Operateur &op, const string &forme, int taille,
+	double temps_min)
+{
+	Mesure m = op.installer(generer_forme_synthetique(forme, taille));
+
+	// Première exécution hors mesure : caches des masques, LUT, threads
+	m.preparer();
+	m.mesurer();
+
+	Resultat r = { 0, 0, 0, 1e30, 0, 0 };
+	while ((r.temps_reel < temps_min || r.iterations == 0) && r.iterations < BENCH_ITER_MAX)
+	{
+		m.preparer();
+		double cpu0 = secondes_cpu();
+		chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+		m.mesurer();
+		double dt = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+		r.temps_cpu += secondes_cpu() - cpu0;
+		r.temps_reel += dt;
+		r.temps_min = min(r.temps_min, dt);
+		r.iterations++;
+	}
+	r.temps_reel /= r.iterations;
+	r.temps_cpu /= r.iterations;
+	r.mpix_par_s = double(taille) * taille / r.temps_reel / 1e6;
+
+	rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	r.pic_rss = ru.ru_maxrss * 1024L;		// ru_maxrss est en Kio sous Linux
+	return r;
+}
+
+static string entree_json (const string &nom, const Resultat &r)
+{
+	ostringstream s;
+	s.precision(6);
+	s << "    {\n"
+	  << "      \"name\": \"" << nom << "\",\n"
+	  << "      \"run_name\": \"" << nom << "\",\n"
+	  << "      \"run_type\": \"iteration\",\n"
+	  << "      \"iterations\": " << r.iterations << ",\n"
+	  << "      \"real_time\": " << r.temps_reel * 1e3 << ",\n"
+	  << "      \"cpu_time\": " << r.temps_cpu * 1e3 << ",\n"
+	  << "      \"min_time\": " << r.temps_min * 1e3 << ",\n"
+	  << "      \"time_unit\": \"ms\",\n"
+	  << "      \"mpix_par_s\": " << r.mpix_par_s << ",\n"
+	  << "      \"pic_rss_octets\": " << r.pic_rss << "\n"
+	  << "    }";
+	return s.str();
+}
+
+static string erreur_json (const string &nom, const string &message)
+{
+	return "    {\n"
+		"      \"name\": \"" + nom + "\",\n"
+		"      \"run_name\": \"" + nom + "\",\n"
+		"      \"run_type\": \"iteration\",\n"
+		"      \"error_occurred\": true,\n"
+		"      \"error_message\": \"" + message + "\"\n"
+		"    }";
+}
+
+/*--------------------------------------------------------------
+ * Lance la mesure dans un fils, qui renvoie son Resultat par un
+ * tube. Le père ne calcule rien : le pool de threads n'est créé
+ * que dans les fils, après le fork.
+ * ------------------------------------------------------------*/
+static bool mesurer_dans_fils (const Operateur &op, const string &forme, int taille,
+	double temps_min, int nb_threads, Resultat &r, string &erreur)
+{
+	int tube[2];
+	if (pipe(tube) != 0) { erreur = "pipe"; return false; }
+
+	cout.flush();
+	cerr.flush();
+	pid_t pid = fork();
+	if (pid < 0) { erreur = "fork"; return false; }
+
+	if (pid == 0)
+	{
+		close(tube[0]);
+		int code = 0;
+		try {
+			if (nb_threads > 0) definir_nb_threads(nb_threads);
+			Resultat res = executer_mesure(op, forme, taille, temps_min);
+			if (write(tube[1], &res, sizeof(res)) != sizeof(res)) code = 1;
+		}
+		catch (exception &e) {
+			cerr << op.nom << ": " << e.what() << endl;
+			code = 1;
+		}
+		close(tube[1]);
+		_exit(code);		// sans destructeurs : le pool est abandonné
+	}
+
+	close(tube[1]);
+	ssize_t lu = read(tube[0], &r, sizeof(r));
+	close(tube[0]);
+
+	int statut = 0;
+	waitpid(pid, &statut, 0);
+	if (WIFSIGNALED(statut))
+		erreur = string("signal ") + to_string(WTERMSIG(statut));
+	else if (WEXITSTATUS(statut) != 0 || lu != sizeof(r))
+		erreur = "échec de la mesure";
+	return erreur.empty();
+}
+
+//--------------------------------- M A I N -----------------------------------
+
+static vector<string> decouper (const string &liste)
+{
+	vector<string> morceaux;
+	stringstream s(liste);
+	string m;
+	while (getline(s, m, ','))
+		if (!m.empty()) morceaux.push_back(m);
+	return morceaux;
+}
+
+// Lit une taille d'image : un entier entre 1 et BENCH_TAILLE_MAX, sans
+// caractère en trop. Rend false sinon.
+static bool lire_taille (const string &t, int &taille)
+{
+	size_t fin = 0;
+	try { taille = stoi(t, &fin); }
+	catch (exception &) { return false; }
+	return fin == t.size() && taille >= 1 && taille <= BENCH_TAILLE_MAX;
+}
+
+static void afficher_usage (char *nom_prog)
+{
+	cout << "Usage: " << nom_prog << "\n"
+		<< "   [-tailles 256,1024,4096]   côtés des images (jusqu'à " << BENCH_TAILLE_MAX << ")\n"
+		<< "   [-formes disques,taches,texte]\n"
+		<< "   [-filtre regex]            mesures dont le nom correspond\n"
+		<< "   [-temps_min s]             secondes chronométrées par mesure (" << BENCH_TEMPS_MIN << ")\n"
+		<< "   [--threads N]              taille du pool de threads\n"
+		<< "   [-o fichier.json]          sortie JSON (défaut : sortie standard)\n"
+		<< "   [-liste]                   affiche les mesures sans les lancer\n";
+}
+
+static string date_iso()
+{
+	time_t t = time(nullptr);
+	char s[32];
+	strftime(s, sizeof(s), "%Y-%m-%dT%H:%M:%S%z", localtime(&t));
+	return s;
+}
+
+int main (int argc, char **argv)
+{
+	vector<int> tailles = { 256, 1024, 4096 };
+	vector<string> formes = noms_formes_synthetiques();
+	string filtre = ".", sortie;
+	double temps_min = BENCH_TEMPS_MIN;
+	int nb_threads = 0;
+	bool liste = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string a = argv[i];
+		bool param = i+1 < argc;
+		if      (a == "-tailles" && param)		{ tailles.clear();
+			for (const string &t : decouper(argv[++i]))
+			{
+				int taille;
+				if (!lire_taille(t, taille)) { afficher_usage(argv[0]); return 1; }
+				tailles.push_back(taille);
+			}
+			if (tailles.empty()) { afficher_usage(argv[0]); return 1; } }
+		else if (a == "-formes" && param)		formes = decouper(argv[++i]);
+		else if (a == "-filtre" && param)		filtre = argv[++i];
+		else if (a == "-temps_min" && param)	temps_min = atof(argv[++i]);
+		else if (a == "--threads" && param)		nb_threads = atoi(argv[++i]);
+		else if (a == "-o" && param)			sortie = argv[++i];
+		else if (a == "-liste")					liste = true;
+		else { afficher_usage(argv[0]); return 1; }
+	}
+
+	vector<Operateur> ops = catalogue_operateurs();
+	regex re(filtre);
+	vector<string> entrees;
+
+	for (const Operateur &op : ops)
+	for (const string &forme : formes)
+	for (int taille : tailles)
+	{
+		string nom = op.nom + "/" + forme + "/" + to_string(taille);
+		if (!regex_search(nom, re)) continue;
+		if (liste) { cout << nom << endl; continue; }
+
+		Resultat r;
+		string erreur;
+		if (mesurer_dans_fils(op, forme, taille, temps_min, nb_threads, r, erreur))
+		{
+			fprintf(stderr, "%-36s %10.3f ms %10.1f MP/s %8.1f Mo  (%ld it.)\n",
+				nom.c_str(), r.temps_reel * 1e3, r.mpix_par_s, r.pic_rss / 1048576.0,
+				r.iterations);
+			entrees.push_back(entree_json(nom, r));
+		}
+		else
+		{
+			fprintf(stderr, "%-36s ERREUR : %s\n", nom.c_str(), erreur.c_str());
+			entrees.push_back(erreur_json(nom, erreur));
+		}
+	}
+	if (liste) return 0;
+
+	ostringstream json;
+	json << "{\n"
+		<< "  \"context\": {\n"
+		<< "    \"date\": \"" << date_iso() << "\",\n"
+		<< "    \"executable\": \"" << argv[0] << "\",\n"
+		<< "    \"num_cpus\": " << thread::hardware_concurrency() << ",\n"
+		<< "    \"threads\": " << (nb_threads > 0 ? nb_threads : int(thread::hardware_concurrency())) << ",\n"
+		<< "    \"temps_min\": " << temps_min << "\n"
+		<< "  },\n"
+		<< "  \"benchmarks\": [\n";
+	for (unsigned i = 0; i < entrees.size(); i++)
+		json << entrees[i] << (i+1 < entrees.size() ? ",\n" : "\n");
+	json << "  ]\n}\n";
+
+	if (sortie.empty()) cout << json.str();
+	else
+	{
+		ofstream f(sortie);
+		if (!f) { cerr << "Erreur : impossible d'écrire " << sortie << endl; return 1; }
+		f << json.str();
+	}
+	return 0;
+}
@@ -0,0 +1,278 @@
+#include "ApproxPolygonale.h"
+
+#include <algorithm>
+
+static inline int64_t produit_vectoriel(cv::Point o, cv::Point a, cv::Point b)
+{
+	return int64_t(a.x - o.x) * (b.y - o.y) - int64_t(a.y - o.y) * (b.x - o.x);
+}
+
+static inline int64_t distance2(cv::Point a, cv::Point b)
+{
+	return int64_t(b.x - a.x) * (b.x - a.x) + int64_t(b.y - a.y) * (b.y - a.y);
+}
+
+//-------------- C L A S S E     A P P R O X P O L Y G O N A L E ---------------
+
+ApproxPolygonale::ApproxPolygonale (bool enveloppe) :
+	enveloppe(enveloppe), pts(NULL), n(0)
+{
+	;
+}
+
+ApproxPolygonale::~ApproxPolygonale()
+{
+	;
+}
+
+bool ApproxPolygonale::_enveloppe() {	return enveloppe;	}
+
+void ApproxPolygonale::changer_enveloppe(bool enveloppe)
+{
+	this->enveloppe = enveloppe;
+}
+
+void ApproxPolygonale::approximer_ouvert(const cv::Point *pts, int n, double seuil,
+	vector<int> &flag)
+{
+	flag.assign(n, 0);
+	if (n == 0) return;
+	flag[0] = flag[n-1] = 1;
+
+	this->pts = pts;
+	this->n = n;
+	if (enveloppe && n > APPROX_FEUILLE) construire(1, 0, 0, n);
+
+	pile.clear();
+	pile.push_back({0, n-1});
+	decouper(seuil, flag);
+}
+
+void ApproxPolygonale::approximer_ferme(const cv::Point *pts, int n, double seuil,
+	vector<int> &flag)
+{
+	flag.assign(n, 0);
+	if (n == 0) return;
+	flag[0] = flag[n-1] = 1;
+	if (n <= 2) return;
+
+	// B : point le plus loin de A, sommet quel que soit le seuil
+	int b = 1;
+	int64_t d_max = -1;
+	for (int i = 1; i < n-1; i++)
+	{
+		int64_t d = distance2(pts[0], pts[i]);
+		if (d > d_max) { d_max = d; b = i; }
+	}
+	flag[b] = 1;
+
+	this->pts = pts;
+	this->n = n;
+	if (enveloppe && n > APPROX_FEUILLE) construire(1, 0, 0, n);
+
+	pile.clear();
+	pile.push_back({b, n-1});
+	pile.push_back({0, b});
+	decouper(seuil, flag);
+}
+
+/*--------------------------------------------------------------
+ * Douglas-Peucker sur la pile de morceaux.
+ * ------------------------------------------------------------*/
+void ApproxPolygonale::decouper(double seuil, vector<int> &flag)
+{
+	long double seuil2 = (long double) seuil * seuil;
+
+	while (!pile.empty())
+	{
+		Morceau m = pile.back();
+		pile.pop_back();
+		if (m.fin - m.debut < 2) continue;
+
+		// d(P)^2 = num / den, num et den entiers exacts
+		int64_t num, den;
+		int p = plus_loin(m.debut, m.fin, num, den);
+		if ((long double) num <= seuil2 * den) continue;
+
+		flag[p] = 1;
+		pile.push_back({p, m.fin});
+		pile.push_back({m.debut, p});
+	}
+}
+
+/*--------------------------------------------------------------
+ * Point de ]@debut, @fin[ le plus loin de la corde [A B], avec
+ * A = pts[debut] et B = pts[fin]. Si A = B, c'est le point le
+ * plus loin de A.
+ * ------------------------------------------------------------*/
+int ApproxPolygonale::plus_loin(int debut, int fin, int64_t &num, int64_t &den)
+{
+	cv::Point A = pts[debut], B = pts[fin];
+	den = distance2(A, B);
+
+	if (den == 0)
+	{
+		int p = debut + 1;
+		num = -1;
+		for (int i = debut + 1; i < fin; i++)
+		{
+			int64_t d = distance2(A, pts[i]);
+			if (d > num) { num = d; p = i; }
+		}
+		den = 1;
+		return p;
+	}
+
+	int p = debut + 1;
+	int64_t pv_max = -1;
+
+	if (!enveloppe || fin - debut <= 2 * APPROX_FEUILLE)
+	{
+		for (int i = debut + 1; i < fin; i++)
+		{
+			int64_t pv = produit_vectoriel(A, B, pts[i]);
+			if (pv < 0) pv = -pv;
+			if (pv > pv_max) { pv_max = pv; p = i; }
+		}
+	}
+	else
+	{
+		// AB ^ AP = a Px + b Py - c : maximum et minimum de a x + b y
+		int64_t a = -(B.y - A.y), b = B.x - A.x;
+		int64_t c = a * A.x + b * A.y;
+		int64_t f_max = INT64_MIN, f_min = INT64_MIN;
+		int p_max = p, p_min = p;
+		chercher_extreme(1, 0, 0, n, debut + 1, fin - 1, a, b, f_max, p_max);
+		chercher_extreme(1, 0, 0, n, debut + 1, fin - 1, -a, -b, f_min, p_min);
+		// f_min contient ici -min(a x + b y)
+		if (f_max - c >= f_min + c) { pv_max = f_max - c; p = p_max; }
+		else { pv_max = f_min + c; p = p_min; }
+	}
+
+	// coordonnées < 2^15 : |pv| < 2^31 et pv^2 tient dans un int64_t
+	num = pv_max * pv_max;
+	return p;
+}
+
+/*--------------------------------------------------------------
+ * Noeud @k de l'arbre, sur les indices [@lo, @hi[ : trie ses
+ * indices par (x, y) dans tries[niveau] en fusionnant ceux de
+ * ses fils, puis calcule ses enveloppes haute et basse par la
+ * chaîne monotone d'Andrew (points alignés retirés).
+ * ------------------------------------------------------------*/
+void ApproxPolygonale::construire(int k, int niveau, int lo, int hi)
+{
+	if (k == 1)
+	{
+		sommets.clear();
+		int nb_niveaux = 1, nb_noeuds = 2;
+		for (int t = n; t > APPROX_FEUILLE; t = (t + 1) / 2)
+			{ nb_niveaux++; nb_noeuds *= 2; }
+		if ((int) tries.size() < nb_niveaux) tries.resize(nb_niveaux);
+		for (int i = 0; i < nb_niveaux; i++) tries[i].resize(n);
+		noeuds.resize(nb_noeuds);
+	}
+
+	const cv::Point *P = pts;
+	auto avant = [P](int i, int j) {
+		return P[i].x < P[j].x || (P[i].x == P[j].x && P[i].y < P[j].y);
+	};
+
+	int *trie = tries[niveau].data();
+	if (hi - lo <= APPROX_FEUILLE)
+	{
+		for (int i = lo; i < hi; i++) trie[i] = i;
+		sort(trie + lo, trie + hi, avant);
+	}
+	else
+	{
+		int mi = (lo + hi) / 2;
+		construire(2*k, niveau+1, lo, mi);
+		construire(2*k+1, niveau+1, mi, hi);
+		const int *fils = tries[niveau+1].data();
+		merge(fils + lo, fils + mi, fils + mi, fils + hi, trie + lo, avant);
+	}
+
+	// Enveloppe basse (y min, tourne à gauche), puis haute (y max,
+	// tourne à droite), de gauche à droite toutes les deux
+	Noeud &nd = noeuds[k];
+	for (int sens = 0; sens < 2; sens++)
+	{
+		int debut = sommets.size();
+		for (int i = lo; i < hi; i++)
+		{
+			int q = trie[i];
+			while ((int) sommets.size() - debut >= 2)
+			{
+				int64_t pv = produit_vectoriel(P[sommets[sommets.size()-2]],
+					P[sommets.back()], P[q]);
+				if ((sens == 0 && pv > 0) || (sens == 1 && pv < 0)) break;
+				sommets.pop_back();
+			}
+			if ((int) sommets.size() > debut && P[sommets.back()] == P[q]) continue;
+			sommets.push_back(q);
+		}
+		if (sens == 0) { nd.bas = debut; nd.nb_bas = sommets.size() - debut; }
+		else { nd.haut = debut; nd.nb_haut = sommets.size() - debut; }
+	}
+}
+
+/*--------------------------------------------------------------
+ * Sommet de sommets[@debut .. @debut+@nb-1] (une enveloppe
+ * triée en x) qui maximise a x + b y. Le long de l'enveloppe
+ * qui fait face à (a, b), la fonction croît puis décroît : on
+ * cherche par dichotomie la première arête où elle ne croît
+ * plus.
+ * ------------------------------------------------------------*/
+int ApproxPolygonale::extreme_enveloppe(int debut, int nb, int64_t a, int64_t b)
+{
+	const int *s = &sommets[debut];
+	int g = 0, d = nb - 1;
+	while (g < d)
+	{
+		int m = (g + d) / 2;
+		int64_t pente = a * (pts[s[m+1]].x - pts[s[m]].x) + b * (pts[s[m+1]].y - pts[s[m]].y);
+		if (pente > 0) g = m + 1;
+		else d = m;
+	}
+	return s[g];
+}
+
+/*--------------------------------------------------------------
+ * Maximum de a x + b y sur les indices [@l, @r] : les noeuds
+ * entièrement couverts répondent avec leur enveloppe, les
+ * feuilles partiellement couvertes sont balayées.
+ * ------------------------------------------------------------*/
+void ApproxPolygonale::chercher_extreme(int k, int niveau, int lo, int hi, int l, int r,
+	int64_t a, int64_t b, int64_t &meilleur, int &i_meilleur)
+{
+	if (r < lo || l >= hi) return;
+
+	if (l <= lo && hi - 1 <= r)
+	{
+		// b = 0 : point le plus à droite ou à gauche, extrémités
+		// des enveloppes (une arête verticale fausserait la dichotomie)
+		const Noeud &nd = noeuds[k];
+		int q;
+		if (b > 0)		q = extreme_enveloppe(nd.haut, nd.nb_haut, a, b);
+		else if (b < 0)	q = extreme_enveloppe(nd.bas, nd.nb_bas, a, b);
+		else			q = (a > 0) ? sommets[nd.haut + nd.nb_haut - 1] : sommets[nd.haut];
+		int64_t f = a * pts[q].x + b * pts[q].y;
+		if (f > meilleur) { meilleur = f; i_meilleur = q; }
+		return;
+	}
+
+	if (hi - lo <= APPROX_FEUILLE)
+	{
+		for (int i = max(l, lo); i <= min(r, hi - 1); i++)
+		{
+			int64_t f = a * pts[i].x + b * pts[i].y;
+			if (f > meilleur) { meilleur = f; i_meilleur = i; }
+		}
+		return;
+	}
+
+	int mi = (lo + hi) / 2;
+	chercher_extreme(2*k, niveau+1, lo, mi, l, r, a, b, meilleur, i_meilleur);
+	chercher_extreme(2*k+1, niveau+1, mi, hi, l, r, a, b, meilleur, i_meilleur);
+}
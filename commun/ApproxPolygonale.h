@@ -0,0 +1,88 @@
+#ifndef APPROX_POLYGONALE_H
+#define APPROX_POLYGONALE_H
+
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Approximation polygonale de Douglas-Peucker d'une suite de
+ * points pts[0 .. n-1] (par exemple un contour décodé par
+ * ContoursF8) : flag[i] = 1 si pts[i] est un sommet retenu.
+ *
+ * Les morceaux restant à couper sont des intervalles d'indices
+ * [debut, fin] du même tableau, rangés dans une pile explicite :
+ * ni copie de points, ni récursion. Un morceau est coupé au
+ * point P le plus loin de la corde [A B] si
+ *     d(P, AB) > seuil  <=>  (AB ^ AP)^2 > seuil^2 |AB|^2 ;
+ * pour des coordonnées < 2^15, (AB ^ AP)^2 et |AB|^2 sont des
+ * entiers exacts sur 64 bits : ni la recherche de P ni le test
+ * ne font d'erreur d'arrondi sur la géométrie.
+ *
+ * Mode enveloppe : P maximise la forme linéaire AB ^ AP, ou son
+ * opposé, et se trouve donc sur l'enveloppe convexe du morceau.
+ * Un arbre d'intervalles garde les enveloppes haute et basse de
+ * chaque noeud (points triés par fusion des fils) ; un morceau
+ * se décompose en O(log n) noeuds où le point extrême se trouve
+ * par dichotomie. Chaque recherche coûte O(log^2 n) au lieu de
+ * O(fin - debut), soit O(n log^2 n) dans le pire cas (spirale)
+ * contre O(n^2) pour le balayage.
+ *
+ * L'objet garde pile et arbre d'un appel à l'autre : approximer
+ * des milliers de contours à la suite ne fait plus d'allocation.
+ * ------------------------------------------------------------*/
+
+const int APPROX_FEUILLE = 32;		// taille maximale d'une feuille de l'arbre
+
+class ApproxPolygonale
+{
+public:
+
+	ApproxPolygonale (bool enveloppe = false);
+	~ApproxPolygonale();
+
+	bool _enveloppe();
+	void changer_enveloppe(bool enveloppe);
+
+	// Ligne ouverte : pts[0] et pts[n-1] sont des sommets
+	void approximer_ouvert(const cv::Point *pts, int n, double seuil, vector<int> &flag);
+	// Contour fermé (pts[n-1] == pts[0]) : coupé d'abord au point
+	// le plus loin de pts[0], puis chaque moitié comme ci-dessus
+	void approximer_ferme(const cv::Point *pts, int n, double seuil, vector<int> &flag);
+
+private:
+
+	struct Morceau
+	{
+		int debut, fin;
+	};
+
+	struct Noeud
+	{
+		int haut, nb_haut;		// enveloppe haute dans sommets
+		int bas, nb_bas;		// enveloppe basse dans sommets
+	};
+
+	bool enveloppe;
+	const cv::Point *pts;
+	int n;
+	vector<Morceau> pile;
+
+	vector<vector<int> > tries;		// indices triés par (x, y), par niveau
+	vector<Noeud> noeuds;
+	vector<int> sommets;
+
+	void decouper(double seuil, vector<int> &flag);
+	int plus_loin(int debut, int fin, int64_t &num, int64_t &den);
+
+	void construire(int k, int niveau, int lo, int hi);
+	int extreme_enveloppe(int debut, int nb, int64_t a, int64_t b);
+	void chercher_extreme(int k, int niveau, int lo, int hi, int l, int r,
+		int64_t a, int64_t b, int64_t &meilleur, int &i_meilleur);
+};
+
+#endif // APPROX_POLYGONALE_H
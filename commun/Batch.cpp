@@ -0,0 +1,308 @@
+#include "Batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+/*--------------------------------------------------------------
+ * File bornée entre deux étages : ajouter() attend qu'il y ait
+ * de la place, retirer() attend un élément et rend faux quand
+ * la file est fermée et vide.
+ * ------------------------------------------------------------*/
+template <class T>
+class FileBornee
+{
+public:
+
+	FileBornee (int capacite) : capacite(capacite < 1 ? 1 : capacite), fermee(false) {}
+
+	void ajouter(T &&e)
+	{
+		unique_lock<mutex> verrou(m);
+		cv_place.wait(verrou, [&] { return (int) elements.size() < capacite; });
+		elements.push_back(move(e));
+		cv_element.notify_one();
+	}
+
+	bool retirer(T &e)
+	{
+		unique_lock<mutex> verrou(m);
+		cv_element.wait(verrou, [&] { return fermee || !elements.empty(); });
+		if (elements.empty()) return false;
+		e = move(elements.front());
+		elements.pop_front();
+		cv_place.notify_one();
+		return true;
+	}
+
+	void fermer()
+	{
+		lock_guard<mutex> verrou(m);
+		fermee = true;
+		cv_element.notify_all();
+	}
+
+private:
+
+	int capacite;
+	bool fermee;
+	deque<T> elements;
+	mutex m;
+	condition_variable cv_place, cv_element;
+};
+
+struct ImageBatch
+{
+	string chemin;
+	cv::Mat img_niv;
+};
+
+/*--------------------------------------------------------------
+ * Compte les threads encore actifs d'un étage : le dernier qui
+ * s'arrête ferme la file de l'étage suivant.
+ * ------------------------------------------------------------*/
+template <class T>
+class EtageBatch
+{
+public:
+
+	EtageBatch (int nb, FileBornee<T> &suivante) : actifs(nb), suivante(suivante) {}
+	void terminer()		{ if (--actifs == 0) suivante.fermer(); }
+
+private:
+
+	atomic<int> actifs;
+	FileBornee<T> &suivante;
+};
+
+//------------------------- E N T R E E S / S O R T I E S ---------------------
+
+static bool est_dossier(const string &chemin)
+{
+	struct stat st;
+	return stat(chemin.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+static bool est_image(const string &nom)
+{
+	static const char *extensions[] = { "png", "jpg", "jpeg", "bmp", "tif", "tiff",
+		"pgm", "ppm", "pbm", "pnm", "webp" };
+	size_t point = nom.rfind('.');
+	if (point == string::npos) return false;
+	string ext = nom.substr(point + 1);
+	for (unsigned i = 0; i < ext.size(); i++) ext[i] = tolower(ext[i]);
+	for (const char *e : extensions) if (ext == e) return true;
+	return false;
+}
+
+static void lister_dossier(const string &dossier, vector<string> &chemins)
+{
+	DIR *d = opendir(dossier.c_str());
+	if (!d) return;
+	vector<string> noms;
+	for (struct dirent *e = readdir(d); e; e = readdir(d))
+		if (e->d_name[0] != '.' && est_image(e->d_name)) noms.push_back(e->d_name);
+	closedir(d);
+	sort(noms.begin(), noms.end());
+	for (unsigned i = 0; i < noms.size(); i++) chemins.push_back(dossier + "/" + noms[i]);
+}
+
+static string nom_sortie(const string &dossier, const string &chemin, int cols, int rows)
+{
+	size_t slash = chemin.rfind('/');
+	string base = (slash == string::npos) ? chemin : chemin.substr(slash + 1);
+	size_t point = base.rfind('.');
+	if (point != string::npos && point > 0) base = base.substr(0, point);
+	return dossier + "/" + base + "." + to_string(cols) + "x" + to_string(rows) + ".raw";
+}
+
+static bool ecrire_raw(const string &nom, cv::Mat img_niv)
+{
+	ofstream f(nom.c_str(), ios::binary);
+	if (!f) return false;
+	for (int y = 0; y < img_niv.rows; y++)
+		f.write((const char *) img_niv.ptr<int>(y), img_niv.cols * sizeof(int));
+	return bool(f);
+}
+
+//----------------------------- O P E R A T I O N S ----------------------------
+
+static OperationBatch fabriquer_seuil(const string &param)
+{
+	int seuil = param.empty() ? 127 : stoi(param);
+	return [seuil](cv::Mat img_niv) {
+		for (int y = 0; y < img_niv.rows; y++)
+		{
+			int *l = img_niv.ptr<int>(y);
+			for (int x = 0; x < img_niv.cols; x++) l[x] = (l[x] > seuil) ? 255 : 0;
+		}
+	};
+}
+
+static void afficher_usage_batch(const CatalogueBatch &catalogue)
+{
+	std::cout <<
+		"Usage: prog --batch [-thr seuil] [--threads N] [-dec N] [-calc N] [-enc N]\n"
+		"                    [-file N] -o dossier -op nom[:param] ... entrée ...\n"
+		"  entrée : image, dossier d'images, ou - (chemins lus sur stdin)\n"
+		"Opérations :\n"
+		"  seuil[:s]                    pixel > s -> 255, sinon 0 (s = -thr par défaut)\n";
+	for (CatalogueBatch::const_iterator it = catalogue.begin(); it != catalogue.end(); ++it)
+	{
+		string nom = it->first + (it->second.param.empty() ? "" : ":" + it->second.param);
+		nom.resize(max<size_t>(nom.size(), 28), ' ');
+		std::cout << "  " << nom << " " << it->second.aide << "\n";
+	}
+	std::cout << std::endl;
+}
+
+//--------------------------------- B A T C H ----------------------------------
+
+int executer_batch (int argc, char **argv, const CatalogueBatch &catalogue)
+{
+	int seuil = 127, nb_dec = 2, nb_calc = 1, nb_enc = 2, taille_file = BATCH_FILE_DEFAUT;
+	string dossier;
+	vector<string> specs, entrees;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string a = argv[i];
+		bool avec_valeur = (a == "-thr" || a == "--threads" || a == "-dec" || a == "-calc"
+			|| a == "-enc" || a == "-file" || a == "-o" || a == "-op");
+		if (avec_valeur && i+1 >= argc) { afficher_usage_batch(catalogue); return 1; }
+
+		if      (a == "-thr")		seuil = atoi(argv[++i]);
+		else if (a == "--threads")	definir_nb_threads(atoi(argv[++i]));
+		else if (a == "-dec")		nb_dec = max(1, atoi(argv[++i]));
+		else if (a == "-calc")		nb_calc = max(1, atoi(argv[++i]));
+		else if (a == "-enc")		nb_enc = max(1, atoi(argv[++i]));
+		else if (a == "-file")		taille_file = max(1, atoi(argv[++i]));
+		else if (a == "-o")			dossier = argv[++i];
+		else if (a == "-op")		specs.push_back(argv[++i]);
+		else if (a == "-h" || a == "--help") { afficher_usage_batch(catalogue); return 0; }
+		else entrees.push_back(a);
+	}
+	if (dossier.empty() || entrees.empty()) { afficher_usage_batch(catalogue); return 1; }
+	if (!est_dossier(dossier)) {
+		std::cout << "Dossier de sortie '" << dossier << "' introuvable" << std::endl;
+		return 1;
+	}
+
+	// Chaîne d'opérations, fabriquée une fois pour toutes les images
+	vector<OperationBatch> chaine;
+	bool a_seuil = false;
+	for (unsigned i = 0; i < specs.size(); i++)
+	{
+		size_t deux_points = specs[i].find(':');
+		string nom = specs[i].substr(0, deux_points);
+		string param = (deux_points == string::npos) ? "" : specs[i].substr(deux_points + 1);
+		try {
+			if (nom == "seuil") {
+				chaine.push_back(fabriquer_seuil(param.empty() ? to_string(seuil) : param));
+				a_seuil = true;
+				continue;
+			}
+			CatalogueBatch::const_iterator it = catalogue.find(nom);
+			if (it == catalogue.end()) throw runtime_error("opération inconnue");
+			chaine.push_back(it->second.fabriquer(param));
+		} catch (exception &e) {
+			std::cout << "Opération '" << specs[i] << "' : " << e.what() << std::endl;
+			return 1;
+		}
+	}
+	if (!a_seuil) chaine.insert(chaine.begin(), fabriquer_seuil(to_string(seuil)));
+
+	FileBornee<string> file_chemins(4 * taille_file);
+	FileBornee<ImageBatch> file_calcul(taille_file), file_ecriture(taille_file);
+	EtageBatch<ImageBatch> etage_dec(nb_dec, file_calcul), etage_calc(nb_calc, file_ecriture);
+	atomic<int> nb_images(0), nb_erreurs(0);
+	mutex m_messages;
+
+	auto signaler = [&](const string &chemin, const string &message) {
+		lock_guard<mutex> verrou(m_messages);
+		std::cerr << chemin << " : " << message << std::endl;
+		nb_erreurs++;
+	};
+
+	chrono::steady_clock::time_point debut = chrono::steady_clock::now();
+	vector<thread> threads;
+
+	// Liste des images, au fil de l'eau pour "-"
+	threads.push_back(thread([&] {
+		for (unsigned i = 0; i < entrees.size(); i++)
+		{
+			vector<string> chemins;
+			if (entrees[i] == "-") {
+				string ligne;
+				while (getline(cin, ligne))
+					if (!ligne.empty()) file_chemins.ajouter(move(ligne));
+				continue;
+			}
+			if (est_dossier(entrees[i])) lister_dossier(entrees[i], chemins);
+			else chemins.push_back(entrees[i]);
+			for (unsigned j = 0; j < chemins.size(); j++) file_chemins.ajouter(move(chemins[j]));
+		}
+		file_chemins.fermer();
+	}));
+
+	// Décodage, comme le calcul du seuil de la boucle interactive
+	for (int t = 0; t < nb_dec; t++)
+		threads.push_back(thread([&] {
+			string chemin;
+			while (file_chemins.retirer(chemin))
+			{
+				cv::Mat img_src = cv::imread (chemin, cv::IMREAD_COLOR);
+				if (img_src.empty()) { signaler(chemin, "erreur de lecture"); continue; }
+				ImageBatch im;
+				im.chemin = chemin;
+				cv::Mat img_gry;
+				cv::cvtColor (img_src, img_gry, cv::COLOR_BGR2GRAY);
+				img_gry.convertTo (im.img_niv, CV_32SC1, 1., 0.);
+				file_calcul.ajouter(move(im));
+			}
+			etage_dec.terminer();
+		}));
+
+	for (int t = 0; t < nb_calc; t++)
+		threads.push_back(thread([&] {
+			PoolThreads pool_local(1);
+			if (nb_calc > 1) definir_pool_local(&pool_local);
+			ImageBatch im;
+			while (file_calcul.retirer(im))
+			{
+				try {
+					for (unsigned i = 0; i < chaine.size(); i++) chaine[i](im.img_niv);
+				} catch (exception &e) { signaler(im.chemin, e.what()); continue; }
+				file_ecriture.ajouter(move(im));
+			}
+			definir_pool_local(NULL);
+			etage_calc.terminer();
+		}));
+
+	for (int t = 0; t < nb_enc; t++)
+		threads.push_back(thread([&] {
+			ImageBatch im;
+			while (file_ecriture.retirer(im))
+			{
+				string nom = nom_sortie(dossier, im.chemin, im.img_niv.cols, im.img_niv.rows);
+				if (!ecrire_raw(nom, im.img_niv)) { signaler(nom, "erreur d'enregistrement"); continue; }
+				nb_images++;
+			}
+		}));
+
+	for (unsigned i = 0; i < threads.size(); i++) threads[i].join();
+
+	double duree = chrono::duration<double>(chrono::steady_clock::now() - debut).count();
+	std::cout << "Batch : " << nb_images << " images écrites, " << nb_erreurs
+			  << " erreurs, " << duree << " s" << std::endl;
+	return nb_erreurs > 0 ? 1 : 0;
+}
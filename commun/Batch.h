@@ -0,0 +1,70 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <iostream>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+#include "PoolThreads.h"
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Mode --batch, sans fenêtre, commun à tous les TP :
+ *
+ *   prog --batch [-thr seuil] [--threads N] [-dec N] [-calc N]
+ *        [-enc N] [-file N] -o dossier -op nom[:param] ...
+ *        entrée ...
+ *
+ * Une entrée est une image, un dossier (toutes ses images, par
+ * ordre alphabétique) ou "-" pour lire des chemins sur l'entrée
+ * standard, une par ligne, au fil de l'eau.
+ *
+ * Trois étages de threads reliés par des files bornées (-file,
+ * en images) : décodage (imread, niveaux de gris en CV_32SC1),
+ * calcul (opérations -op dans l'ordre de la ligne de commande,
+ * sur place dans img_niv), écriture. Une file pleine bloque
+ * l'étage d'avant : la mémoire reste bornée quel que soit le
+ * nombre d'images.
+ *
+ * Avec -calc 1 (défaut), une image à la fois utilise tout le
+ * pool de threads ; avec -calc N > 1, N images sont calculées
+ * en même temps, chacune sur un seul thread.
+ *
+ * Le résultat brut (int 32 bits, ordre de la machine, ligne par
+ * ligne, sans en-tête) est écrit dans
+ *     dossier/<nom sans extension>.<cols>x<rows>.raw
+ *
+ * L'opération "seuil[:s]" (pixel > s -> 255, sinon 0) est
+ * toujours disponible ; si la chaîne n'en a pas, "seuil:<-thr>"
+ * est ajouté en tête, comme dans la boucle interactive.
+ * ------------------------------------------------------------*/
+
+const int BATCH_FILE_DEFAUT = 8;	// images en attente entre deux étages
+
+// Opération sur place sur une image CV_32SC1
+typedef function<void(cv::Mat)> OperationBatch;
+
+/*--------------------------------------------------------------
+ * Entrée du catalogue d'un TP : @fabriquer reçoit le paramètre
+ * après ':' ("" si absent), lève une exception s'il est
+ * invalide, et rend l'opération prête à l'emploi, partagée par
+ * les threads de calcul.
+ * ------------------------------------------------------------*/
+struct OperationCatalogue
+{
+	string param;		// syntaxe du paramètre, pour l'aide
+	string aide;
+	function<OperationBatch(const string &param)> fabriquer;
+};
+
+typedef map<string, OperationCatalogue> CatalogueBatch;
+
+// argv[0] est "--batch" ; rend le code de sortie du programme
+int executer_batch (int argc, char **argv, const CatalogueBatch &catalogue);
+
+#endif // BATCH_H
@@ -0,0 +1,699 @@
+#include "Chanfrein.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+//-------------------------- C H A N F R E I N ---------------------------------
+
+/*--------------------------------------------------------------
+ * Pondération du demi-masque arrière, ramenée à dy > 0 ou
+ * (dy == 0 et dx > 0) : le passage avant lit alors les pixels
+ * (y-dy, x-dx), déjà calculés en ordre de balayage.
+ * ------------------------------------------------------------*/
+struct PondCanon
+{
+	int dy, dx, w;
+	bool operator< (const PondCanon &p) const
+	{
+		if (dy != p.dy) return dy < p.dy;
+		if (dx != p.dx) return dx < p.dx;
+		return w < p.w;
+	}
+	bool operator== (const PondCanon &p) const
+	{
+		return dy == p.dy && dx == p.dx && w == p.w;
+	}
+};
+
+/*--------------------------------------------------------------
+ * Un demi-masque et son symétrique forment le masque complet :
+ * on remplace chaque pondération qui n'est pas du côté arrière
+ * par sa symétrique.
+ * ------------------------------------------------------------*/
+static vector<PondCanon> canoniser (const DemiMasque &dm)
+{
+	vector<PondCanon> ponds;
+	for (unsigned i = 0; i < dm.list_pond.size(); i++)
+	{
+		PondCanon p = { dm.list_pond[i].y, dm.list_pond[i].x, dm.list_pond[i].w };
+		if (p.dy < 0 || (p.dy == 0 && p.dx < 0)) { p.dy = -p.dy; p.dx = -p.dx; }
+		if (p.dy == 0 && p.dx == 0) continue;
+		ponds.push_back(p);
+	}
+	sort(ponds.begin(), ponds.end());
+	return ponds;
+}
+
+static vector<PondCanon> masque_standard (int a, int b, int c)
+{
+	vector<PondCanon> ponds;
+	PondCanon pa1 = {0, 1, a}, pa2 = {1, 0, a};
+	ponds.push_back(pa1); ponds.push_back(pa2);
+	if (b) {
+		PondCanon pb1 = {1, -1, b}, pb2 = {1, 1, b};
+		ponds.push_back(pb1); ponds.push_back(pb2);
+	}
+	if (c) {
+		PondCanon pc1 = {1, -2, c}, pc2 = {1, 2, c}, pc3 = {2, -1, c}, pc4 = {2, 1, c};
+		ponds.push_back(pc1); ponds.push_back(pc2);
+		ponds.push_back(pc3); ponds.push_back(pc4);
+	}
+	sort(ponds.begin(), ponds.end());
+	return ponds;
+}
+
+static int portee_masque (const vector<PondCanon> &ponds)
+{
+	int portee = 1;
+	for (unsigned i = 0; i < ponds.size(); i++)
+		portee = max(portee, max(abs(ponds[i].dy), abs(ponds[i].dx)));
+	return portee;
+}
+
+/*--------------------------------------------------------------
+ * Demi-masque canonique, masque complet (demi-masque et son
+ * symétrique) et portée, calculés une fois par DemiMasque.
+ * ------------------------------------------------------------*/
+struct LutChanfrein;
+
+struct MasqueChanfrein
+{
+	vector<PondCanon> demi, complet;
+	int portee;
+	int noyau;		// masque standard (0 à 4) ou -1
+
+	// LUT de l'axe médian, agrandie à la demande (voir lut_chanfrein)
+	mutable shared_ptr<const LutChanfrein> lut;
+	mutable mutex verrou_lut;
+};
+
+static const MasqueChanfrein &masque_chanfrein (const DemiMasque &dm)
+{
+	static map<vector<PondCanon>, MasqueChanfrein> cache;
+	static mutex verrou;
+
+	vector<PondCanon> demi = canoniser(dm);
+	lock_guard<mutex> garde(verrou);
+	map<vector<PondCanon>, MasqueChanfrein>::iterator it = cache.find(demi);
+	if (it != cache.end()) return it->second;
+
+	MasqueChanfrein &m = cache[demi];
+	m.demi = demi;
+	m.portee = portee_masque(demi);
+	m.noyau = -1;
+	const int standards[5][3] = { {1, 0, 0}, {1, 1, 0}, {2, 3, 0}, {3, 4, 0}, {5, 7, 11} };
+	for (int k = 0; k < 5; k++)
+		if (demi == masque_standard(standards[k][0], standards[k][1], standards[k][2]))
+			m.noyau = k;
+	for (unsigned i = 0; i < demi.size(); i++)
+	{
+		PondCanon sym = { -demi[i].dy, -demi[i].dx, demi[i].w };
+		m.complet.push_back(demi[i]);
+		m.complet.push_back(sym);
+	}
+	return m;
+}
+
+/*--------------------------------------------------------------
+ * Image recopiée avec @bord pixels de marge de chaque côté.
+ * ligne(y)[x] est le pixel (x, y), pour -bord <= x < cols+bord.
+ * ------------------------------------------------------------*/
+struct ImageBordee
+{
+	int rows, cols, bord, pas;
+	vector<int> data;
+
+	ImageBordee (int rows, int cols, int bord, int val_bord) :
+		rows(rows), cols(cols), bord(bord), pas(cols + 2*bord),
+		data((rows + 2*bord) * (cols + 2*bord), val_bord) {}
+
+	int *ligne (int y) { return &data[(y + bord) * pas + bord]; }
+};
+
+// DT : min(v, voisin + w), bord infini
+struct OpDT
+{
+	static int bord() { return CHANFREIN_INFINI; }
+	static int comb(int v, int n, int w) { return n + w < v ? n + w : v; }
+};
+
+// RDT : max(v, voisin - w), bord à 0
+struct OpRDT
+{
+	static int bord() { return 0; }
+	static int comb(int v, int n, int w) { return n - w > v ? n - w : v; }
+};
+
+/*--------------------------------------------------------------
+ * Noyau déroulé pour les masques standards : pondérations
+ * a = (0,1) (1,0), b = (1,±1) si B, c = (1,±2) (2,±1) si C.
+ * ------------------------------------------------------------*/
+template <class Op, int A, int B, int C>
+struct NoyauFixe
+{
+	static void avant (ImageBordee &im, int y, int x0, int x1)
+	{
+		int *r = im.ligne(y);
+		const int *h1 = im.ligne(y-1);
+		const int *h2 = C ? im.ligne(y-2) : h1;
+
+		// lignes précédentes : pas de dépendance entre les x
+		for (int x = x0; x < x1; x++)
+		{
+			int v = Op::comb(r[x], h1[x], A);
+			if (B) { v = Op::comb(v, h1[x-1], B); v = Op::comb(v, h1[x+1], B); }
+			if (C) {
+				v = Op::comb(v, h1[x-2], C); v = Op::comb(v, h1[x+2], C);
+				v = Op::comb(v, h2[x-1], C); v = Op::comb(v, h2[x+1], C);
+			}
+			r[x] = v;
+		}
+		// ligne courante
+		for (int x = x0; x < x1; x++)
+			r[x] = Op::comb(r[x], r[x-1], A);
+	}
+
+	static void arriere (ImageBordee &im, int y, int x0, int x1)
+	{
+		int *r = im.ligne(y);
+		const int *b1 = im.ligne(y+1);
+		const int *b2 = C ? im.ligne(y+2) : b1;
+
+		for (int x = x0; x < x1; x++)
+		{
+			int v = Op::comb(r[x], b1[x], A);
+			if (B) { v = Op::comb(v, b1[x-1], B); v = Op::comb(v, b1[x+1], B); }
+			if (C) {
+				v = Op::comb(v, b1[x-2], C); v = Op::comb(v, b1[x+2], C);
+				v = Op::comb(v, b2[x-1], C); v = Op::comb(v, b2[x+1], C);
+			}
+			r[x] = v;
+		}
+		for (int x = x1-1; x >= x0; x--)
+			r[x] = Op::comb(r[x], r[x+1], A);
+	}
+};
+
+/*--------------------------------------------------------------
+ * Noyau pour un demi-masque quelconque : les pondérations sont
+ * rangées en décalages dans le tampon bordé.
+ * ------------------------------------------------------------*/
+template <class Op>
+struct NoyauGenerique
+{
+	vector<int> decal_lignes, w_lignes;		// dy > 0
+	vector<int> decal_courante, w_courante;	// dy == 0
+
+	NoyauGenerique (const vector<PondCanon> &ponds, int pas)
+	{
+		for (unsigned i = 0; i < ponds.size(); i++)
+		{
+			if (ponds[i].dy > 0) {
+				decal_lignes.push_back(ponds[i].dy * pas + ponds[i].dx);
+				w_lignes.push_back(ponds[i].w);
+			} else {
+				decal_courante.push_back(ponds[i].dx);
+				w_courante.push_back(ponds[i].w);
+			}
+		}
+	}
+
+	// @sens = -1 pour le passage avant, +1 pour le passage arrière
+	void balayer_ligne (ImageBordee &im, int y, int x0, int x1, int sens)
+	{
+		int *r = im.ligne(y);
+		int nl = decal_lignes.size(), nc = decal_courante.size();
+
+		for (int x = x0; x < x1; x++)
+		{
+			int v = r[x];
+			for (int k = 0; k < nl; k++)
+				v = Op::comb(v, r[x + sens * decal_lignes[k]], w_lignes[k]);
+			r[x] = v;
+		}
+		if (sens < 0) {
+			for (int x = x0; x < x1; x++)
+				for (int k = 0; k < nc; k++)
+					r[x] = Op::comb(r[x], r[x - decal_courante[k]], w_courante[k]);
+		} else {
+			for (int x = x1-1; x >= x0; x--)
+				for (int k = 0; k < nc; k++)
+					r[x] = Op::comb(r[x], r[x + decal_courante[k]], w_courante[k]);
+		}
+	}
+
+	void avant   (ImageBordee &im, int y, int x0, int x1) { balayer_ligne(im, y, x0, x1, -1); }
+	void arriere (ImageBordee &im, int y, int x0, int x1) { balayer_ligne(im, y, x0, x1,  1); }
+};
+
+// Adaptateur pour appeler un NoyauFixe (fonctions statiques) comme un objet
+template <class Fixe>
+struct NoyauStatique
+{
+	void avant   (ImageBordee &im, int y, int x0, int x1) { Fixe::avant(im, y, x0, x1); }
+	void arriere (ImageBordee &im, int y, int x0, int x1) { Fixe::arriere(im, y, x0, x1); }
+};
+
+/*--------------------------------------------------------------
+ * Passages avant puis arrière en front d'onde : fait[y] compte
+ * les tuiles terminées de la ligne y. La tuile j de la ligne y
+ * attend que la ligne précédente (dans le sens du balayage)
+ * ait terminé la tuile j+1, qui contient les voisins de droite.
+ * Les lignes sont distribuées une par une dans l'ordre, un
+ * thread n'attend donc jamais une ligne restée dans sa file.
+ *
+ * crochets.entree(y, x0, x1) remplit une tuile juste avant son
+ * passage avant, crochets.sortie(y, x0, x1) la relit juste
+ * après son passage arrière, quand ses valeurs sont finales :
+ * la recopie depuis et vers img_niv ne coûte pas de passe.
+ *
+ * @passes choisit les passages, @nb_lignes (< 0 : toutes) limite
+ * le balayage aux premières lignes du tampon (BandeChanfrein).
+ * ------------------------------------------------------------*/
+enum PassesChanfrein { PASSE_AVANT = 1, PASSE_ARRIERE = 2, PASSES_DT = 3 };
+
+template <class Noyau, class Crochets>
+static void balayer_front_onde (ImageBordee &im, Noyau &noyau, Crochets &crochets, int portee,
+	int passes = PASSES_DT, int nb_lignes = -1)
+{
+	int largeur_tuile = max(CHANFREIN_TUILE, portee);
+	int nb_tuiles = (im.cols + largeur_tuile - 1) / largeur_tuile;
+	int rows = nb_lignes < 0 ? im.rows : nb_lignes;
+	vector<atomic<int> > fait(rows);
+	PoolThreads &pool = pool_threads();
+
+	for (int passe = 0; passe < 2; passe++)
+	{
+		bool avant = (passe == 0);
+		if (!(passes & (avant ? PASSE_AVANT : PASSE_ARRIERE))) continue;
+		for (int y = 0; y < rows; y++) fait[y].store(0);
+
+		pool.parallel_for(0, rows, 1, [&](int debut, int fin, int num) {
+			for (int k = debut; k < fin; k++)
+			{
+				int y = avant ? k : rows-1 - k;
+				int prec = avant ? y-1 : y+1;
+				for (int t = 0; t < nb_tuiles; t++)
+				{
+					if (k > 0) {
+						int attendu = min(t + 2, nb_tuiles);
+						while (fait[prec].load(memory_order_acquire) < attendu)
+							this_thread::yield();
+					}
+					int j = avant ? t : nb_tuiles-1 - t;
+					int x0 = j * largeur_tuile;
+					int x1 = min(im.cols, x0 + largeur_tuile);
+					if (avant) {
+						crochets.entree(y, x0, x1);
+						noyau.avant(im, y, x0, x1);
+					} else {
+						noyau.arriere(im, y, x0, x1);
+						crochets.sortie(y, x0, x1);
+					}
+					fait[y].store(t + 1, memory_order_release);
+				}
+			}
+		});
+	}
+}
+
+/*--------------------------------------------------------------
+ * Choisit le noyau déroulé si le demi-masque est standard,
+ * le noyau générique sinon.
+ * ------------------------------------------------------------*/
+template <class Op, class Crochets>
+static void calculer_chanfrein (ImageBordee &im, const MasqueChanfrein &m, Crochets &crochets,
+	int passes = PASSES_DT, int nb_lignes = -1)
+{
+	int p = m.portee;
+	switch (m.noyau) {
+		case 0 : { NoyauStatique<NoyauFixe<Op, 1, 0, 0> > n;  balayer_front_onde(im, n, crochets, p, passes, nb_lignes); break; }
+		case 1 : { NoyauStatique<NoyauFixe<Op, 1, 1, 0> > n;  balayer_front_onde(im, n, crochets, p, passes, nb_lignes); break; }
+		case 2 : { NoyauStatique<NoyauFixe<Op, 2, 3, 0> > n;  balayer_front_onde(im, n, crochets, p, passes, nb_lignes); break; }
+		case 3 : { NoyauStatique<NoyauFixe<Op, 3, 4, 0> > n;  balayer_front_onde(im, n, crochets, p, passes, nb_lignes); break; }
+		case 4 : { NoyauStatique<NoyauFixe<Op, 5, 7, 11> > n; balayer_front_onde(im, n, crochets, p, passes, nb_lignes); break; }
+		default : { NoyauGenerique<Op> n(m.demi, im.pas);     balayer_front_onde(im, n, crochets, p, passes, nb_lignes); }
+	}
+}
+
+// Entrée de la DT : fond à 0, forme à l'infini. Sans @recopier,
+// la DT reste dans le tampon.
+struct CrochetsDT
+{
+	cv::Mat img_niv; ImageBordee &im; bool recopier;
+	CrochetsDT (cv::Mat img_niv, ImageBordee &im, bool recopier) :
+		img_niv(img_niv), im(im), recopier(recopier) {}
+
+	void entree (int y, int x0, int x1)
+	{
+		const int *src = img_niv.ptr<int>(y);
+		int *dst = im.ligne(y);
+		for (int x = x0; x < x1; x++)
+			dst[x] = src[x] == 0 ? 0 : CHANFREIN_INFINI;
+	}
+	void sortie (int y, int x0, int x1)
+	{
+		if (recopier)
+			memcpy(img_niv.ptr<int>(y) + x0, im.ligne(y) + x0, (x1 - x0) * sizeof(int));
+	}
+};
+
+// Entrée de la RDT : valeurs telles quelles
+struct CrochetsRDT
+{
+	cv::Mat img_niv; ImageBordee &im;
+	CrochetsRDT (cv::Mat img_niv, ImageBordee &im) : img_niv(img_niv), im(im) {}
+
+	void entree (int y, int x0, int x1)
+	{
+		memcpy(im.ligne(y) + x0, img_niv.ptr<int>(y) + x0, (x1 - x0) * sizeof(int));
+	}
+	void sortie (int y, int x0, int x1)
+	{
+		memcpy(img_niv.ptr<int>(y) + x0, im.ligne(y) + x0, (x1 - x0) * sizeof(int));
+	}
+};
+
+/*--------------------------------------------------------------
+ * DT : le fond (0) reste à 0, chaque pixel de la forme reçoit
+ * sa distance de chanfrein au fond le plus proche dans l'image.
+ * ------------------------------------------------------------*/
+void calculer_dt_chanfrein (cv::Mat img_niv, const DemiMasque &dm)
+{
+	const MasqueChanfrein &m = masque_chanfrein(dm);
+	ImageBordee im(img_niv.rows, img_niv.cols, m.portee, OpDT::bord());
+	CrochetsDT crochets(img_niv, im, true);
+	calculer_chanfrein<OpDT>(im, m, crochets);
+}
+
+/*--------------------------------------------------------------
+ * RDT : chaque pixel reçoit le max des (valeur - poids) sur
+ * les chemins venant des pixels non nuls ; la forme
+ * reconstruite est l'ensemble des pixels > 0.
+ * ------------------------------------------------------------*/
+void calculer_rdt_chanfrein (cv::Mat img_niv, const DemiMasque &dm)
+{
+	const MasqueChanfrein &m = masque_chanfrein(dm);
+	ImageBordee im(img_niv.rows, img_niv.cols, m.portee, OpRDT::bord());
+	CrochetsRDT crochets(img_niv, im);
+	calculer_chanfrein<OpRDT>(im, m, crochets);
+}
+
+// Ni entrée ni sortie : le tampon est rempli à la main
+struct SansCrochets
+{
+	void entree (int, int, int) {}
+	void sortie (int, int, int) {}
+};
+
+//---------------- C L A S S E     B A N D E C H A N F R E I N -----------------
+
+struct BandeChanfrein::Etat
+{
+	const MasqueChanfrein &m;
+	ImageBordee im;
+	Etat (const MasqueChanfrein &m, int cols, int hauteur) :
+		m(m), im(hauteur, cols, m.portee, OpDT::bord()) {}
+};
+
+BandeChanfrein::BandeChanfrein (const DemiMasque &dm, int cols, int hauteur)
+{
+	const MasqueChanfrein &m = masque_chanfrein(dm);
+	etat = new Etat(m, cols, hauteur);
+}
+
+BandeChanfrein::~BandeChanfrein()
+{
+	delete etat;
+}
+
+int BandeChanfrein::_portee() const {	return etat->m.portee;	}
+int BandeChanfrein::_hauteur() const {	return etat->im.rows;	}
+
+int *BandeChanfrein::ligne (int y) {	return etat->im.ligne(y);	}
+
+void BandeChanfrein::passe_avant (int nb_lignes)
+{
+	SansCrochets rien;
+	calculer_chanfrein<OpDT>(etat->im, etat->m, rien, PASSE_AVANT, nb_lignes);
+}
+
+void BandeChanfrein::passe_arriere (int nb_lignes)
+{
+	SansCrochets rien;
+	calculer_chanfrein<OpDT>(etat->im, etat->m, rien, PASSE_ARRIERE, nb_lignes);
+}
+
+/*--------------------------------------------------------------
+ * LUT de Rémy-Thiel : val[k][r] est le plus petit rayon R tel
+ * que la boule B(O, r) = { x : d(O,x) < r } soit incluse dans
+ * B(v_k, R), où v_k est la pondération k du masque complet.
+ * Un point p de la DT n'est pas centre de boule maximale s'il
+ * existe k tel que DT[p + v_k] >= val[k][DT[p]].
+ * ------------------------------------------------------------*/
+struct LutChanfrein
+{
+	int rmax;
+	vector<vector<int> > val;
+};
+
+/*--------------------------------------------------------------
+ * Calcule la LUT jusqu'au rayon @rmax : d(O,.) est une DT de
+ * chanfrein depuis le centre d'une fenêtre assez grande pour
+ * contenir B(O, rmax) et ses translatées par le masque, puis
+ * val[k][r] = 1 + max { d(v_k, x) : d(O,x) < r }.
+ * ------------------------------------------------------------*/
+static LutChanfrein *calculer_lut (const MasqueChanfrein &m, int rmax)
+{
+	// d(O,x) >= pente * |x|inf
+	double pente = 1e9;
+	for (unsigned k = 0; k < m.demi.size(); k++)
+		pente = min(pente, double(m.demi[k].w) / max(abs(m.demi[k].dy), abs(m.demi[k].dx)));
+	int l = int(rmax / pente) + 1;
+	int h = l + 2 * m.portee, n = 2*h + 1;
+
+	ImageBordee im(n, n, m.portee, OpDT::bord());
+	im.ligne(h)[h] = 0;
+	SansCrochets rien;
+	calculer_chanfrein<OpDT>(im, m, rien);
+
+	LutChanfrein *lut = new LutChanfrein;
+	lut->rmax = rmax;
+	lut->val.assign(m.complet.size(), vector<int>(rmax + 1, 0));
+	vector<int> plus_loin(rmax);
+
+	for (unsigned k = 0; k < m.complet.size(); k++)
+	{
+		int dy = m.complet[k].dy, dx = m.complet[k].dx;
+		fill(plus_loin.begin(), plus_loin.end(), -1);
+		for (int y = h - l; y <= h + l; y++)
+		{
+			const int *r = im.ligne(y), *rv = im.ligne(y - dy);
+			for (int x = h - l; x <= h + l; x++)
+				if (r[x] < rmax && rv[x - dx] > plus_loin[r[x]])
+					plus_loin[r[x]] = rv[x - dx];
+		}
+		vector<int> &val = lut->val[k];
+		int cumul = -1;
+		for (int r = 1; r <= rmax; r++)
+		{
+			cumul = max(cumul, plus_loin[r-1]);
+			val[r] = cumul + 1;
+		}
+	}
+	return lut;
+}
+
+/*--------------------------------------------------------------
+ * LUT de @m couvrant au moins le rayon @rmax. Elle est gardée
+ * avec le masque et recalculée au double de sa taille quand une
+ * DT dépasse son rayon : les appels suivants ne coûtent rien.
+ * ------------------------------------------------------------*/
+static shared_ptr<const LutChanfrein> lut_chanfrein (const MasqueChanfrein &m, int rmax)
+{
+	lock_guard<mutex> garde(m.verrou_lut);
+	if (!m.lut || m.lut->rmax < rmax)
+	{
+		int taille = m.lut ? max(rmax, 2 * m.lut->rmax) : max(rmax, CHANFREIN_LUT_RMAX);
+		m.lut.reset(calculer_lut(m, taille));
+	}
+	return m.lut;
+}
+
+static int max_interieur (ImageBordee &im)
+{
+	int rmax = 0;
+	for (int y = 0; y < im.rows; y++)
+	{
+		const int *r = im.ligne(y);
+		for (int x = 0; x < im.cols; x++) rmax = max(rmax, r[x]);
+	}
+	return rmax;
+}
+
+/*--------------------------------------------------------------
+ * Maximums locaux de la DT contenue dans @im, pour les lignes
+ * [y_debut, y_fin[ : (x,y) est maximum local si pour toute
+ * pondération (dx,dy,w) du masque complet,
+ *     DT[x,y] > DT[x+dx,y+dy] - w.
+ * Avec une @lut, le critère devient celui des centres de
+ * boules maximales : DT[x+dx,y+dy] < lut[k][DT[x,y]].
+ * Le bord de @im doit être à 0, pour ne pas compter. Écrit dans
+ * img_niv la DT des maximums, @non_max pour les autres points
+ * de la forme et 0 pour le fond.
+ * ------------------------------------------------------------*/
+static void marquer_maximums_locaux (ImageBordee &im, cv::Mat img_niv,
+	const MasqueChanfrein &m, const LutChanfrein *lut,
+	int y_debut, int y_fin, int filtre, int non_max)
+{
+	int n = m.complet.size();
+	vector<int> decal(n), w(n);
+	for (int k = 0; k < n; k++) {
+		decal[k] = m.complet[k].dy * im.pas + m.complet[k].dx;
+		w[k] = m.complet[k].w;
+	}
+
+	for (int y = y_debut; y < y_fin; y++)
+	{
+		const int *r = im.ligne(y);
+		int *dst = img_niv.ptr<int>(y);
+		for (int x = 0; x < im.cols; x++)
+		{
+			int v = r[x];
+			if (v == 0) { dst[x] = 0; continue; }
+			bool maximum = true;
+			if (lut) {
+				for (int k = 0; k < n && maximum; k++)
+					if (r[x + decal[k]] >= lut->val[k][v]) maximum = false;
+			} else {
+				for (int k = 0; k < n && maximum; k++)
+					if (r[x + decal[k]] - w[k] >= v) maximum = false;
+			}
+			dst[x] = (maximum && v > filtre) ? v : non_max;
+		}
+	}
+}
+
+// LUT si @axe_exact et si la DT a bien un fond, nullptr sinon
+static shared_ptr<const LutChanfrein> lut_si_besoin (const MasqueChanfrein &m,
+	ImageBordee &im, bool axe_exact)
+{
+	if (!axe_exact) return nullptr;
+	int rmax = max_interieur(im);
+	if (rmax >= CHANFREIN_INFINI) return nullptr;
+	return lut_chanfrein(m, rmax);
+}
+
+/*--------------------------------------------------------------
+ * img_niv contient une DT : met à 0 tous les points qui ne sont
+ * pas maximums locaux, ou avec @axe_exact tous ceux qui ne sont
+ * pas centres de boules maximales (axe médian par LUT).
+ * ------------------------------------------------------------*/
+void detecter_maximums_locaux_chanfrein (cv::Mat img_niv, const DemiMasque &dm, bool axe_exact)
+{
+	const MasqueChanfrein &m = masque_chanfrein(dm);
+	ImageBordee im(img_niv.rows, img_niv.cols, m.portee, 0);
+	for (int y = 0; y < img_niv.rows; y++)
+		memcpy(im.ligne(y), img_niv.ptr<int>(y), img_niv.cols * sizeof(int));
+	shared_ptr<const LutChanfrein> lut = lut_si_besoin(m, im, axe_exact);
+
+	pool_threads().parallel_for(0, img_niv.rows, CHANFREIN_GRAIN,
+		[&](int debut, int fin, int num) {
+			marquer_maximums_locaux(im, img_niv, m, lut.get(), debut, fin, 0, 0);
+		});
+}
+
+/*--------------------------------------------------------------
+ * Pendant la RDT du filtrage, img_niv contient les maximums
+ * gardés (> 0), les autres points de la forme (-1) et le fond
+ * (0) ; le tampon contient la RDT. La sortie colorie la tuile.
+ * ------------------------------------------------------------*/
+struct CrochetsFiltrage
+{
+	cv::Mat img_niv; ImageBordee &im;
+	CrochetsFiltrage (cv::Mat img_niv, ImageBordee &im) : img_niv(img_niv), im(im) {}
+
+	void entree (int y, int x0, int x1)
+	{
+		const int *src = img_niv.ptr<int>(y);
+		int *dst = im.ligne(y);
+		for (int x = x0; x < x1; x++)
+			dst[x] = src[x] > 0 ? src[x] : 0;
+	}
+	void sortie (int y, int x0, int x1)
+	{
+		int *dst = img_niv.ptr<int>(y);
+		const int *rdt = im.ligne(y);
+		for (int x = x0; x < x1; x++)
+		{
+			if (dst[x] > 0)			dst[x] = CHANFREIN_COUL_MAX;
+			else if (rdt[x] > 0)	dst[x] = CHANFREIN_COUL_RDT;
+			else if (dst[x] < 0)	dst[x] = CHANFREIN_COUL_PERDU;
+		}
+	}
+};
+
+/*--------------------------------------------------------------
+ * @im contient une DT : maximums locaux > @filtre écrits dans
+ * img_niv, puis RDT relisant img_niv tuile par tuile dans le
+ * même tampon, qui colorie le résultat dès qu'une tuile est
+ * finale.
+ * ------------------------------------------------------------*/
+static void filtrer_depuis_tampon (ImageBordee &im, cv::Mat img_niv,
+	const MasqueChanfrein &m, int filtre, bool axe_exact)
+{
+	shared_ptr<const LutChanfrein> lut = lut_si_besoin(m, im, axe_exact);
+
+	// bord à 0 pour les maximums et la RDT ; l'intérieur de la RDT
+	// est rempli par entree()
+	for (int y = -m.portee; y < img_niv.rows + m.portee; y++)
+	{
+		int *l = im.ligne(y);
+		if (y < 0 || y >= img_niv.rows)
+			fill(l - m.portee, l + img_niv.cols + m.portee, 0);
+		else {
+			fill(l - m.portee, l, 0);
+			fill(l + img_niv.cols, l + img_niv.cols + m.portee, 0);
+		}
+	}
+	pool_threads().parallel_for(0, img_niv.rows, CHANFREIN_GRAIN,
+		[&](int debut, int fin, int num) {
+			marquer_maximums_locaux(im, img_niv, m, lut.get(), debut, fin, filtre, -1);
+		});
+
+	CrochetsFiltrage crochets(img_niv, im);
+	calculer_chanfrein<OpRDT>(im, m, crochets);
+}
+
+/*--------------------------------------------------------------
+ * DT, maximums locaux > @filtre et RDT enchaînés avec un seul
+ * tampon : la DT reste dans le tampon pour la détection des
+ * maximums.
+ * ------------------------------------------------------------*/
+void filtrer_axe_median_chanfrein (cv::Mat img_niv, const DemiMasque &dm, int filtre,
+	bool axe_exact)
+{
+	const MasqueChanfrein &m = masque_chanfrein(dm);
+	ImageBordee im(img_niv.rows, img_niv.cols, m.portee, OpDT::bord());
+
+	CrochetsDT crochets_dt(img_niv, im, false);
+	calculer_chanfrein<OpDT>(im, m, crochets_dt);
+	filtrer_depuis_tampon(im, img_niv, m, filtre, axe_exact);
+}
+
+/*--------------------------------------------------------------
+ * Même résultat que filtrer_axe_median_chanfrein, à partir de
+ * la DT @img_dt déjà calculée (lue seulement, distincte de
+ * img_niv) : le graphe de calcul des TP garde la DT quand seul
+ * le filtre change.
+ * ------------------------------------------------------------*/
+void filtrer_axe_median_depuis_dt (cv::Mat img_niv, cv::Mat img_dt, const DemiMasque &dm,
+	int filtre, bool axe_exact)
+{
+	const MasqueChanfrein &m = masque_chanfrein(dm);
+	ImageBordee im(img_dt.rows, img_dt.cols, m.portee, 0);
+	for (int y = 0; y < img_dt.rows; y++)
+		memcpy(im.ligne(y), img_dt.ptr<int>(y), img_dt.cols * sizeof(int));
+	filtrer_depuis_tampon(im, img_niv, m, filtre, axe_exact);
+}
@@ -0,0 +1,99 @@
+#ifndef CHANFREIN_H
+#define CHANFREIN_H
+
+#include <iostream>
+#include <cstring>
+#include <opencv2/opencv.hpp>
+
+#include "DemiMasque.h"
+#include "PoolThreads.h"
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Transformations de distance de chanfrein (DT et RDT de
+ * Rosenfeld) pour n'importe quel DemiMasque.
+ *
+ * L'image (CV_32SC1) est recopiée dans un tampon bordé, de
+ * chaque côté, d'autant de pixels que la portée du masque : la
+ * boucle interne n'a plus de test de sortie d'image. Le bord
+ * est neutre, les pixels hors de l'image sont donc ignorés
+ * comme demandé dans le sujet du TP5.
+ *
+ * Pour chaque ligne, les pondérations des lignes précédentes
+ * sont appliquées d'un bloc (boucle min-plus sans dépendance,
+ * vectorisable), puis celles de la ligne courante, de gauche à
+ * droite. Les masques standards (d4, d8, 2-3, 3-4, 5-7-11)
+ * ont une version dont les pondérations sont déroulées à la
+ * compilation.
+ *
+ * En parallèle, chaque ligne est découpée en tuiles de
+ * CHANFREIN_TUILE colonnes : la tuile j de la ligne y est
+ * calculée dès que la ligne y-1 a fini la tuile j+1, ce qui
+ * fait avancer les threads en front d'onde (anti-diagonales).
+ *
+ * Le demi-masque canonique et le masque complet sont calculés
+ * une seule fois par DemiMasque et gardés en cache, ainsi que
+ * la LUT de l'axe médian exact (Rémy-Thiel), qui ne grandit que
+ * si une DT dépasse son rayon maximal.
+ * ------------------------------------------------------------*/
+
+const int CHANFREIN_INFINI = 1 << 29;	// distance d'un pixel sans fond
+const int CHANFREIN_TUILE = 256;		// largeur minimale d'une tuile
+const int CHANFREIN_GRAIN = 16;		// lignes par tâche, hors front d'onde
+const int CHANFREIN_LUT_RMAX = 1024;	// rayon minimal d'une LUT d'axe médian
+
+// Couleurs (indices VGA) du résultat de filtrer_axe_median_chanfrein
+const int CHANFREIN_COUL_MAX   = 11;	// maximums locaux > filtre (cyan)
+const int CHANFREIN_COUL_RDT   = 8;		// forme retrouvée par RDT (gris)
+const int CHANFREIN_COUL_PERDU = 12;	// forme non retrouvée (rouge)
+
+void calculer_dt_chanfrein (cv::Mat img_niv, const DemiMasque &dm);
+void calculer_rdt_chanfrein (cv::Mat img_niv, const DemiMasque &dm);
+void detecter_maximums_locaux_chanfrein (cv::Mat img_niv, const DemiMasque &dm,
+	bool axe_exact);
+void filtrer_axe_median_chanfrein (cv::Mat img_niv, const DemiMasque &dm, int filtre,
+	bool axe_exact);
+void filtrer_axe_median_depuis_dt (cv::Mat img_niv, cv::Mat img_dt, const DemiMasque &dm,
+	int filtre, bool axe_exact);
+
+/*--------------------------------------------------------------
+ * Bande de lignes pour la DT par bandes (mode --flux, voir
+ * Flux.h) : un tampon de @hauteur lignes de @cols pixels, bordé
+ * de _portee() lignes et colonnes à l'infini.
+ *
+ * passe_avant(n) fait le passage avant des lignes 0..n-1 en
+ * lisant les lignes -portee..-1, à remplir avec la fin de la
+ * bande précédente ; passe_arriere(n) fait le passage arrière
+ * des lignes n-1..0 en lisant les lignes n..n+portee-1 (début
+ * de la bande suivante, déjà finale). Enchaîner les bandes de
+ * haut en bas puis de bas en haut donne exactement
+ * calculer_dt_chanfrein().
+ * ------------------------------------------------------------*/
+class BandeChanfrein
+{
+public:
+
+	BandeChanfrein (const DemiMasque &dm, int cols, int hauteur);
+	~BandeChanfrein();
+
+	int _portee() const;
+	int _hauteur() const;
+
+	// -portee <= y < hauteur + portee, -portee <= x < cols + portee
+	int *ligne (int y);
+
+	void passe_avant (int nb_lignes);
+	void passe_arriere (int nb_lignes);
+
+private:
+
+	struct Etat;
+	Etat *etat;
+
+	BandeChanfrein (const BandeChanfrein &);
+	BandeChanfrein &operator= (const BandeChanfrein &);
+};
+
+#endif // CHANFREIN_H
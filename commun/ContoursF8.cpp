@@ -0,0 +1,71 @@
+#include "ContoursF8.h"
+
+//-------------------- C L A S S E     C O N T O U R S F 8 ---------------------
+
+ContoursF8::ContoursF8() :
+	nb_directions(0)
+{
+	;
+}
+
+ContoursF8::~ContoursF8()
+{
+	;
+}
+
+void ContoursF8::vider()
+{
+	entetes.clear();
+	bits.clear();
+	nb_directions = 0;
+}
+
+/*--------------------------------------------------------------
+ * Ouvre un nouveau contour partant de (@x, @y) ; les directions
+ * ajoutées ensuite lui appartiennent. Renvoie son numéro.
+ * ------------------------------------------------------------*/
+int ContoursF8::commencer_contour(int x, int y, int dir_fond)
+{
+	Entete e = { x, y, dir_fond, 0, nb_directions };
+	entetes.push_back(e);
+	return entetes.size() - 1;
+}
+
+void ContoursF8::ajouter_direction(int d)
+{
+	if (nb_directions % FREEMAN_PAR_MOT == 0) bits.push_back(0);
+	bits.back() |= uint64_t(d & 7) << (3 * (nb_directions % FREEMAN_PAR_MOT));
+	nb_directions++;
+	entetes.back().taille++;
+}
+
+int ContoursF8::_nb_contours() const {	return entetes.size();	}
+
+int ContoursF8::taille(int c) const {	return entetes[c].taille;	}
+
+cv::Point ContoursF8::depart(int c) const {	return cv::Point(entetes[c].x, entetes[c].y);	}
+
+int ContoursF8::dir_fond(int c) const {	return entetes[c].dir_fond;	}
+
+int ContoursF8::direction(int c, int i) const
+{
+	long rang = entetes[c].premier + i;
+	return (bits[rang / FREEMAN_PAR_MOT] >> (3 * (rang % FREEMAN_PAR_MOT))) & 7;
+}
+
+size_t ContoursF8::_octets() const
+{
+	return entetes.size() * sizeof(Entete) + bits.size() * sizeof(uint64_t);
+}
+
+ContoursF8::Iterateur ContoursF8::debut(int c) const
+{
+	const Entete &e = entetes[c];
+	return Iterateur(bits.data(), e.premier, e.x, e.y, e.taille);
+}
+
+ContoursF8::Iterateur ContoursF8::fin(int c) const
+{
+	const Entete &e = entetes[c];
+	return Iterateur(bits.data(), e.premier + e.taille, e.x, e.y, -1);
+}
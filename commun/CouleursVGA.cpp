@@ -0,0 +1,140 @@
+#include "CouleursVGA.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COULEURS_VGA_AVX2
+#include <immintrin.h>
+#endif
+
+/*--------------------------------------------------------------
+ * Indice dans la palette. |g-1| est calculé en non signé, ce
+ * qui le définit aussi pour g = INT_MIN.
+ * ------------------------------------------------------------*/
+static inline int indice_vga (int g)
+{
+	if (g == 255) return 15;						// seul 255 est blanc
+	if (g == 0) return 0;							// seul 0 est noir
+	unsigned u = g > 0 ? unsigned(g) - 1u : 1u - unsigned(g);
+	return 1 + u % 14;
+}
+
+static void colorier_ligne (const int *src, uchar *dst, int debut, int cols)
+{
+	for (int x = debut; x < cols; x++)
+	{
+		const unsigned char *c = COULEURS_VGA[indice_vga(src[x])];
+		dst[3*x]   = c[0];
+		dst[3*x+1] = c[1];
+		dst[3*x+2] = c[2];
+	}
+}
+
+#ifdef COULEURS_VGA_AVX2
+
+static bool avx2_disponible()
+{
+	static const bool ok = __builtin_cpu_supports("avx2");
+	return ok;
+}
+
+/*--------------------------------------------------------------
+ * 8 étiquettes par itération. u / 14 = (u * 0x92492493) >> 35
+ * est exact pour u < 3435973841, or u <= 2^31 + 1 ; mul_epu32
+ * ne multiplie que les voies paires, d'où deux produits.
+ *
+ * Chaque pixel devient B,G,R,0 ; le tassement ramène les 4
+ * pixels de chaque moitié sur 12 octets, écrits par deux
+ * stores de 16 octets qui se chevauchent : la boucle s'arrête
+ * donc assez tôt pour que les 4 octets de trop restent dans la
+ * ligne, et la fin de ligne passe par la boucle scalaire.
+ * ------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static void colorier_ligne_avx2 (const int *src, uchar *dst, int cols, const uint32_t *palette)
+{
+	const __m256i pal_bas  = _mm256_loadu_si256((const __m256i *) palette);
+	const __m256i pal_haut = _mm256_loadu_si256((const __m256i *) (palette + 8));
+	const __m256i zero = _mm256_setzero_si256(), un = _mm256_set1_epi32(1);
+	const __m256i sept = _mm256_set1_epi32(7), quinze = _mm256_set1_epi32(15);
+	const __m256i blanc = _mm256_set1_epi32(255);
+	const __m256i inverse14 = _mm256_set1_epi32((int) 0x92492493u);
+	const __m256i tasser = _mm256_setr_epi8(
+		0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+		0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+	int x = 0;
+	for (; x + 10 <= cols; x += 8)
+	{
+		__m256i g = _mm256_loadu_si256((const __m256i *) (src + x));
+
+		__m256i positif = _mm256_cmpgt_epi32(g, zero);
+		__m256i u = _mm256_blendv_epi8(_mm256_sub_epi32(un, g), _mm256_sub_epi32(g, un), positif);
+
+		__m256i q_pair   = _mm256_srli_epi64(_mm256_mul_epu32(u, inverse14), 35);
+		__m256i q_impair = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(u, 32), inverse14), 35);
+		__m256i q = _mm256_or_si256(q_pair, _mm256_slli_epi64(q_impair, 32));
+		__m256i q14 = _mm256_sub_epi32(_mm256_slli_epi32(q, 4), _mm256_slli_epi32(q, 1));
+
+		__m256i c = _mm256_add_epi32(un, _mm256_sub_epi32(u, q14));
+		c = _mm256_andnot_si256(_mm256_cmpeq_epi32(g, zero), c);
+		c = _mm256_blendv_epi8(c, quinze, _mm256_cmpeq_epi32(g, blanc));
+
+		__m256i coul = _mm256_blendv_epi8(
+			_mm256_permutevar8x32_epi32(pal_bas, c),
+			_mm256_permutevar8x32_epi32(pal_haut, c),
+			_mm256_cmpgt_epi32(c, sept));
+		coul = _mm256_shuffle_epi8(coul, tasser);
+
+		_mm_storeu_si128((__m128i *) (dst + 3*x), _mm256_castsi256_si128(coul));
+		_mm_storeu_si128((__m128i *) (dst + 3*x + 12), _mm256_extracti128_si256(coul, 1));
+	}
+	colorier_ligne(src, dst, x, cols);
+}
+
+__attribute__((target("avx2")))
+static void complementer_ligne_avx2 (uchar *p, int n)
+{
+	const __m256i uns = _mm256_set1_epi8(-1);
+	int i = 0;
+	for (; i + 32 <= n; i += 32)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i *) (p + i));
+		_mm256_storeu_si256((__m256i *) (p + i), _mm256_xor_si256(v, uns));
+	}
+	for (; i < n; i++) p[i] = 255 - p[i];
+}
+
+#endif // COULEURS_VGA_AVX2
+
+void colorier_vga (ConstImageView<int> img_niv, ImageView<cv::Vec3b> img_coul)
+{
+	if (img_niv._rows() != img_coul._rows() || img_niv._cols() != img_coul._cols())
+		throw runtime_error(string(__func__) + ": tailles différentes");
+	int rows = img_niv._rows(), cols = img_niv._cols();
+
+#ifdef COULEURS_VGA_AVX2
+	if (avx2_disponible())
+	{
+		uint32_t palette[16];
+		for (int c = 0; c < 16; c++)
+			palette[c] = COULEURS_VGA[c][0] | (COULEURS_VGA[c][1] << 8) | (COULEURS_VGA[c][2] << 16);
+
+		for (int y = 0; y < rows; y++)
+			colorier_ligne_avx2(img_niv.ligne(y), (uchar *) img_coul.ligne(y), cols, palette);
+		return;
+	}
+#endif
+	for (int y = 0; y < rows; y++)
+		colorier_ligne(img_niv.ligne(y), (uchar *) img_coul.ligne(y), 0, cols);
+}
+
+void complementer_couleurs (ImageView<cv::Vec3b> img)
+{
+	int n = img._cols() * 3;
+	for (int y = 0; y < img._rows(); y++)
+	{
+		uchar *p = (uchar *) img.ligne(y);
+#ifdef COULEURS_VGA_AVX2
+		if (avx2_disponible()) { complementer_ligne_avx2(p, n); continue; }
+#endif
+		for (int i = 0; i < n; i++) p[i] = 255 - p[i];
+	}
+}
@@ -0,0 +1,60 @@
+#ifndef COULEURS_VGA_H
+#define COULEURS_VGA_H
+
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+
+#include "ImageView.h"
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Conversions d'affichage des TP, vectorisées.
+ *
+ * colorier_vga : image d'étiquettes (CV_32SC1) -> CV_8UC3 avec
+ * la palette VGA de representer_en_couleurs_vga : 0 noir, 255
+ * blanc, sinon la couleur 1 + |g-1| % 14.
+ * complementer_couleurs : 255 - v sur chaque octet (CV_8UC3).
+ *
+ * Avec AVX2 (testé à l'exécution, pour le cas d'une compilation
+ * sans -march=native), colorier_vga traite 8 étiquettes par itération :
+ * le modulo 14 est une multiplication par l'inverse entier, la
+ * couleur est lue dans la palette par deux permutevar8x32 (16
+ * couleurs de 32 bits), puis les 8 pixels BGR0 sont tassés en
+ * 24 octets. Sinon, une boucle scalaire sur des pointeurs de
+ * ligne donne le même résultat.
+ *
+ * Ces fonctions ne lancent pas de threads : RenduTuiles les
+ * appelle déjà en parallèle sur des tuiles différentes. Leurs
+ * noms diffèrent de ceux des TP, car les anciennes versions des
+ * TP définissent encore representer_en_couleurs_vga.
+ * ------------------------------------------------------------*/
+
+// Palette VGA en B, G, R
+const unsigned char COULEURS_VGA[16][3] = {
+	{   0,   0,   0 },		//  0  noir            ->  0 uniquement
+	{ 190,  20,  20 },		//  1  bleu            ->  1, 15, 29, ...
+	{  30, 200,  30 },		//  2  vert            ->  2, 16, 30, ...
+	{ 200, 200,  30 },		//  3  cyan            ->  3, 17, 31, ...
+	{  30,  30, 200 },		//  4  rouge           ->  4, 18, 32, ...
+	{ 200,  30, 200 },		//  5  magenta         ->  5, 19, 33, ...
+	{  50, 130, 200 },		//  6  marron          ->  6, 20, 34, ...
+	{ 200, 200, 200 },		//  7  gris clair      ->  7, 21, 35, ...
+	{ 140, 110, 110 },		//  8  gris foncé      ->  8, 22, 36, ...
+	{ 252, 130,  84 },		//  9  bleu clair      ->  9, 23, 37, ...
+	{  84, 252,  84 },		// 10  vert clair      -> 10, 24, 38, ...
+	{ 252, 252,  84 },		// 11  cyan clair      -> 11, 25, 39, ...
+	{  84,  84, 252 },		// 12  rouge clair     -> 12, 26, 40, ...
+	{ 252,  84, 252 },		// 13  magenta clair   -> 13, 27, 41, ...
+	{  84, 252, 252 },		// 14  jaune           -> 14, 28, 42, ...
+	{ 252, 252, 252 },		// 15  blanc           -> 255 uniquement
+};
+
+void colorier_vga (ConstImageView<int> img_niv, ImageView<cv::Vec3b> img_coul);
+void complementer_couleurs (ImageView<cv::Vec3b> img);
+
+#endif // COULEURS_VGA_H
@@ -0,0 +1,94 @@
+#ifndef DEMI_MASQUE_H
+#define DEMI_MASQUE_H
+
+#include <iostream>
+#include <string>
+
+#include <vector>
+
+/*--------------------------------------------------------------
+ * Demi-masques de chanfrein des TP5 et TP6 (d4, d8, 2-3, 3-4
+ * et 5-7-11), partagés par les TP et par Chanfrein.h.
+ * ------------------------------------------------------------*/
+
+enum NumeroMasque {M_D4,M_D8,M_2_3,M_3_4,M_5_7_11,M_LAST};
+
+struct Ponderation
+{
+    int y;
+    int x;
+    int w; //poids (a, b, ...)
+    Ponderation(int y, int x, int w) {this->y=y; this->x=x; this->w=w;}
+};
+
+struct DemiMasque
+{
+    std::vector<Ponderation> list_pond;
+    unsigned int t_pond = list_pond.size();
+    NumeroMasque num_masque;
+    std::string nom_masque;
+    void pond_d8_poids(int a, int b)
+    {
+    list_pond.push_back(Ponderation(1,0,a));
+    list_pond.push_back(Ponderation(1,1,b));
+    list_pond.push_back(Ponderation(0,1,a));
+    list_pond.push_back(Ponderation(-1,1,b));
+    }
+    DemiMasque(NumeroMasque num_masque)
+    {
+        this->num_masque = num_masque;
+        list_pond.clear();
+        
+        switch (num_masque)
+        {
+        case M_D4 : 
+            //std::cout << "d4" << std::endl;
+            nom_masque="M_D4";
+            list_pond.push_back(Ponderation(1,0,1));
+            list_pond.push_back(Ponderation(0,1,1));
+            break;
+        case M_D8: 
+            //std::cout << "d8" << std::endl;
+            nom_masque="M_D8";
+            pond_d8_poids(1, 1);
+            break;
+        case M_2_3 :
+            //std::cout << "d23" << std::endl;
+            nom_masque="M_2_3";
+            pond_d8_poids(2, 3);
+            break;
+        case M_3_4 : 
+            //std::cout << "d34" << std::endl;
+            nom_masque="M_3_4";
+            pond_d8_poids(3, 4);
+            break;
+        case M_5_7_11 : 
+            //std::cout << "M_5_7_11" << std::endl;
+            nom_masque="M_5_7_11";
+            pond_d8_poids(5, 7); //poids a et b
+            // poids c
+            list_pond.push_back(Ponderation(2,1,11));
+            list_pond.push_back(Ponderation(1,2,11));
+            list_pond.push_back(Ponderation(-1,2,11));
+            list_pond.push_back(Ponderation(-2,1,11));
+            break;
+        case M_LAST:
+            //std::cout << "M_LAST" << std::endl;
+            nom_masque = "M_LAST";
+            break;
+        default:
+            break;
+        }
+    }
+};
+
+// Numéro du masque nommé @nom (d4, d8, 2-3, 3-4, 5-7-11), M_LAST si inconnu
+inline NumeroMasque numero_masque(const std::string &nom)
+{
+    const char *noms[] = {"d4", "d8", "2-3", "3-4", "5-7-11"};
+    for (int i = 0; i < M_LAST; i++)
+        if (nom == noms[i]) return NumeroMasque(i);
+    return M_LAST;
+}
+
+#endif // DEMI_MASQUE_H
@@ -0,0 +1,169 @@
+#include "Etiquetage.h"
+
+#include <algorithm>
+
+//--------------------- C L A S S E     E T I Q U E T A G E --------------------
+
+const int ETIQUETAGE_DIR_HAUT = 6;	// directions de Freeman, y vers le bas
+const int ETIQUETAGE_DIR_BAS = 2;
+
+/*--------------------------------------------------------------
+ * Racine de @p, en raccourcissant le chemin au passage
+ * (chaque pixel pointe sur son grand-parent).
+ * ------------------------------------------------------------*/
+static int trouver (vector<int> &parent, int p)
+{
+	while (parent[p] != p)
+	{
+		parent[p] = parent[parent[p]];
+		p = parent[p];
+	}
+	return p;
+}
+
+// La plus petite racine reste racine : parent[p] <= p pour tout p
+static void unir (vector<int> &parent, int p, int q)
+{
+	p = trouver(parent, p);
+	q = trouver(parent, q);
+	if (p < q)		parent[q] = p;
+	else if (q < p)	parent[p] = q;
+}
+
+/*--------------------------------------------------------------
+ * Unit le pixel (x, y) de l'ensemble à ses voisins déjà vus,
+ * sans remonter au-dessus de la ligne @y_min.
+ * ------------------------------------------------------------*/
+template <class Dedans>
+static void unir_voisins_haut (vector<int> &parent, const Dedans &dedans,
+	int cols, int connexite, int x, int y, int y_min)
+{
+	int p = y * cols + x;
+	if (x > 0 && dedans(p-1)) unir(parent, p, p-1);
+	if (y <= y_min) return;
+	int q = p - cols;
+	if (dedans(q)) unir(parent, p, q);
+	if (connexite == 8) {
+		if (x > 0 && dedans(q-1)) unir(parent, p, q-1);
+		if (x < cols-1 && dedans(q+1)) unir(parent, p, q+1);
+	}
+}
+
+/*--------------------------------------------------------------
+ * Étiquette les pixels p tels que @dedans(p) : @etiq reçoit 0
+ * hors de l'ensemble, sinon le numéro (à partir de 1) de la
+ * composante, décrite dans @comps[numéro-1].
+ * ------------------------------------------------------------*/
+template <class Dedans>
+static void etiqueter (int rows, int cols, int connexite, const Dedans &dedans,
+	vector<int> &etiq, vector<Composante> &comps)
+{
+	vector<int> parent(rows * cols);
+	PoolThreads &pool = pool_threads();
+	int hauteur = max(1, (rows + pool._nb_threads() - 1) / pool._nb_threads());
+
+	// 1ere passe par bandes : chaque bande ne touche que ses pixels
+	pool.parallel_for(0, rows, hauteur, [&](int debut, int fin, int num) {
+		for (int y = debut; y < fin; y++)
+		for (int x = 0; x < cols; x++)
+		{
+			int p = y * cols + x;
+			parent[p] = p;
+			if (dedans(p)) unir_voisins_haut(parent, dedans, cols, connexite, x, y, debut);
+		}
+	});
+
+	// recollement des bandes
+	for (int y = hauteur; y < rows; y += hauteur)
+	for (int x = 0; x < cols; x++)
+	{
+		if (dedans(y * cols + x))
+			unir_voisins_haut(parent, dedans, cols, connexite, x, y, y-1);
+	}
+
+	// 2e passe : parent[p] < p est déjà numéroté
+	etiq.assign(rows * cols, 0);
+	comps.clear();
+	for (int y = 0; y < rows; y++)
+	for (int x = 0; x < cols; x++)
+	{
+		int p = y * cols + x;
+		if (!dedans(p)) continue;
+		if (parent[p] == p)
+		{
+			Composante c = { 0, x, y, x, y, x, y };
+			comps.push_back(c);
+			etiq[p] = comps.size();
+		}
+		else etiq[p] = etiq[parent[p]];
+
+		Composante &c = comps[etiq[p] - 1];
+		c.aire++;
+		c.xmin = min(c.xmin, x);	c.xmax = max(c.xmax, x);
+		c.ymax = y;
+	}
+}
+
+Etiquetage::Etiquetage (cv::Mat img_niv, int connexite) :
+	rows(img_niv.rows), cols(img_niv.cols), connexite(connexite)
+{
+	vector<unsigned char> forme(rows * cols);
+	for (int y = 0; y < rows; y++)
+	{
+		const int *src = img_niv.ptr<int>(y);
+		for (int x = 0; x < cols; x++) forme[y * cols + x] = src[x] != 0;
+	}
+
+	etiqueter(rows, cols, connexite,
+		[&](int p) { return forme[p] != 0; }, etiquettes, composantes);
+}
+
+Etiquetage::~Etiquetage()
+{
+	;
+}
+
+int Etiquetage::_nb_composantes() {	return composantes.size();	}
+
+const vector<Composante> &Etiquetage::_composantes() {	return composantes;	}
+
+int Etiquetage::etiquette(int x, int y) {	return etiquettes[y * cols + x];	}
+
+/*--------------------------------------------------------------
+ * Un germe par contour, dans l'ordre de balayage :
+ *  - contour extérieur : le germe de la composante, dont le
+ *    voisin du haut est hors de la composante ;
+ *  - contour d'un trou : les trous sont les composantes du fond
+ *    (en connexité complémentaire) qui ne touchent pas le bord
+ *    de l'image ; le pixel au-dessus du germe d'un trou est
+ *    dans la forme, son voisin du bas est dans le trou.
+ * ------------------------------------------------------------*/
+vector<GermeContour> Etiquetage::germes_contours()
+{
+	vector<GermeContour> germes;
+	for (unsigned i = 0; i < composantes.size(); i++)
+	{
+		GermeContour g = { composantes[i].x_germe, composantes[i].y_germe,
+			ETIQUETAGE_DIR_HAUT, int(i) + 1, false };
+		germes.push_back(g);
+	}
+
+	vector<int> etiq_fond;
+	vector<Composante> fond;
+	etiqueter(rows, cols, 12 - connexite,
+		[&](int p) { return etiquettes[p] == 0; }, etiq_fond, fond);
+
+	for (unsigned i = 0; i < fond.size(); i++)
+	{
+		const Composante &c = fond[i];
+		if (c.xmin == 0 || c.ymin == 0 || c.xmax == cols-1 || c.ymax == rows-1) continue;
+		GermeContour g = { c.x_germe, c.y_germe - 1, ETIQUETAGE_DIR_BAS,
+			etiquette(c.x_germe, c.y_germe - 1), true };
+		germes.push_back(g);
+	}
+
+	stable_sort(germes.begin(), germes.end(), [](const GermeContour &a, const GermeContour &b) {
+		return a.y != b.y ? a.y < b.y : a.x < b.x;
+	});
+	return germes;
+}
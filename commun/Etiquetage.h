@@ -0,0 +1,69 @@
+#ifndef ETIQUETAGE_H
+#define ETIQUETAGE_H
+
+#include <iostream>
+#include <cstring>
+#include <opencv2/opencv.hpp>
+
+#include "PoolThreads.h"
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Étiquetage des composantes connexes de la forme (pixels != 0)
+ * en 4- ou 8-connexité, par union-find.
+ *
+ * 1ere passe : chaque pixel est uni à ses voisins déjà vus
+ *              (gauche et haut, plus les diagonales hautes en
+ *              8-connexité). L'image est découpée en bandes de
+ *              lignes traitées en parallèle, puis les bandes
+ *              sont recollées en unissant les pixels de part et
+ *              d'autre de chaque frontière.
+ * 2e passe   : la racine d'un ensemble est toujours son plus
+ *              petit indice, donc le premier pixel rencontré en
+ *              balayage : une seule passe numérote les
+ *              composantes de 1 à n, dans l'ordre de balayage,
+ *              et calcule aire, boîte englobante et germe.
+ * ------------------------------------------------------------*/
+
+struct Composante
+{
+	int aire;
+	int xmin, ymin, xmax, ymax;		// boîte englobante
+	int x_germe, y_germe;			// premier pixel en balayage
+};
+
+/*--------------------------------------------------------------
+ * Point de départ d'un suivi de contour : (x, y) est un pixel
+ * de la forme et la direction de Freeman @dir pointe sur un
+ * 4-voisin du fond qui est du côté du contour à suivre.
+ * ------------------------------------------------------------*/
+struct GermeContour
+{
+	int x, y;
+	int dir;
+	int etiquette;			// composante de la forme
+	bool trou;				// contour d'un trou de la composante
+};
+
+class Etiquetage
+{
+public:
+
+	Etiquetage (cv::Mat img_niv, int connexite);
+	~Etiquetage();
+
+	int _nb_composantes();
+	const vector<Composante> &_composantes();
+	int etiquette(int x, int y);	// 0 pour le fond
+	vector<GermeContour> germes_contours();
+
+private:
+
+	int rows, cols, connexite;
+	vector<int> etiquettes;
+	vector<Composante> composantes;
+};
+
+#endif // ETIQUETAGE_H
@@ -0,0 +1,611 @@
+#include "Flux.h"
+#include "Chanfrein.h"
+#include "DemiMasque.h"
+#include "Sedt.h"
+#include "PoolThreads.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//------------------------- E N T R E E S / S O R T I E S ---------------------
+
+static runtime_error erreur_systeme (const string &quoi, const string &chemin)
+{
+	return runtime_error(quoi + " '" + chemin + "' : " + strerror(errno));
+}
+
+static void ecrire_tout (int fd, const void *src, size_t octets, off_t pos)
+{
+	const char *p = (const char *) src;
+	while (octets > 0)
+	{
+		ssize_t n = pwrite(fd, p, octets, pos);
+		if (n < 0 && errno == EINTR) continue;
+		if (n <= 0) throw runtime_error(string("écriture : ") + strerror(errno));
+		p += n; octets -= n; pos += n;
+	}
+}
+
+static void lire_tout (int fd, void *dst, size_t octets, off_t pos)
+{
+	char *p = (char *) dst;
+	while (octets > 0)
+	{
+		ssize_t n = pread(fd, p, octets, pos);
+		if (n < 0 && errno == EINTR) continue;
+		if (n <= 0) throw runtime_error(string("lecture : ") + strerror(errno));
+		p += n; octets -= n; pos += n;
+	}
+}
+
+/*--------------------------------------------------------------
+ * En-tête "P5 <cols> <rows> <maxval>" avec commentaires '#',
+ * suivi d'un seul blanc : rend la position du premier pixel.
+ * ------------------------------------------------------------*/
+static size_t lire_entete_pgm (const uchar *p, size_t taille, int &cols, int &rows)
+{
+	if (taille < 2 || p[0] != 'P' || p[1] != '5')
+		throw runtime_error("ni PGM binaire (P5), ni -taille");
+
+	size_t i = 2;
+	long v[3];
+	for (int k = 0; k < 3; k++)
+	{
+		while (i < taille && (isspace(p[i]) || p[i] == '#'))
+		{
+			if (p[i] == '#') while (i < taille && p[i] != '\n') i++;
+			else i++;
+		}
+		if (i >= taille || !isdigit(p[i])) throw runtime_error("en-tête PGM invalide");
+		v[k] = 0;
+		while (i < taille && isdigit(p[i]))
+		{
+			v[k] = 10 * v[k] + (p[i++] - '0');
+			if (v[k] > INT_MAX) throw runtime_error("en-tête PGM invalide");
+		}
+	}
+	if (i >= taille || !isspace(p[i])) throw runtime_error("en-tête PGM invalide");
+	if (v[2] > 255) throw runtime_error("PGM 16 bits non géré en entrée");
+	cols = v[0];
+	rows = v[1];
+	return i + 1;
+}
+
+/*--------------------------------------------------------------
+ * Image d'entrée (8 bits) projetée en mémoire, lue bande par
+ * bande dans l'ordre ; les pages des lignes lues sont rendues
+ * au système.
+ * ------------------------------------------------------------*/
+class EntreeProjetee
+{
+public:
+
+	EntreeProjetee (const string &chemin, int cols_brut, int rows_brut) :
+		fd(-1), base(nullptr), taille(0), debut(0)
+	{
+		fd = open(chemin.c_str(), O_RDONLY);
+		if (fd < 0) throw erreur_systeme("ouverture", chemin);
+		struct stat st;
+		if (fstat(fd, &st) != 0) throw erreur_systeme("stat", chemin);
+		taille = st.st_size;
+		if (taille == 0) throw runtime_error("fichier vide '" + chemin + "'");
+
+		void *p = mmap(nullptr, taille, PROT_READ, MAP_SHARED, fd, 0);
+		if (p == MAP_FAILED) throw erreur_systeme("mmap", chemin);
+		base = (const uchar *) p;
+		madvise(p, taille, MADV_SEQUENTIAL);
+
+		if (cols_brut > 0) { cols = cols_brut; rows = rows_brut; }
+		else debut = lire_entete_pgm(base, taille, cols, rows);
+		if (cols <= 0 || rows <= 0 || debut + (size_t) rows * cols > taille)
+			throw runtime_error("taille incohérente pour '" + chemin + "'");
+	}
+
+	~EntreeProjetee()
+	{
+		if (base) munmap((void *) base, taille);
+		if (fd >= 0) close(fd);
+	}
+
+	int _rows() const {	return rows;	}
+	int _cols() const {	return cols;	}
+
+	// Lignes [y0, y0+n[ seuillées : @forme si > seuil, sinon 0
+	void lire_bande (int y0, int n, int seuil, int forme, int *dst, size_t pas)
+	{
+		for (int k = 0; k < n; k++)
+		{
+			const uchar *s = base + debut + (size_t) (y0 + k) * cols;
+			int *d = dst + k * pas;
+			for (int x = 0; x < cols; x++) d[x] = s[x] > seuil ? forme : 0;
+		}
+		liberer(y0, n);
+	}
+
+private:
+
+	int fd;
+	const uchar *base;
+	size_t taille, debut;
+	int rows, cols;
+
+	EntreeProjetee (const EntreeProjetee &);
+	EntreeProjetee &operator= (const EntreeProjetee &);
+
+	// Pages entièrement lues (la dernière peut servir à la bande suivante)
+	void liberer (int y0, int n)
+	{
+		size_t page = sysconf(_SC_PAGESIZE);
+		size_t a = (debut + (size_t) y0 * cols) / page * page;
+		size_t b = (debut + (size_t) (y0 + n) * cols) / page * page;
+		if (b > a) madvise((void *) (base + a), b - a, MADV_DONTNEED);
+	}
+};
+
+/*--------------------------------------------------------------
+ * Fichier intermédiaire créé à côté de @pres_de et effacé tout
+ * de suite : il disparaît à la fermeture, même après une erreur.
+ * ------------------------------------------------------------*/
+class FichierTemporaire
+{
+public:
+
+	FichierTemporaire (const string &pres_de)
+	{
+		size_t slash = pres_de.rfind('/');
+		string dossier = slash == string::npos ? "." : pres_de.substr(0, slash + 1);
+		vector<char> nom(dossier.begin(), dossier.end());
+		const char *modele = "/.flux-XXXXXX";
+		nom.insert(nom.end(), modele, modele + strlen(modele) + 1);
+		fd = mkstemp(nom.data());
+		if (fd < 0) throw erreur_systeme("fichier temporaire", nom.data());
+		unlink(nom.data());
+	}
+
+	~FichierTemporaire() {	close(fd);	}
+
+	void ecrire (const void *src, size_t octets, off_t pos) { ecrire_tout(fd, src, octets, pos); }
+	void lire (void *dst, size_t octets, off_t pos) { lire_tout(fd, dst, octets, pos); }
+
+private:
+
+	int fd;
+
+	FichierTemporaire (const FichierTemporaire &);
+	FichierTemporaire &operator= (const FichierTemporaire &);
+};
+
+/*--------------------------------------------------------------
+ * Résultat : PGM 8 ou 16 bits (big-endian, valeurs saturées à
+ * 255 ou 65535), ou int 32 bits bruts. On écrit des morceaux de
+ * lignes n'importe où dans le fichier.
+ * ------------------------------------------------------------*/
+class SortieFlux
+{
+public:
+
+	SortieFlux (const string &base, int rows, int cols, int octets) :
+		rows(rows), cols(cols), octets(octets), debut(0)
+	{
+		string entete;
+		if (octets == 4)
+			chemin = base + "." + to_string(cols) + "x" + to_string(rows) + ".raw";
+		else
+		{
+			chemin = base + ".pgm";
+			entete = "P5\n" + to_string(cols) + " " + to_string(rows) + "\n"
+				+ (octets == 1 ? "255" : to_string(FLUX_MAX_16)) + "\n";
+		}
+		fd = open(chemin.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0) throw erreur_systeme("création", chemin);
+		debut = entete.size();
+		ecrire_tout(fd, entete.data(), entete.size(), 0);
+		if (ftruncate(fd, debut + (off_t) rows * cols * octets) != 0)
+			throw erreur_systeme("ftruncate", chemin);
+	}
+
+	~SortieFlux() {	close(fd);	}
+
+	const string &_chemin() const {	return chemin;	}
+
+	void ecrire (int y, int x0, int n, const int *src)
+	{
+		tampon.resize((size_t) n * octets);
+		uchar *t = tampon.data();
+		if (octets == 1)
+			for (int x = 0; x < n; x++) t[x] = min(max(src[x], 0), 255);
+		else if (octets == 2)
+			for (int x = 0; x < n; x++)
+			{
+				int v = min(max(src[x], 0), FLUX_MAX_16);
+				t[2*x] = v >> 8;
+				t[2*x+1] = v & 255;
+			}
+		else memcpy(t, src, (size_t) n * sizeof(int));
+		ecrire_tout(fd, t, tampon.size(), debut + ((off_t) y * cols + x0) * octets);
+	}
+
+private:
+
+	int fd;
+	int rows, cols, octets;
+	off_t debut;
+	string chemin;
+	vector<uchar> tampon;
+
+	SortieFlux (const SortieFlux &);
+	SortieFlux &operator= (const SortieFlux &);
+};
+
+/*--------------------------------------------------------------
+ * Rangement des entiers dans les fichiers intermédiaires, sur 2
+ * ou 4 octets ; en 16 bits, @infini est rangé comme 65535.
+ * ------------------------------------------------------------*/
+static void ranger (const int *src, uchar *dst, int n, int octets, int infini)
+{
+	if (octets == 4) { memcpy(dst, src, (size_t) n * sizeof(int)); return; }
+	uint16_t *d = (uint16_t *) dst;
+	for (int x = 0; x < n; x++)
+		d[x] = (src[x] == infini || src[x] >= FLUX_MAX_16) ? FLUX_MAX_16 : src[x];
+}
+
+static void deranger (const uchar *src, int *dst, int n, int octets, int infini)
+{
+	if (octets == 4) { memcpy(dst, src, (size_t) n * sizeof(int)); return; }
+	const uint16_t *s = (const uint16_t *) src;
+	for (int x = 0; x < n; x++)
+		dst[x] = s[x] == FLUX_MAX_16 ? infini : s[x];
+}
+
+//----------------------------- O P E R A T I O N S ----------------------------
+
+static string flux_seuil (EntreeProjetee &e, const string &sortie, int seuil, int bande)
+{
+	int rows = e._rows(), cols = e._cols();
+	SortieFlux s(sortie, rows, cols, 1);
+	vector<int> lignes((size_t) bande * cols);
+
+	for (int y0 = 0; y0 < rows; y0 += bande)
+	{
+		int n = min(bande, rows - y0);
+		e.lire_bande(y0, n, seuil, 255, lignes.data(), cols);
+		for (int k = 0; k < n; k++) s.ecrire(y0 + k, 0, cols, &lignes[(size_t) k * cols]);
+	}
+	return s._chemin();
+}
+
+// Poids des déplacements (1,0) et (0,1), 0 si le masque n'en a pas
+static int poids_axes (const DemiMasque &dm)
+{
+	int wx = 0, wy = 0;
+	for (unsigned i = 0; i < dm.list_pond.size(); i++)
+	{
+		const Ponderation &p = dm.list_pond[i];
+		if (p.y == 0 && abs(p.x) == 1) wx = max(wx, p.w);
+		if (p.x == 0 && abs(p.y) == 1) wy = max(wy, p.w);
+	}
+	return (wx && wy) ? max(wx, wy) : 0;
+}
+
+/*--------------------------------------------------------------
+ * DT par bandes : s'il y a du fond, une distance finie est au
+ * plus a * (rows + cols) (chemin en 4-connexité) ; elle tient
+ * alors en 16 bits, dans le fichier intermédiaire comme dans le
+ * résultat, si cette borne est < 65535.
+ * ------------------------------------------------------------*/
+static string flux_dt (EntreeProjetee &e, const string &sortie, int seuil, int bande,
+	const DemiMasque &dm)
+{
+	int rows = e._rows(), cols = e._cols();
+	BandeChanfrein b(dm, cols, bande);
+	int p = b._portee();
+	if (p > bande) throw runtime_error("bande plus petite que la portée du masque");
+
+	long long borne = (long long) poids_axes(dm) * (rows + cols);
+	int octets = (borne > 0 && borne < FLUX_MAX_16) ? 2 : 4;
+	size_t pas = b.ligne(1) - b.ligne(0);
+	size_t ligne_tmp = (size_t) cols * octets;
+	FichierTemporaire tmp(sortie);
+	vector<uchar> conv(ligne_tmp);
+
+	// Passage avant, de haut en bas ; les lignes -p..-1 du tampon
+	// sont à l'infini pour la première bande, puis reprennent la
+	// fin de la bande précédente
+	for (int y0 = 0; y0 < rows; y0 += bande)
+	{
+		int n = min(bande, rows - y0);
+		e.lire_bande(y0, n, seuil, CHANFREIN_INFINI, b.ligne(0), pas);
+		b.passe_avant(n);
+		for (int k = 0; k < n; k++)
+		{
+			ranger(b.ligne(k), conv.data(), cols, octets, CHANFREIN_INFINI);
+			tmp.ecrire(conv.data(), ligne_tmp, (off_t) (y0 + k) * ligne_tmp);
+		}
+		for (int i = 0; i < p && n >= p; i++)
+			memcpy(b.ligne(i - p), b.ligne(n - p + i), cols * sizeof(int));
+	}
+
+	// Passage arrière, de bas en haut ; @suite garde les p lignes
+	// finales sous la bande courante (infini sous l'image)
+	SortieFlux s(sortie, rows, cols, octets);
+	vector<int> suite((size_t) p * cols, CHANFREIN_INFINI), nouvelle(suite.size());
+	int nb_bandes = (rows + bande - 1) / bande;
+
+	for (int k_bande = nb_bandes - 1; k_bande >= 0; k_bande--)
+	{
+		int y0 = k_bande * bande, n = min(bande, rows - y0);
+		for (int k = 0; k < n; k++)
+		{
+			tmp.lire(conv.data(), ligne_tmp, (off_t) (y0 + k) * ligne_tmp);
+			deranger(conv.data(), b.ligne(k), cols, octets, CHANFREIN_INFINI);
+		}
+		for (int i = 0; i < p; i++)
+			memcpy(b.ligne(n + i), &suite[(size_t) i * cols], cols * sizeof(int));
+
+		b.passe_arriere(n);
+
+		for (int k = 0; k < n; k++) s.ecrire(y0 + k, 0, cols, b.ligne(k));
+		for (int i = 0; i < p; i++)
+			memcpy(&nouvelle[(size_t) i * cols], i < n ? b.ligne(i) : &suite[(size_t) (i - n) * cols],
+				cols * sizeof(int));
+		suite.swap(nouvelle);
+	}
+	return s._chemin();
+}
+
+/*--------------------------------------------------------------
+ * SEDT par bandes. La passe des lignes (voir sedt_passe_lignes)
+ * donne g <= cols, rangé sur disque par tuiles de bande x larg
+ * pixels ; la passe des colonnes relit les tuiles d'un paquet de
+ * larg colonnes, toutes lignes, pour sedt_passe_colonnes. larg
+ * est choisi pour que le paquet tienne dans -memoire Mo.
+ * ------------------------------------------------------------*/
+static string flux_sedt (EntreeProjetee &e, const string &sortie, int seuil, int bande,
+	long memoire)
+{
+	int rows = e._rows(), cols = e._cols();
+	PoolThreads &pool = pool_threads();
+	vector<TamponSedt> tampons(pool._nb_threads());
+
+	long reste = memoire - (long) pool._nb_threads() * rows * 24;
+	int larg = (int) max(1L, min((long) cols, reste / (4L * rows)));
+	int nb_paquets = (cols + larg - 1) / larg;
+	int octets_g = cols < FLUX_MAX_16 ? 2 : 4;
+	size_t tuile = (size_t) bande * larg * octets_g;
+
+	FichierTemporaire tmp(sortie);
+	vector<uchar> conv(tuile);
+	cv::Mat lignes(bande, cols, CV_32SC1);
+
+	for (int y0 = 0, k_bande = 0; y0 < rows; y0 += bande, k_bande++)
+	{
+		int n = min(bande, rows - y0);
+		e.lire_bande(y0, n, seuil, 255, lignes.ptr<int>(0), cols);
+		pool.parallel_for(0, n, SEDT_GRAIN, [&](int debut, int fin, int num) {
+			sedt_passe_lignes(lignes, debut, fin, false);
+		});
+		for (int j = 0; j < nb_paquets; j++)
+		{
+			int x0 = j * larg, w = min(larg, cols - x0);
+			for (int k = 0; k < n; k++)
+				ranger(lignes.ptr<int>(k) + x0, &conv[(size_t) k * larg * octets_g], w,
+					octets_g, SEDT_LIGNE_SANS_FOND);
+			tmp.ecrire(conv.data(), (size_t) n * larg * octets_g,
+				(off_t) ((size_t) k_bande * nb_paquets + j) * tuile);
+		}
+	}
+
+	long long d2_max = (long long) (rows-1) * (rows-1) + (long long) (cols-1) * (cols-1);
+	SortieFlux s(sortie, rows, cols, d2_max < FLUX_MAX_16 ? 2 : 4);
+	cv::Mat colonnes(rows, larg, CV_32SC1);
+
+	for (int j = 0; j < nb_paquets; j++)
+	{
+		int x0 = j * larg, w = min(larg, cols - x0);
+		for (int y0 = 0, k_bande = 0; y0 < rows; y0 += bande, k_bande++)
+		{
+			int n = min(bande, rows - y0);
+			tmp.lire(conv.data(), (size_t) n * larg * octets_g,
+				(off_t) ((size_t) k_bande * nb_paquets + j) * tuile);
+			for (int k = 0; k < n; k++)
+				deranger(&conv[(size_t) k * larg * octets_g], colonnes.ptr<int>(y0 + k), w,
+					octets_g, SEDT_LIGNE_SANS_FOND);
+		}
+		pool.parallel_for(0, w, SEDT_GRAIN, [&](int debut, int fin, int num) {
+			sedt_passe_colonnes(colonnes, debut, fin, false, tampons[num]);
+		});
+		for (int y = 0; y < rows; y++) s.ecrire(y, x0, w, colonnes.ptr<int>(y));
+	}
+	return s._chemin();
+}
+
+// Segment [x0, x1] de la forme sur une ligne, @id dans l'union-find
+struct SegmentFlux
+{
+	int x0, x1, id;
+};
+
+static int trouver (vector<int> &parent, int i)
+{
+	while (parent[i] != i)
+	{
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+/*--------------------------------------------------------------
+ * Étiquetage par segments : chaque segment est uni à ceux de la
+ * ligne précédente qu'il touche. La racine d'un ensemble est
+ * toujours son plus petit id, c'est-à-dire son premier segment
+ * en balayage : numéroter les racines dans l'ordre des id donne
+ * la numérotation de la classe Etiquetage.
+ * ------------------------------------------------------------*/
+static string flux_etiquetage (EntreeProjetee &e, const string &sortie, int seuil, int bande,
+	int connexite)
+{
+	int rows = e._rows(), cols = e._cols();
+	int ext = connexite == 8 ? 1 : 0;
+	vector<int> parent;
+	vector<long long> debut_ligne(rows + 1, 0);
+	vector<SegmentFlux> prec, cour, a_ecrire;
+	vector<int> lignes((size_t) bande * cols);
+	FichierTemporaire tmp(sortie);
+
+	for (int y0 = 0; y0 < rows; y0 += bande)
+	{
+		int n = min(bande, rows - y0);
+		e.lire_bande(y0, n, seuil, 255, lignes.data(), cols);
+		a_ecrire.clear();
+		for (int k = 0; k < n; k++)
+		{
+			const int *l = &lignes[(size_t) k * cols];
+			cour.clear();
+			for (int x = 0; x < cols; )
+			{
+				if (!l[x]) { x++; continue; }
+				SegmentFlux sg = { x, 0, (int) parent.size() };
+				while (x < cols && l[x]) x++;
+				sg.x1 = x - 1;
+				if (parent.size() >= (size_t) INT_MAX) throw runtime_error("trop de segments");
+				parent.push_back(sg.id);
+				cour.push_back(sg);
+			}
+			for (size_t i = 0, j = 0; i < prec.size() && j < cour.size(); )
+			{
+				if (prec[i].x0 <= cour[j].x1 + ext && cour[j].x0 <= prec[i].x1 + ext)
+				{
+					int ra = trouver(parent, prec[i].id), rb = trouver(parent, cour[j].id);
+					if (ra < rb) parent[rb] = ra;
+					else parent[ra] = rb;
+				}
+				if (prec[i].x1 < cour[j].x1) i++;
+				else j++;
+			}
+			debut_ligne[y0 + k + 1] = debut_ligne[y0 + k] + cour.size();
+			a_ecrire.insert(a_ecrire.end(), cour.begin(), cour.end());
+			prec.swap(cour);
+		}
+		tmp.ecrire(a_ecrire.data(), a_ecrire.size() * sizeof(SegmentFlux),
+			(off_t) debut_ligne[y0] * sizeof(SegmentFlux));
+	}
+
+	// parent[i] devient l'étiquette du segment i : après compression,
+	// parent[i] est une racine, déjà renumérotée car plus petite que i
+	int nb = 0;
+	for (size_t i = 0; i < parent.size(); i++) parent[i] = parent[parent[i]];
+	for (size_t i = 0; i < parent.size(); i++)
+		parent[i] = (parent[i] == (int) i) ? ++nb : parent[parent[i]];
+
+	SortieFlux s(sortie, rows, cols, nb <= FLUX_MAX_16 ? 2 : 4);
+	for (int y0 = 0; y0 < rows; y0 += bande)
+	{
+		int n = min(bande, rows - y0);
+		long long d = debut_ligne[y0], f = debut_ligne[y0 + n];
+		a_ecrire.resize(f - d);
+		tmp.lire(a_ecrire.data(), a_ecrire.size() * sizeof(SegmentFlux), (off_t) d * sizeof(SegmentFlux));
+		fill(lignes.begin(), lignes.end(), 0);
+		for (int k = 0; k < n; k++)
+		{
+			int *l = &lignes[(size_t) k * cols];
+			for (long long i = debut_ligne[y0 + k]; i < debut_ligne[y0 + k + 1]; i++)
+			{
+				const SegmentFlux &sg = a_ecrire[i - d];
+				fill(l + sg.x0, l + sg.x1 + 1, parent[sg.id]);
+			}
+			s.ecrire(y0 + k, 0, cols, l);
+		}
+	}
+	return s._chemin();
+}
+
+//---------------------------------- F L U X -----------------------------------
+
+static void afficher_usage_flux()
+{
+	std::cout <<
+		"Usage: prog --flux [-thr seuil] [-bande N] [-memoire Mo] [-taille LxH]\n"
+		"                   [--threads N] -op nom[:param] entrée sortie\n"
+		"  entrée : PGM 8 bits (P5), ou fichier brut de L x H octets avec -taille\n"
+		"  sortie : sortie.pgm (8 ou 16 bits) ou sortie.<cols>x<rows>.raw (int 32 bits)\n"
+		"Opérations :\n"
+		"  seuil                        pixel > seuil -> 255, sinon 0\n"
+		"  dt:<masque>                  DT de chanfrein (d4, d8, 2-3, 3-4, 5-7-11)\n"
+		"  sedt                         SEDT exacte\n"
+		"  etiquetage[:4|8]             composantes connexes (défaut : 8)\n"
+		<< std::endl;
+}
+
+int executer_flux (int argc, char **argv)
+{
+	int seuil = 127, bande = FLUX_BANDE_DEFAUT, cols_brut = 0, rows_brut = 0;
+	long memoire = FLUX_MEMOIRE_DEFAUT;
+	string op;
+	vector<string> fichiers;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string a = argv[i];
+		bool avec_valeur = (a == "-thr" || a == "-bande" || a == "-memoire" || a == "-taille"
+			|| a == "--threads" || a == "-op");
+		if (avec_valeur && i+1 >= argc) { afficher_usage_flux(); return 1; }
+
+		if      (a == "-thr")		seuil = atoi(argv[++i]);
+		else if (a == "-bande")		bande = max(8, atoi(argv[++i]));
+		else if (a == "-memoire")	memoire = max(1, atoi(argv[++i]));
+		else if (a == "-taille")	{ if (sscanf(argv[++i], "%dx%d", &cols_brut, &rows_brut) != 2
+										|| cols_brut <= 0 || rows_brut <= 0) { afficher_usage_flux(); return 1; } }
+		else if (a == "--threads")	definir_nb_threads(atoi(argv[++i]));
+		else if (a == "-op")		op = argv[++i];
+		else if (a == "-h" || a == "--help") { afficher_usage_flux(); return 0; }
+		else fichiers.push_back(a);
+	}
+	if (op.empty() || fichiers.size() != 2) { afficher_usage_flux(); return 1; }
+
+	size_t deux_points = op.find(':');
+	string nom = op.substr(0, deux_points);
+	string param = (deux_points == string::npos) ? "" : op.substr(deux_points + 1);
+
+	chrono::steady_clock::time_point debut = chrono::steady_clock::now();
+	try {
+		EntreeProjetee e(fichiers[0], cols_brut, rows_brut);
+		string chemin;
+
+		if (nom == "seuil")
+			chemin = flux_seuil(e, fichiers[1], seuil, bande);
+		else if (nom == "dt")
+		{
+			NumeroMasque num = numero_masque(param);
+			if (num == M_LAST) throw runtime_error("masque '" + param + "' inconnu");
+			chemin = flux_dt(e, fichiers[1], seuil, bande, DemiMasque(num));
+		}
+		else if (nom == "sedt")
+			chemin = flux_sedt(e, fichiers[1], seuil, bande, memoire << 20);
+		else if (nom == "etiquetage")
+		{
+			int connexite = param.empty() ? 8 : stoi(param);
+			if (connexite != 4 && connexite != 8) throw runtime_error("connexité 4 ou 8");
+			chemin = flux_etiquetage(e, fichiers[1], seuil, bande, connexite);
+		}
+		else throw runtime_error("opération inconnue");
+
+		double s = chrono::duration<double>(chrono::steady_clock::now() - debut).count();
+		std::cout << fichiers[0] << " (" << e._cols() << "x" << e._rows() << ") -> "
+			<< chemin << " en " << s << " s" << std::endl;
+	} catch (exception &ex) {
+		std::cerr << "--flux " << op << " : " << ex.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
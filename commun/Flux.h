@@ -0,0 +1,58 @@
+#ifndef FLUX_H
+#define FLUX_H
+
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Mode --flux, sans fenêtre, commun à tous les TP : traite par
+ * bandes de lignes une image trop grande pour être chargée,
+ *
+ *   prog --flux [-thr seuil] [-bande N] [-memoire Mo] [-taille LxH]
+ *        [--threads N] -op nom[:param] entrée sortie
+ *
+ * L'entrée est un PGM binaire 8 bits (P5) ou, avec -taille, un
+ * fichier brut de L x H octets. Elle est projetée en mémoire
+ * (mmap) et lue bande par bande ; les pages d'une bande lue sont
+ * rendues au système (madvise) : seule la bande en cours reste
+ * résidente. Chaque pixel est seuillé à la lecture (> seuil :
+ * forme à 255, sinon fond à 0), comme en mode --batch.
+ *
+ * Opérations séparables par lignes :
+ *   seuil           image seuillée ;
+ *   dt:<masque>     DT de chanfrein (d4, d8, 2-3, 3-4, 5-7-11) :
+ *                   passage avant des bandes de haut en bas,
+ *                   résultat intermédiaire sur disque, passage
+ *                   arrière de bas en haut (voir BandeChanfrein) ;
+ *   sedt            SEDT exacte (voir Sedt.h) : passe des lignes
+ *                   par bandes, rangée sur disque par tuiles, puis
+ *                   passe des colonnes par paquets de colonnes ;
+ *   etiquetage[:c]  composantes c-connexes (c = 4 ou 8, défaut
+ *                   8), numérotées comme Etiquetage : union-find
+ *                   sur les segments de chaque ligne, puis
+ *                   renumérotation des segments rangés sur disque.
+ *
+ * Résultat : sortie.pgm en 8 bits (seuil), en 16 bits quand la
+ * plus grande valeur possible le permet (65535 note alors une
+ * distance infinie), sinon sortie.<cols>x<rows>.raw en int 32
+ * bits comme en mode --batch. Les fichiers intermédiaires sont
+ * créés à côté de la sortie et effacés dès leur ouverture.
+ *
+ * Mémoire : la bande de -bande lignes (en int) et ses voisines ;
+ * pour la SEDT, -memoire Mo pour les colonnes ; pour
+ * l'étiquetage, 4 octets par segment de ligne de la forme.
+ * ------------------------------------------------------------*/
+
+const int FLUX_BANDE_DEFAUT = 256;		// lignes par bande
+const int FLUX_MEMOIRE_DEFAUT = 256;	// Mo pour la passe des colonnes de la SEDT
+const int FLUX_MAX_16 = 65535;			// valeur max en 16 bits, aussi l'infini
+
+// argv[0] est "--flux" ; rend le code de sortie du programme
+int executer_flux (int argc, char **argv);
+
+#endif // FLUX_H
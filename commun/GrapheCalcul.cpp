@@ -0,0 +1,34 @@
+#include "GrapheCalcul.h"
+
+//------------------- C L A S S E     N O E U D C A L C U L --------------------
+
+NoeudCalcul::NoeudCalcul() :
+	version(0), valide(false)
+{
+	;
+}
+
+NoeudCalcul::~NoeudCalcul()
+{
+	;
+}
+
+long NoeudCalcul::_version() {	return version;	}
+
+cv::Mat NoeudCalcul::obtenir(const vector<long> &cle, const function<void(cv::Mat &)> &calculer)
+{
+	if (valide && cle == this->cle) return resultat;
+
+	cv::Mat r;
+	calculer(r);
+	resultat = r;
+	this->cle = cle;
+	version++;
+	valide = true;
+	return resultat;
+}
+
+void NoeudCalcul::invalider()
+{
+	valide = false;
+}
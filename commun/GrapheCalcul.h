@@ -0,0 +1,48 @@
+#ifndef GRAPHE_CALCUL_H
+#define GRAPHE_CALCUL_H
+
+#include <iostream>
+#include <cstring>
+#include <functional>
+#include <opencv2/opencv.hpp>
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Noeud d'un graphe de calcul mémorisé, pour la boucle
+ * interactive des TP (gris -> seuil -> DT -> maximums -> RDT).
+ *
+ * Le noeud garde son dernier résultat et la clé qui l'a
+ * produit : les versions de ses entrées et ses paramètres.
+ * obtenir() rend le résultat gardé tant que la clé ne change
+ * pas ; sinon il le recalcule et incrémente sa version, ce qui
+ * invalide à leur tour les noeuds qui mettent cette version
+ * dans leur clé. Un curseur qui ne touche qu'un paramètre aval
+ * (filtre) ou un changement d'affichage ne refont donc que les
+ * noeuds en aval.
+ *
+ * Le résultat est partagé avec les noeuds suivants : @calculer
+ * doit écrire une nouvelle image dans son argument (clone()
+ * de l'entrée avant une transformation sur place).
+ * ------------------------------------------------------------*/
+class NoeudCalcul
+{
+public:
+
+	NoeudCalcul();
+	~NoeudCalcul();
+
+	long _version();
+	cv::Mat obtenir(const vector<long> &cle, const function<void(cv::Mat &)> &calculer);
+	void invalider();
+
+private:
+
+	cv::Mat resultat;
+	vector<long> cle;
+	long version;
+	bool valide;
+};
+
+#endif // GRAPHE_CALCUL_H
@@ -0,0 +1,114 @@
+#ifndef IMAGE_VIEW_H
+#define IMAGE_VIEW_H
+
+#include <iostream>
+#include <cstring>
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Vues non propriétaires sur une image : pointeur, pas entre
+ * deux lignes (en octets) et taille.
+ *
+ * Une vue ne touche pas au compteur de références de cv::Mat :
+ * la copier ne coûte que quatre mots, on la passe donc par
+ * valeur, y compris dans les boucles par pixel. L'image vue
+ * doit survivre à la vue.
+ *
+ * ImageView<T> permet d'écrire, ConstImageView<T> non. Les
+ * deux se construisent implicitement depuis un cv::Mat dont le
+ * type correspond à T (sinon runtime_error), ce qui permet de
+ * les appeler directement avec les images des TP.
+ * ------------------------------------------------------------*/
+
+inline void verifier_type_vue (const cv::Mat &img, int type)
+{
+	if (img.type() != type)
+		throw runtime_error("vue d'image : format non géré '" +
+			to_string(img.type()) + "', attendu '" + to_string(type) + "'");
+}
+
+template <typename T>
+class ImageView
+{
+public:
+
+	ImageView () : data(nullptr), pas(0), rows(0), cols(0) {}
+	ImageView (T *data, size_t pas, int rows, int cols) :
+		data(data), pas(pas), rows(rows), cols(cols) {}
+	ImageView (const cv::Mat &img) :
+		data((T *) img.data), pas(img.step), rows(img.rows), cols(img.cols)
+	{
+		verifier_type_vue(img, cv::DataType<T>::type);
+	}
+
+	int _rows() const {	return rows;	}
+	int _cols() const {	return cols;	}
+	size_t _pas() const {	return pas;	}
+	T *_data() const {	return data;	}
+
+	T *ligne (int y) const {	return (T *) ((char *) data + y * pas);	}
+	T &operator() (int y, int x) const {	return ligne(y)[x];	}
+
+	bool dans_image (int x, int y) const
+	{
+		return 0 <= x && x < cols && 0 <= y && y < rows;
+	}
+
+	ImageView sous_vue (cv::Rect r) const
+	{
+		return ImageView(ligne(r.y) + r.x, pas, r.height, r.width);
+	}
+
+private:
+
+	T *data;
+	size_t pas;		// en octets
+	int rows, cols;
+};
+
+template <typename T>
+class ConstImageView
+{
+public:
+
+	ConstImageView () : data(nullptr), pas(0), rows(0), cols(0) {}
+	ConstImageView (const T *data, size_t pas, int rows, int cols) :
+		data(data), pas(pas), rows(rows), cols(cols) {}
+	ConstImageView (const ImageView<T> &v) :
+		data(v._data()), pas(v._pas()), rows(v._rows()), cols(v._cols()) {}
+	ConstImageView (const cv::Mat &img) :
+		data((const T *) img.data), pas(img.step), rows(img.rows), cols(img.cols)
+	{
+		verifier_type_vue(img, cv::DataType<T>::type);
+	}
+
+	int _rows() const {	return rows;	}
+	int _cols() const {	return cols;	}
+	size_t _pas() const {	return pas;	}
+	const T *_data() const {	return data;	}
+
+	const T *ligne (int y) const {	return (const T *) ((const char *) data + y * pas);	}
+	const T &operator() (int y, int x) const {	return ligne(y)[x];	}
+
+	bool dans_image (int x, int y) const
+	{
+		return 0 <= x && x < cols && 0 <= y && y < rows;
+	}
+
+	ConstImageView sous_vue (cv::Rect r) const
+	{
+		return ConstImageView(ligne(r.y) + r.x, pas, r.height, r.width);
+	}
+
+private:
+
+	const T *data;
+	size_t pas;		// en octets
+	int rows, cols;
+};
+
+#endif // IMAGE_VIEW_H
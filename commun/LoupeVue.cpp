@@ -0,0 +1,125 @@
+#include "LoupeVue.h"
+
+//---------------------- C L A S S E     L O U P E V U E ----------------------
+
+LoupeVue::LoupeVue() :
+	rect_dessine(false), ancienne_src(nullptr), ancienne_dest(nullptr)
+{
+	;
+}
+
+LoupeVue::~LoupeVue()
+{
+	;
+}
+
+int LoupeVue::bon_zoom() {	return zoom >= 1 ? zoom : 1;	}
+
+/*--------------------------------------------------------------
+ * Le dernier carré de la loupe peut n'être que partiellement
+ * visible : on compte un pixel de plus dans chaque direction.
+ * ------------------------------------------------------------*/
+cv::Rect LoupeVue::_portion()
+{
+	return cv::Rect(zoom_x0, zoom_y0, zoom_x1 - zoom_x0 + 1, zoom_y1 - zoom_y0 + 1);
+}
+
+void LoupeVue::reborner(cv::Mat &res1, cv::Mat &res2)
+{
+	int h = res2.rows / bon_zoom();
+	int w = res2.cols / bon_zoom();
+
+	if (zoom_x0 < 0) zoom_x0 = 0;
+	zoom_x1 = zoom_x0 + w;
+	if (zoom_x1 > res1.cols) {
+		zoom_x1 = res1.cols;
+		zoom_x0 = zoom_x1 - w;
+		if (zoom_x0 < 0) zoom_x0 = 0;
+	}
+
+	if (zoom_y0 < 0) zoom_y0 = 0;
+	zoom_y1 = zoom_y0 + h;
+	if (zoom_y1 > res1.rows) {
+		zoom_y1 = res1.rows;
+		zoom_y0 = zoom_y1 - h;
+		if (zoom_y0 < 0) zoom_y0 = 0;
+	}
+}
+
+void LoupeVue::deplacer(cv::Mat &res1, cv::Mat &res2, int dx, int dy)
+{
+	zoom_x0 += dx; zoom_y0 += dy;
+	zoom_x1 += dx; zoom_y1 += dy;
+	reborner(res1, res2);
+}
+
+/*--------------------------------------------------------------
+ * Recopie dans @dest la partie de @r qui est dans l'image.
+ * ------------------------------------------------------------*/
+void LoupeVue::restaurer(cv::Mat &src, cv::Mat &dest, cv::Rect r)
+{
+	r = r & cv::Rect(0, 0, src.cols, src.rows);
+	if (r.area() == 0) return;
+	cv::Mat d = dest(r);
+	src(r).copyTo(d);
+}
+
+void LoupeVue::dessiner_rect(cv::Mat &src, cv::Mat &dest)
+{
+	if (src.data != ancienne_src || dest.data != ancienne_dest ||
+		dest.rows != src.rows || dest.cols != src.cols || dest.type() != src.type())
+	{
+		src.copyTo(dest);
+	}
+	else if (rect_dessine)
+	{
+		// Le trait d'épaisseur 3 déborde d'un pixel de chaque côté
+		// des bords : on restaure des bandes de 5 pixels
+		int x0 = ancien_rect.x, y0 = ancien_rect.y;
+		int x1 = x0 + ancien_rect.width, y1 = y0 + ancien_rect.height;
+		restaurer(src, dest, cv::Rect(x0-2, y0-2, x1-x0+5, 5));
+		restaurer(src, dest, cv::Rect(x0-2, y1-2, x1-x0+5, 5));
+		restaurer(src, dest, cv::Rect(x0-2, y0-2, 5, y1-y0+5));
+		restaurer(src, dest, cv::Rect(x1-2, y0-2, 5, y1-y0+5));
+	}
+	ancienne_src = src.data;
+	ancienne_dest = dest.data;
+	rect_dessine = false;
+
+	if (zoom == 0) return;
+	cv::Point p0 = cv::Point(zoom_x0, zoom_y0),
+			  p1 = cv::Point(zoom_x1, zoom_y1);
+	cv::rectangle(dest, p0, p1, cv::Scalar (255, 255, 255), 3, 4);
+	cv::rectangle(dest, p0, p1, cv::Scalar (  0,   0, 255), 1, 4);
+	ancien_rect = cv::Rect(zoom_x0, zoom_y0, zoom_x1 - zoom_x0, zoom_y1 - zoom_y0);
+	rect_dessine = true;
+}
+
+void LoupeVue::dessiner_portion(cv::Mat &src, cv::Mat &dest)
+{
+	if (src.type() != CV_8UC3)
+		throw runtime_error(string(__func__) + ": format non géré '" +
+			to_string(src.type()) + "' pour la matrice 'src'");
+
+	int z = bon_zoom();
+
+	// Pixels de la source couverts par la loupe, et leur place dans @dest
+	cv::Rect vue = cv::Rect(zoom_x0, zoom_y0, (dest.cols + z-1) / z, (dest.rows + z-1) / z)
+		& cv::Rect(0, 0, src.cols, src.rows);
+	int dx = (vue.x - zoom_x0) * z, dy = (vue.y - zoom_y0) * z;
+	int w = min(dest.cols - dx, vue.width * z);
+	int h = min(dest.rows - dy, vue.height * z);
+
+	if (vue.area() == 0 || w <= 0 || h <= 0) {
+		dest.setTo(cv::Scalar(LOUPE_GRIS_HORS_IMAGE, LOUPE_GRIS_HORS_IMAGE, LOUPE_GRIS_HORS_IMAGE));
+		return;
+	}
+	if (dx > 0 || dy > 0 || w < dest.cols || h < dest.rows)
+		dest.setTo(cv::Scalar(LOUPE_GRIS_HORS_IMAGE, LOUPE_GRIS_HORS_IMAGE, LOUPE_GRIS_HORS_IMAGE));
+
+	// Taille exactement multiple de la portion : le pixel (x, y) de
+	// tampon vient du pixel (x / z, y / z) de la portion
+	cv::resize(src(vue), tampon, cv::Size(vue.width * z, vue.height * z), 0, 0, cv::INTER_NEAREST);
+	cv::Mat d = dest(cv::Rect(dx, dy, w, h));
+	tampon(cv::Rect(0, 0, w, h)).copyTo(d);
+}
@@ -0,0 +1,71 @@
+#ifndef LOUPE_VUE_H
+#define LOUPE_VUE_H
+
+#include <iostream>
+#include <cstring>
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Loupe des TP : un rectangle (zoom_x0..zoom_x1, zoom_y0..
+ * zoom_y1) de l'image, dessiné sur la vue générale et agrandi
+ * d'un facteur zoom dans la fenêtre "Loupe".
+ *
+ * dessiner_rect ne recopie toute l'image que si la source ou
+ * la destination ont changé depuis l'appel précédent ; sinon la
+ * destination est supposée égale à la source hors du rectangle
+ * déjà dessiné, et seules les bandes de cet ancien rectangle
+ * sont restaurées avant de tracer le nouveau. Déplacer la loupe
+ * sur une image de 100 Mpixels ne coûte donc que le périmètre
+ * du rectangle.
+ *
+ * dessiner_portion agrandit la portion visible par un seul
+ * cv::resize en INTER_NEAREST (zoom entier : chaque pixel de
+ * la source devient un carré zoom x zoom), au lieu d'une copie
+ * pixel par pixel.
+ *
+ * Les anciennes versions des TP gardent leur propre classe
+ * Loupe et sont liées avec les mêmes objets de commun, d'où
+ * un nom distinct.
+ * ------------------------------------------------------------*/
+
+const int LOUPE_GRIS_HORS_IMAGE = 64;	// fond de la loupe hors de l'image
+
+class LoupeVue
+{
+public:
+
+	int zoom = 5;
+	int zoom_max = 20;
+	int zoom_x0 = 0;
+	int zoom_y0 = 0;
+	int zoom_x1 = 100;
+	int zoom_y1 = 100;
+
+	LoupeVue();
+	~LoupeVue();
+
+	void reborner(cv::Mat &res1, cv::Mat &res2);
+	void deplacer(cv::Mat &res1, cv::Mat &res2, int dx, int dy);
+	void dessiner_rect(cv::Mat &src, cv::Mat &dest);
+	void dessiner_portion(cv::Mat &src, cv::Mat &dest);
+	cv::Rect _portion();	// pixels de la source visibles dans la loupe
+
+private:
+
+	int bon_zoom();
+	void restaurer(cv::Mat &src, cv::Mat &dest, cv::Rect r);
+
+	// Dernier rectangle tracé par dessiner_rect, et les images
+	// sur lesquelles il l'a été
+	bool rect_dessine;
+	cv::Rect ancien_rect;
+	const uchar *ancienne_src, *ancienne_dest;
+
+	cv::Mat tampon;		// portion agrandie, avant découpe
+};
+
+#endif // LOUPE_VUE_H
@@ -0,0 +1,45 @@
+#include "MarquageContours.h"
+
+void marquer_contours (ImageView<int> img_niv, int connexite)
+{
+	int rows = img_niv._rows(), cols = img_niv._cols();
+	if (rows == 0 || cols == 0) return;
+
+	vector<int> copie(cols);
+	for (int y = 0; y < rows; y++)
+	{
+		int *l = img_niv.ligne(y);
+
+		// Le bord de l'image est toujours contour
+		if (y == 0 || y == rows-1 || cols <= 2)
+		{
+			for (int x = 0; x < cols; x++) if (l[x] != 0) l[x] = 1;
+			continue;
+		}
+		if (l[0] != 0) l[0] = 1;
+		if (l[cols-1] != 0) l[cols-1] = 1;
+
+		const int *h = img_niv.ligne(y-1), *b = img_niv.ligne(y+1);
+		const int *c = copie.data();
+		memcpy(copie.data(), l, cols * sizeof(int));
+
+		if (connexite == 8)
+		{
+			for (int x = 1; x < cols-1; x++)
+			{
+				bool fond = c[x-1] == 0 || c[x+1] == 0 || h[x] == 0 || b[x] == 0;
+				l[x] = (c[x] != 0 && fond) ? 1 : c[x];
+			}
+		}
+		else
+		{
+			for (int x = 1; x < cols-1; x++)
+			{
+				bool fond = c[x-1] == 0 || c[x+1] == 0 ||
+							h[x-1] == 0 || h[x] == 0 || h[x+1] == 0 ||
+							b[x-1] == 0 || b[x] == 0 || b[x+1] == 0;
+				l[x] = (c[x] != 0 && fond) ? 1 : c[x];
+			}
+		}
+	}
+}
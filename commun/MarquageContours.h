@@ -0,0 +1,30 @@
+#ifndef MARQUAGE_CONTOURS_H
+#define MARQUAGE_CONTOURS_H
+
+#include <iostream>
+#include <cstring>
+#include <opencv2/opencv.hpp>
+
+#include "ImageView.h"
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Marquage des points contour (TP1) : un pixel de la forme
+ * (!= 0) qui touche le fond ou le bord de l'image prend
+ * l'étiquette 1.
+ *
+ * connexite = 8 : contour 8-connexe, on regarde les 4-voisins ;
+ * connexite = 4 : contour 4-connexe, on regarde les 8-voisins.
+ *
+ * Le marquage se fait sur place ligne par ligne : il ne change
+ * que des pixels non nuls en 1, donc jamais le résultat des
+ * tests "== 0" des lignes voisines. La ligne courante est lue
+ * dans une copie, ce qui rend la boucle interne sans dépendance
+ * (vectorisable). Les lignes et colonnes du bord sont traitées
+ * à part : la boucle interne n'a aucun test de sortie d'image.
+ * ------------------------------------------------------------*/
+void marquer_contours (ImageView<int> img_niv, int connexite);
+
+#endif // MARQUAGE_CONTOURS_H
@@ -0,0 +1,65 @@
+#include "NiveauxSedt.h"
+
+const uint8_t *table_racines()
+{
+	static const vector<uint8_t> table = []()
+	{
+		vector<uint8_t> t(1 << NIVEAUX_TABLE_BITS);
+		int r = 0;
+		for (unsigned i = 0; i < t.size(); i++)
+		{
+			if (unsigned(r+1) * (r+1) <= i) r++;
+			t[i] = r;
+		}
+		return t;
+	}();
+	return table.data();
+}
+
+void calculer_niveaux_sedt (ImageView<int> img_sedt, NiveauxSedt &niveaux, bool listes)
+{
+	int rows = img_sedt._rows(), cols = img_sedt._cols();
+	niveaux.niveau_max = 0;
+	niveaux.pos_max = cv::Point(0, 0);
+	niveaux.debut.clear();
+	niveaux.pixels.clear();
+
+	vector<int> compte;
+	for (int y = 0; y < rows; y++)
+	{
+		int *l = img_sedt.ligne(y);
+		for (int x = 0; x < cols; x++)
+		{
+			if (l[x] <= 0) continue;
+			int r = racine_entiere(l[x]);
+			l[x] = r;
+			if (r > niveaux.niveau_max)
+			{
+				niveaux.niveau_max = r;
+				niveaux.pos_max = cv::Point(x, y);
+			}
+			if (listes)
+			{
+				if (r >= int(compte.size())) compte.resize(r+1, 0);
+				compte[r]++;
+			}
+		}
+	}
+	if (!listes) return;
+
+	// Tri par dénombrement : debut[] par sommes cumulées, puis une
+	// seconde lecture des niveaux (plus de racine à calculer)
+	compte.resize(niveaux.niveau_max + 1, 0);
+	niveaux.debut.assign(compte.size() + 1, 0);
+	for (unsigned r = 0; r < compte.size(); r++)
+		niveaux.debut[r+1] = niveaux.debut[r] + compte[r];
+	niveaux.pixels.resize(niveaux.debut.back());
+
+	vector<int> suivant(niveaux.debut.begin(), niveaux.debut.end() - 1);
+	for (int y = 0; y < rows; y++)
+	{
+		const int *l = img_sedt.ligne(y);
+		for (int x = 0; x < cols; x++)
+			if (l[x] > 0) niveaux.pixels[suivant[l[x]]++] = y * cols + x;
+	}
+}
@@ -0,0 +1,62 @@
+#ifndef NIVEAUX_SEDT_H
+#define NIVEAUX_SEDT_H
+
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+
+#include "ImageView.h"
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Courbes de niveau d'une SEDT (voir Sedt.h) : chaque pixel de
+ * la forme (d2 > 0) reçoit son rayon entier r = floor(sqrt(d2)),
+ * en entiers seulement.
+ *
+ * racine_entiere() lit une table des racines des 2^16 premiers
+ * entiers. Au delà, on prend la racine de d2 >> 2k dans la
+ * table, décalée de k bits, puis on fixe les k bits du bas un
+ * à un (r + 2^b)^2 <= d2 : au plus 8 tests pour un int.
+ *
+ * La même passe trouve le niveau maximal et son premier pixel
+ * en ordre de balayage (le centre de Contour::get_centre()), et
+ * peut ranger les pixels par niveau pour étudier les anneaux de
+ * distance : ceux du niveau r sont les indices y*cols + x de
+ * pixels[debut[r] .. debut[r+1]-1], en ordre de balayage.
+ * ------------------------------------------------------------*/
+
+const int NIVEAUX_TABLE_BITS = 16;		// table de 2^16 racines (64 Kio)
+
+struct NiveauxSedt
+{
+	int niveau_max;			// 0 si la forme est vide
+	cv::Point pos_max;		// premier pixel de niveau niveau_max
+	vector<int> debut;		// remplis si on demande les listes
+	vector<int> pixels;
+};
+
+const uint8_t *table_racines();
+
+inline int racine_entiere (uint32_t d2)
+{
+	const uint8_t *table = table_racines();
+	if (d2 < (1u << NIVEAUX_TABLE_BITS)) return table[d2];
+
+	int k = (32 - __builtin_clz(d2) - NIVEAUX_TABLE_BITS + 1) / 2;
+	uint32_t r = uint32_t(table[d2 >> (2*k)]) << k;
+	for (int b = k-1; b >= 0; b--)
+	{
+		uint32_t essai = r | (1u << b);
+		if (uint64_t(essai) * essai <= d2) r = essai;
+	}
+	return r;
+}
+
+// Sur place : img_sedt (CV_32SC1) devient l'image des niveaux
+void calculer_niveaux_sedt (ImageView<int> img_sedt, NiveauxSedt &niveaux,
+	bool listes = false);
+
+#endif // NIVEAUX_SEDT_H
@@ -0,0 +1,143 @@
+#include "PoolThreads.h"
+
+//------------------- C L A S S E     P O O L T H R E A D S --------------------
+
+PoolThreads::PoolThreads (int nb_threads) :
+	nb_threads(nb_threads < 1 ? 1 : nb_threads),
+	files(this->nb_threads),
+	mutex_files(this->nb_threads),
+	tache(nullptr),
+	restant(0),
+	generation(0),
+	arret(false)
+{
+	// Le thread appelant travaille aussi : il a le numéro 0
+	for (int num = 1; num < this->nb_threads; num++)
+		threads.push_back(thread(&PoolThreads::boucle_thread, this, num));
+}
+
+PoolThreads::~PoolThreads()
+{
+	{
+		unique_lock<mutex> verrou(m);
+		arret = true;
+	}
+	cv_debut.notify_all();
+	for (unsigned i = 0; i < threads.size(); i++) threads[i].join();
+}
+
+int PoolThreads::_nb_threads() {	return nb_threads;	}
+
+/*--------------------------------------------------------------
+ * Prend un morceau au début de sa propre file, sinon en vole
+ * un à la fin de la file d'un autre thread.
+ * ------------------------------------------------------------*/
+bool PoolThreads::prendre_morceau(int num, pair<int, int> &morceau)
+{
+	for (int i = 0; i < nb_threads; i++)
+	{
+		int victime = (num + i) % nb_threads;
+		lock_guard<mutex> verrou(mutex_files[victime]);
+		deque<pair<int, int> > &file = files[victime];
+		if (file.empty()) continue;
+		if (i == 0) { morceau = file.front(); file.pop_front(); }
+		else		{ morceau = file.back();  file.pop_back(); }
+		return true;
+	}
+	return false;
+}
+
+void PoolThreads::boucle_thread(int num)
+{
+	int vue = 0;
+	for (;;)
+	{
+		{
+			unique_lock<mutex> verrou(m);
+			cv_debut.wait(verrou, [&] { return arret || generation != vue; });
+			if (arret) return;
+			vue = generation;
+		}
+
+		pair<int, int> morceau;
+		while (prendre_morceau(num, morceau))
+		{
+			(*tache)(morceau.first, morceau.second, num);
+			if (--restant == 0)
+			{
+				lock_guard<mutex> verrou(m);
+				cv_fin.notify_all();
+			}
+		}
+	}
+}
+
+void PoolThreads::parallel_for(int debut, int fin, int grain,
+	const function<void(int, int, int)> &f)
+{
+	if (fin <= debut) return;
+	if (grain < 1) grain = 1;
+
+	if (nb_threads == 1 || fin - debut <= grain)
+	{
+		f(debut, fin, 0);
+		return;
+	}
+
+	// tache et restant sont fixés avant de publier les morceaux : un
+	// thread encore dans la boucle de l'appel précédent peut voler un
+	// morceau dès qu'il est dans une file, et décrémenter restant
+	int nb_morceaux = (int)(((long long)fin - debut + grain - 1) / grain);
+	{
+		unique_lock<mutex> verrou(m);
+		tache = &f;
+		restant = nb_morceaux;
+		for (int i = 0; i < nb_morceaux; i++)
+		{
+			int a = debut + i * grain;
+			lock_guard<mutex> verrou_file(mutex_files[i % nb_threads]);
+			files[i % nb_threads].push_back(make_pair(a, min(a + grain, fin)));
+		}
+		generation++;
+	}
+	cv_debut.notify_all();
+
+	pair<int, int> morceau;
+	while (prendre_morceau(0, morceau))
+	{
+		f(morceau.first, morceau.second, 0);
+		--restant;
+	}
+
+	unique_lock<mutex> verrou(m);
+	cv_fin.wait(verrou, [&] { return restant == 0; });
+	tache = nullptr;
+}
+
+//------------------------ P O O L    P A R T A G E ----------------------------
+
+static PoolThreads *g_pool = nullptr;
+static thread_local PoolThreads *g_pool_local = nullptr;
+
+void definir_nb_threads(int nb_threads)
+{
+	if (nb_threads < 1) nb_threads = 1;
+	if (g_pool && g_pool->_nb_threads() == nb_threads) return;
+	delete g_pool;
+	g_pool = new PoolThreads(nb_threads);
+}
+
+void definir_pool_local(PoolThreads *pool)
+{
+	g_pool_local = pool;
+}
+
+/*--------------------------------------------------------------
+ * Par défaut, un thread par coeur.
+ * ------------------------------------------------------------*/
+PoolThreads &pool_threads()
+{
+	if (g_pool_local) return *g_pool_local;
+	if (!g_pool) definir_nb_threads(thread::hardware_concurrency());
+	return *g_pool;
+}
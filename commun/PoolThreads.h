@@ -0,0 +1,68 @@
+#ifndef POOL_THREADS_H
+#define POOL_THREADS_H
+
+#include <iostream>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Pool de threads avec vol de travail.
+ *
+ * parallel_for(debut, fin, grain, f) découpe [debut, fin[ en
+ * morceaux d'au plus @grain indices, répartis dans la file de
+ * chaque thread. Un thread qui a vidé sa file vole les morceaux
+ * restants à la fin de la file des autres. L'appel est bloquant.
+ *
+ * f(a, b, num) traite [a, b[ ; num (0 <= num < _nb_threads())
+ * identifie le thread, pour réutiliser un tampon par thread.
+ *
+ * Un seul parallel_for à la fois par pool : ni deux threads qui
+ * l'appellent en même temps, ni un appel depuis f : des threads
+ * qui calculent en parallèle ont chacun leur pool.
+ * ------------------------------------------------------------*/
+class PoolThreads
+{
+public:
+
+	PoolThreads (int nb_threads);
+	~PoolThreads();
+
+	int _nb_threads();
+	void parallel_for(int debut, int fin, int grain,
+		const function<void(int, int, int)> &f);
+
+private:
+
+	int nb_threads;
+	vector<thread> threads;
+	vector<deque<pair<int, int> > > files;
+	vector<mutex> mutex_files;
+
+	mutex m;
+	condition_variable cv_debut, cv_fin;
+	const function<void(int, int, int)> *tache;
+	atomic<int> restant;
+	int generation;
+	bool arret;
+
+	bool prendre_morceau(int num, pair<int, int> &morceau);
+	void boucle_thread(int num);
+};
+
+// Pool partagé par les TP, de taille réglée par --threads
+PoolThreads &pool_threads();
+void definir_nb_threads(int nb_threads);
+
+// Pool propre au thread appelant, rendu par pool_threads() à sa
+// place (NULL pour revenir au pool partagé) : en mode --batch,
+// chaque thread de calcul traite sa propre image
+void definir_pool_local(PoolThreads *pool);
+
+#endif // POOL_THREADS_H
@@ -0,0 +1,124 @@
+#include "RenduTuiles.h"
+
+//------------------- C L A S S E     R E N D U T U I L E S -------------------
+
+RenduTuiles::RenduTuiles (int taille) :
+	taille(taille < 1 ? 1 : taille), rows(0), cols(0), nb_tx(0), nb_ty(0),
+	restantes(0), curseur(0)
+{
+	;
+}
+
+RenduTuiles::~RenduTuiles()
+{
+	;
+}
+
+bool RenduTuiles::_complet() {	return restantes == 0;	}
+
+cv::Rect RenduTuiles::tuile(int t)
+{
+	int x = (t % nb_tx) * taille, y = (t / nb_tx) * taille;
+	return cv::Rect(x, y, min(taille, cols - x), min(taille, rows - y));
+}
+
+void RenduTuiles::lancer(int rows, int cols, const function<void(cv::Rect)> &rendre)
+{
+	this->rows = rows;
+	this->cols = cols;
+	this->rendre = rendre;
+	nb_tx = (cols + taille-1) / taille;
+	nb_ty = (rows + taille-1) / taille;
+	faite.assign(nb_tx * nb_ty, 0);
+	restantes = nb_tx * nb_ty;
+	ordre.clear();
+	curseur = 0;
+}
+
+/*--------------------------------------------------------------
+ * Les tuiles sont réparties une par une sur le pool : elles
+ * sont assez grosses pour que le découpage ne coûte rien.
+ * ------------------------------------------------------------*/
+void RenduTuiles::rendre_tuiles(const vector<int> &tuiles)
+{
+	if (tuiles.empty()) return;
+	pool_threads().parallel_for(0, tuiles.size(), 1, [&](int a, int b, int)
+	{
+		for (int i = a; i < b; i++) rendre(tuile(tuiles[i]));
+	});
+	for (unsigned i = 0; i < tuiles.size(); i++) faite[tuiles[i]] = 1;
+	restantes -= tuiles.size();
+}
+
+void RenduTuiles::exiger(cv::Rect roi)
+{
+	derniere_roi = roi;
+	roi = roi & cv::Rect(0, 0, cols, rows);
+	if (restantes == 0 || roi.area() == 0) return;
+
+	vector<int> tuiles;
+	for (int ty = roi.y / taille; ty <= (roi.y + roi.height - 1) / taille; ty++)
+	for (int tx = roi.x / taille; tx <= (roi.x + roi.width - 1) / taille; tx++)
+	{
+		int t = ty * nb_tx + tx;
+		if (!faite[t]) tuiles.push_back(t);
+	}
+	rendre_tuiles(tuiles);
+}
+
+/*--------------------------------------------------------------
+ * Tuiles restantes triées par distance (en tuiles) à la
+ * dernière roi exigée : le remplissage part de la loupe.
+ * ------------------------------------------------------------*/
+void RenduTuiles::ordonner()
+{
+	int cx = (derniere_roi.x + derniere_roi.width / 2) / taille;
+	int cy = (derniere_roi.y + derniere_roi.height / 2) / taille;
+
+	vector<pair<int, int> > dist;
+	for (int t = 0; t < nb_tx * nb_ty; t++)
+	{
+		if (faite[t]) continue;
+		int d = max(abs(t % nb_tx - cx), abs(t / nb_tx - cy));
+		dist.push_back(make_pair(d, t));
+	}
+	sort(dist.begin(), dist.end());
+
+	ordre.resize(dist.size());
+	for (unsigned i = 0; i < dist.size(); i++) ordre[i] = dist[i].second;
+	curseur = 0;
+	roi_ordre = derniere_roi;
+}
+
+bool RenduTuiles::avancer(double budget_ms)
+{
+	if (restantes == 0) return false;
+
+	bool ordre_change = roi_ordre.x != derniere_roi.x || roi_ordre.y != derniere_roi.y ||
+		roi_ordre.width != derniere_roi.width || roi_ordre.height != derniere_roi.height;
+	if (ordre.empty() || ordre_change) ordonner();
+
+	auto debut = chrono::steady_clock::now();
+	int lot = pool_threads()._nb_threads();
+	vector<int> tuiles;
+	while (restantes > 0)
+	{
+		tuiles.clear();
+		while (curseur < (int) ordre.size() && (int) tuiles.size() < lot)
+		{
+			int t = ordre[curseur++];
+			if (!faite[t]) tuiles.push_back(t);
+		}
+		if (tuiles.empty()) break;
+		rendre_tuiles(tuiles);
+
+		chrono::duration<double, milli> ecoule = chrono::steady_clock::now() - debut;
+		if (ecoule.count() >= budget_ms) break;
+	}
+	return true;
+}
+
+void RenduTuiles::terminer()
+{
+	exiger(cv::Rect(0, 0, cols, rows));
+}
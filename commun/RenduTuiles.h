@@ -0,0 +1,68 @@
+#ifndef RENDU_TUILES_H
+#define RENDU_TUILES_H
+
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <opencv2/opencv.hpp>
+
+#include "PoolThreads.h"
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Rendu paresseux par tuiles des étapes pixel à pixel de la
+ * boucle interactive (couleurs VGA, recopie dans la vue
+ * générale), pour parcourir de très grandes images.
+ *
+ * lancer() ne calcule rien : il note la fonction de rendu
+ * d'une tuile et marque toutes les tuiles à refaire.
+ * exiger(roi) calcule aussitôt, en parallèle, les tuiles qui
+ * touchent roi (la portion sous la loupe) ; avancer(budget)
+ * calcule les tuiles restantes pendant au plus budget ms, les
+ * plus proches de la dernière roi exigée d'abord. La boucle
+ * d'événements appelle avancer() à chaque tour : le reste de
+ * l'image se remplit en tâche de fond sans bloquer l'affichage.
+ *
+ * La fonction de rendu est appelée en même temps sur des tuiles
+ * différentes : elle ne doit écrire que dans sa tuile.
+ * ------------------------------------------------------------*/
+
+const int RENDU_TUILE = 256;			// côté d'une tuile
+const double RENDU_BUDGET_MS = 10.;	// temps de calcul par tour de boucle
+
+class RenduTuiles
+{
+public:
+
+	RenduTuiles (int taille = RENDU_TUILE);
+	~RenduTuiles();
+
+	void lancer(int rows, int cols, const function<void(cv::Rect)> &rendre);
+	void exiger(cv::Rect roi);
+	bool avancer(double budget_ms);
+	void terminer();
+	bool _complet();
+
+private:
+
+	int taille, rows, cols;
+	int nb_tx, nb_ty;			// nombre de tuiles en x et en y
+	vector<char> faite;
+	int restantes;
+	function<void(cv::Rect)> rendre;
+
+	// Ordre de calcul en tâche de fond, refait quand la roi change
+	vector<int> ordre;
+	int curseur;
+	cv::Rect roi_ordre, derniere_roi;
+
+	cv::Rect tuile(int t);
+	void rendre_tuiles(const vector<int> &tuiles);
+	void ordonner();
+};
+
+#endif // RENDU_TUILES_H
@@ -0,0 +1,296 @@
+#include "Sedt.h"
+
+//------------------------------ S E D T ---------------------------------------
+
+/*--------------------------------------------------------------
+ * Division entière arrondie vers -infini (@b > 0).
+ * ------------------------------------------------------------*/
+static long long div_inf (long long a, long long b)
+{
+	return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+/*--------------------------------------------------------------
+ * Enveloppe inférieure sur [0, @n[ des paraboles
+ * F_u(y) = (y - pos[u])^2 + f[u], u < @m, pos croissantes :
+ * la parabole s[k] est la plus basse sur [t[k], t[k+1][.
+ * Rend l'indice k du dernier morceau.
+ * ------------------------------------------------------------*/
+static int construire_enveloppe (const int *pos, const long long *f, int m, int n,
+	int *s, int *t)
+{
+	int q = 0;
+	s[0] = 0; t[0] = 0;
+	for (int u = 1; u < m; u++)
+	{
+		while (q >= 0)
+		{
+			long long a = t[q] - pos[s[q]], b = t[q] - pos[u];
+			if (a*a + f[s[q]] <= b*b + f[u]) break;
+			q--;
+		}
+		if (q < 0) { q = 0; s[0] = u; t[0] = 0; continue; }
+
+		long long pu = pos[u], pi = pos[s[q]];
+		long long w = 1 + div_inf(pu*pu - pi*pi + f[u] - f[s[q]], 2 * (pu - pi));
+		if (w < n) { q++; s[q] = u; t[q] = (int) w; }
+	}
+	return q;
+}
+
+/*--------------------------------------------------------------
+ * Pour chaque ligne de [@y_debut, @y_fin[, remplace chaque pixel
+ * de la forme par sa distance (non élevée au carré) au pixel du
+ * fond le plus proche sur la ligne, ou par SEDT_LIGNE_SANS_FOND.
+ * ------------------------------------------------------------*/
+void sedt_passe_lignes (cv::Mat img_niv, int y_debut, int y_fin, bool bord_est_fond)
+{
+	int infini = img_niv.cols + img_niv.rows + 1;
+
+	for (int y = y_debut; y < y_fin; y++)
+	{
+		int *l = img_niv.ptr<int>(y);
+
+		// gauche -> droite
+		int d = bord_est_fond ? 0 : infini;
+		for (int x = 0; x < img_niv.cols; x++)
+		{
+			if (l[x] <= 0)			d = 0;
+			else if (d < infini)	d++;
+			l[x] = d;
+		}
+		// droite -> gauche
+		d = bord_est_fond ? 0 : infini;
+		for (int x = img_niv.cols-1; x >= 0; x--)
+		{
+			if (l[x] == 0)			d = 0;
+			else if (d < infini)	d++;
+			if (d < l[x])			l[x] = d;
+			if (l[x] >= infini)		l[x] = SEDT_LIGNE_SANS_FOND;
+		}
+	}
+}
+
+/*--------------------------------------------------------------
+ * Pour chaque colonne de [@x_debut, @x_fin[, calcule l'enveloppe
+ * inférieure des paraboles F_i(y) = (y - i)^2 + g(i)^2, puis
+ * écrit en chaque y le minimum des F_i(y).
+ * ------------------------------------------------------------*/
+void sedt_passe_colonnes (cv::Mat img_niv, int x_debut, int x_fin, bool bord_est_fond,
+	TamponSedt &tampon)
+{
+	int n = img_niv.rows;
+	tampon.pos.resize(n + 2);
+	tampon.f.resize(n + 2);
+	tampon.s.resize(n + 2);
+	tampon.t.resize(n + 2);
+	int *pos = tampon.pos.data(), *s = tampon.s.data(), *t = tampon.t.data();
+	long long *f = tampon.f.data();
+
+	for (int x = x_debut; x < x_fin; x++)
+	{
+		// Sites de la colonne : les lignes qui ont du fond, plus les
+		// bords si l'extérieur de l'image est du fond
+		int m = 0;
+		if (bord_est_fond) { pos[m] = -1; f[m] = 0; m++; }
+		for (int y = 0; y < n; y++)
+		{
+			int g = img_niv.at<int>(y, x);
+			if (g == SEDT_LIGNE_SANS_FOND) continue;
+			pos[m] = y; f[m] = (long long) g * g; m++;
+		}
+		if (bord_est_fond) { pos[m] = n; f[m] = 0; m++; }
+
+		if (m == 0)
+		{
+			for (int y = 0; y < n; y++) img_niv.at<int>(y, x) = SEDT_INFINI;
+			continue;
+		}
+
+		int q = construire_enveloppe(pos, f, m, n, s, t);
+
+		// Balayage remontant : lecture de l'enveloppe
+		for (int y = n-1; y >= 0; y--)
+		{
+			long long dy = y - pos[s[q]];
+			long long d = dy*dy + f[s[q]];
+			img_niv.at<int>(y, x) = d < SEDT_INFINI ? (int) d : SEDT_INFINI;
+			if (y == t[q]) q--;
+		}
+	}
+}
+
+/*--------------------------------------------------------------
+ * Les 2 passes sont réparties sur le pool de threads : d'abord
+ * des paquets de lignes, puis des paquets de colonnes, avec un
+ * tampon de colonne par thread.
+ * ------------------------------------------------------------*/
+void calculer_sedt_meijster (cv::Mat img_niv, bool bord_est_fond)
+{
+	PoolThreads &pool = pool_threads();
+	vector<TamponSedt> tampons(pool._nb_threads());
+
+	pool.parallel_for(0, img_niv.rows, SEDT_GRAIN,
+		[&](int debut, int fin, int num) {
+			sedt_passe_lignes (img_niv, debut, fin, bord_est_fond);
+		});
+	pool.parallel_for(0, img_niv.cols, SEDT_GRAIN,
+		[&](int debut, int fin, int num) {
+			sedt_passe_colonnes (img_niv, debut, fin, bord_est_fond, tampons[num]);
+		});
+}
+
+//------------------- A X E   M E D I A N   E U C L I D I E N -------------------
+
+/*--------------------------------------------------------------
+ * Sur les @n cases de pas @pas de @src, prend les sites i de
+ * poids w_i = src[i] > 0 et écrit dans @dst le max des puissances
+ * w_i - (u - i)^2 s'il est > 0 (0 sinon), et dans @arg (si non
+ * nul) le site qui le donne (-1 sinon). C'est l'enveloppe
+ * inférieure des paraboles (u - i)^2 - w_i ; @dst peut être @src.
+ * ------------------------------------------------------------*/
+static void enveloppe_puissance (const int *src, int *dst, int *arg, int n, size_t pas,
+	TamponSedt &tampon)
+{
+	tampon.pos.resize(n);
+	tampon.f.resize(n);
+	tampon.s.resize(n);
+	tampon.t.resize(n);
+	int *pos = tampon.pos.data(), *s = tampon.s.data(), *t = tampon.t.data();
+	long long *f = tampon.f.data();
+
+	int m = 0;
+	for (int i = 0; i < n; i++)
+	{
+		int w = src[i * pas];
+		if (w > 0) { pos[m] = i; f[m] = -(long long) w; m++; }
+	}
+	if (m == 0)
+	{
+		for (int u = 0; u < n; u++) {
+			dst[u * pas] = 0;
+			if (arg) arg[u * pas] = -1;
+		}
+		return;
+	}
+
+	int q = construire_enveloppe(pos, f, m, n, s, t);
+	for (int u = n-1; u >= 0; u--)
+	{
+		long long du = u - pos[s[q]];
+		long long p = -f[s[q]] - du*du;
+		dst[u * pas] = p > 0 ? (int) p : 0;
+		if (arg) arg[u * pas] = p > 0 ? pos[s[q]] : -1;
+		if (u == t[q]) q--;
+	}
+}
+
+/*--------------------------------------------------------------
+ * Puissance max des boules de @src (rayon^2 > 0 au centre), par
+ * lignes puis par colonnes dans @dst ; si @arg_x et @arg_y ne
+ * sont pas vides, arg_y(y, x) reçoit la ligne du centre qui la
+ * donne et arg_x(y, x) sa colonne pour la ligne y.
+ * ------------------------------------------------------------*/
+static void calculer_puissances (cv::Mat src, cv::Mat dst, cv::Mat arg_x, cv::Mat arg_y)
+{
+	PoolThreads &pool = pool_threads();
+	vector<TamponSedt> tampons(pool._nb_threads());
+	bool args = !arg_x.empty();
+	size_t pas = dst.step / sizeof(int);
+
+	pool.parallel_for(0, src.rows, SEDT_GRAIN,
+		[&](int debut, int fin, int num) {
+			for (int y = debut; y < fin; y++)
+				enveloppe_puissance(src.ptr<int>(y), dst.ptr<int>(y),
+					args ? arg_x.ptr<int>(y) : nullptr, src.cols, 1, tampons[num]);
+		});
+	pool.parallel_for(0, src.cols, SEDT_GRAIN,
+		[&](int debut, int fin, int num) {
+			for (int x = debut; x < fin; x++)
+				enveloppe_puissance(dst.ptr<int>(0) + x, dst.ptr<int>(0) + x,
+					args ? arg_y.ptr<int>(0) + x : nullptr, src.rows, pas, tampons[num]);
+		});
+}
+
+/*--------------------------------------------------------------
+ * REDT : chaque pixel reçoit max(r^2 - |p - c|^2) sur les boules
+ * de centre c et de rayon^2 r^2 = img_niv(c) > 0, ou 0 s'il
+ * n'est dans aucune. Avec toute la SEDT, ou son axe médian
+ * (axe_median_sedt), la forme est exactement l'ensemble des
+ * pixels > 0.
+ * ------------------------------------------------------------*/
+void calculer_redt_meijster (cv::Mat img_niv)
+{
+	calculer_puissances(img_niv, img_niv, cv::Mat(), cv::Mat());
+}
+
+/*--------------------------------------------------------------
+ * Axe médian réduit exact (Coeurjolly et Montanvert) : chaque
+ * pixel de la forme est rattaché, comme dans la REDT, à la
+ * boule de la SEDT de plus grande puissance ; les centres des
+ * boules qui gagnent au moins un pixel forment l'axe. Une boule
+ * incluse dans une autre ne gagne jamais : l'axe ne garde que
+ * des boules maximales (à égalité près), et sa REDT redonne
+ * exactement la forme.
+ * Entrée : une SEDT ; sortie : la SEDT sur l'axe, 0 ailleurs.
+ * ------------------------------------------------------------*/
+void axe_median_sedt (cv::Mat img_niv)
+{
+	int rows = img_niv.rows, cols = img_niv.cols;
+	cv::Mat puissances(rows, cols, CV_32SC1), arg_x(rows, cols, CV_32SC1),
+		arg_y(rows, cols, CV_32SC1);
+	calculer_puissances(img_niv, puissances, arg_x, arg_y);
+
+	vector<uchar> centre((size_t) rows * cols, 0);
+	for (int y = 0; y < rows; y++)
+	{
+		const int *l = img_niv.ptr<int>(y), *ay = arg_y.ptr<int>(y);
+		for (int x = 0; x < cols; x++)
+		{
+			if (l[x] <= 0) continue;
+			int cy = ay[x], cx = arg_x.at<int>(cy, x);
+			centre[(size_t) cy * cols + cx] = 1;
+		}
+	}
+
+	for (int y = 0; y < rows; y++)
+	{
+		int *l = img_niv.ptr<int>(y);
+		const uchar *c = &centre[(size_t) y * cols];
+		for (int x = 0; x < cols; x++)
+			if (!c[x]) l[x] = 0;
+	}
+}
+
+/*--------------------------------------------------------------
+ * Comme filtrer_axe_median_chanfrein (Chanfrein.h), en distance
+ * euclidienne : axe médian de @img_sedt, boules de rayon >
+ * @filtre, REDT, puis en couleurs dans @img_niv, avec les
+ * couleurs CHANFREIN_COUL_* de Chanfrein.h : 0 fond, centres
+ * gardés, forme retrouvée, forme perdue.
+ * ------------------------------------------------------------*/
+void filtrer_axe_median_sedt (cv::Mat img_niv, cv::Mat img_sedt, int filtre)
+{
+	cv::Mat axe = img_sedt.clone();
+	axe_median_sedt(axe);
+
+	long long f2 = (long long) filtre * filtre;
+	for (int y = 0; y < axe.rows; y++)
+	{
+		int *l = axe.ptr<int>(y);
+		for (int x = 0; x < axe.cols; x++)
+			if (l[x] <= f2) l[x] = 0;
+	}
+
+	cv::Mat redt = axe.clone();
+	calculer_redt_meijster(redt);
+
+	for (int y = 0; y < axe.rows; y++)
+	{
+		const int *s = img_sedt.ptr<int>(y), *a = axe.ptr<int>(y), *r = redt.ptr<int>(y);
+		int *d = img_niv.ptr<int>(y);
+		for (int x = 0; x < axe.cols; x++)
+			d[x] = s[x] <= 0 ? 0 : a[x] > 0 ? CHANFREIN_COUL_MAX
+				: r[x] > 0 ? CHANFREIN_COUL_RDT : CHANFREIN_COUL_PERDU;
+	}
+}
@@ -0,0 +1,59 @@
+#ifndef SEDT_H
+#define SEDT_H
+
+#include <iostream>
+#include <cstring>
+#include <opencv2/opencv.hpp>
+
+#include "Chanfrein.h"
+#include "PoolThreads.h"
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Transformée en distance euclidienne au carré (SEDT) exacte,
+ * en temps linéaire (Meijster / Felzenszwalb).
+ *
+ * L'image est en CV_32SC1 : la forme est l'ensemble des pixels
+ * de valeur > 0, le fond les pixels à 0. Chaque pixel de la
+ * forme reçoit le carré de sa distance au pixel du fond le plus
+ * proche. Si @bord_est_fond est vrai, l'extérieur de l'image
+ * compte comme du fond (comme dans la classe Contour).
+ *
+ * 1ere passe : distance 1D sur chaque ligne.
+ * 2e passe   : enveloppe inférieure des paraboles
+ *              (y-i)^2 + g(i)^2 sur chaque colonne.
+ * Les lignes (puis les colonnes) sont indépendantes : chaque
+ * passe est découpée en intervalles [debut, fin[ répartis sur
+ * le pool de threads (voir PoolThreads.h).
+ * ------------------------------------------------------------*/
+
+const int SEDT_INFINI = 2147483647;	// aucun pixel du fond atteignable
+const int SEDT_GRAIN = 16;			// lignes ou colonnes par morceau parallèle
+const int SEDT_LIGNE_SANS_FOND = -1;	// entre les 2 passes : ligne sans pixel du fond
+
+// Tampons d'une colonne, à réutiliser d'une colonne à l'autre
+struct TamponSedt
+{
+	vector<int> pos;			// position des paraboles (sites)
+	vector<long long> f;		// hauteur des paraboles : g(i)^2
+	vector<int> s, t;			// pile des sites et début de leur zone
+};
+
+void sedt_passe_lignes (cv::Mat img_niv, int y_debut, int y_fin, bool bord_est_fond);
+void sedt_passe_colonnes (cv::Mat img_niv, int x_debut, int x_fin, bool bord_est_fond,
+	TamponSedt &tampon);
+void calculer_sedt_meijster (cv::Mat img_niv, bool bord_est_fond);
+
+/*--------------------------------------------------------------
+ * Axe médian et REDT euclidiens exacts : les mêmes enveloppes de
+ * paraboles, en cherchant la plus grande puissance r^2 - d^2 des
+ * boules au lieu de la plus petite distance au fond ; linéaires
+ * et parallèles comme la SEDT.
+ * ------------------------------------------------------------*/
+void calculer_redt_meijster (cv::Mat img_niv);
+void axe_median_sedt (cv::Mat img_niv);
+void filtrer_axe_median_sedt (cv::Mat img_niv, cv::Mat img_sedt, int filtre);
+
+#endif // SEDT_H
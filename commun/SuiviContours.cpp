@@ -0,0 +1,77 @@
+#include "SuiviContours.h"
+#include "Etiquetage.h"
+
+static bool dans_forme (ImageView<int> img_niv, int x, int y)
+{
+	return img_niv.dans_image(x, y) && img_niv(y, x) > 0;
+}
+
+static void suivre_un_contour (ImageView<int> img_niv, int xA, int yA, int dirA,
+	int num_contour, ContoursF8 *memo_contour)
+{
+	if (memo_contour) memo_contour->commencer_contour(xA, yA, dirA);
+
+	// Direction d'arrivée sur A : premier voisin de la forme en
+	// tournant dans le sens croissant à partir de dirA
+	int dir_finale = -1;
+	for (int i = 0; i < 8; i++)
+	{
+		int d = (dirA + i) % 8;
+		if (dans_forme(img_niv, xA + FREEMAN_DX[d], yA + FREEMAN_DY[d]))
+		{
+			dir_finale = (d + 4) % 8;
+			break;
+		}
+	}
+	if (dir_finale < 0)				// point isolé
+	{
+		img_niv(yA, xA) = num_contour;
+		return;
+	}
+
+	int x = xA, y = yA, dir = dir_finale;
+	do
+	{
+		img_niv(y, x) = num_contour;
+		dir = (dir + 4 - 1) % 8;
+		for (int i = 0; i < 8; i++)
+		{
+			int d = (dir + 8 - i) % 8;
+			if (dans_forme(img_niv, x + FREEMAN_DX[d], y + FREEMAN_DY[d]))
+			{
+				x += FREEMAN_DX[d];
+				y += FREEMAN_DY[d];
+				dir = d;
+				if (memo_contour) memo_contour->ajouter_direction(d);
+				break;
+			}
+		}
+	} while (!(x == xA && y == yA && dir == dir_finale));
+}
+
+static void suivre_tous (ImageView<int> img_niv, ContoursF8 *memo_contour)
+{
+	if (memo_contour) memo_contour->vider();
+
+	cv::Mat img(img_niv._rows(), img_niv._cols(), CV_32SC1, img_niv._data(), img_niv._pas());
+	Etiquetage etiq (img, 8);
+	vector<GermeContour> germes = etiq.germes_contours();
+
+	int num_contour = 1;
+	for (unsigned i = 0; i < germes.size(); i++)
+	{
+		suivre_un_contour(img_niv, germes[i].x, germes[i].y, germes[i].dir,
+			num_contour++, memo_contour);
+		if (num_contour == 255) num_contour++;
+	}
+}
+
+void suivre_contours_c8 (ImageView<int> img_niv)
+{
+	suivre_tous(img_niv, nullptr);
+}
+
+void suivre_contours_c8 (ImageView<int> img_niv, ContoursF8 &memo_contour)
+{
+	suivre_tous(img_niv, &memo_contour);
+}
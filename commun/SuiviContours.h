@@ -0,0 +1,32 @@
+#ifndef SUIVI_CONTOURS_H
+#define SUIVI_CONTOURS_H
+
+#include <iostream>
+#include <cstring>
+#include <opencv2/opencv.hpp>
+
+#include "ImageView.h"
+#include "ContoursF8.h"
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Suivi des contours 8-connexes des TP2 à TP4 : un contour par
+ * germe de Etiquetage::germes_contours() (contours extérieurs et
+ * trous), numérotés 1, 2, ... en sautant 255, la couleur de la
+ * forme. Chaque pixel suivi prend le numéro de son contour.
+ *
+ * Le suivi tourne autour du point courant dans le sens
+ * décroissant des directions de Freeman, en partant de la
+ * direction d'arrivée - 1, jusqu'à revenir sur le point de
+ * départ avec la direction d'arrivée initiale. Un point isolé
+ * (aucun 8-voisin dans la forme) est un contour de taille 0.
+ *
+ * Avec @memo_contour, les chaînes de Freeman sont aussi rangées
+ * dans le ContoursF8 (vidé au préalable).
+ * ------------------------------------------------------------*/
+void suivre_contours_c8 (ImageView<int> img_niv);
+void suivre_contours_c8 (ImageView<int> img_niv, ContoursF8 &memo_contour);
+
+#endif // SUIVI_CONTOURS_H
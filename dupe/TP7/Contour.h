@@ -5,6 +5,9 @@
 #include <cstring>
 #include <opencv2/opencv.hpp>
 
+#include "ImageView.h"
+#include "NiveauxSedt.h"
+
 #include <vector>
 using namespace std;
 
@@ -24,14 +27,10 @@ public:
 private:
 
 	cv::Mat &img_niv;
+	NiveauxSedt niveaux;		// rempli par calc_contours()
 
-	bool est_dans_image(cv::Mat img_niv, int x, int y);
-	int square_distance_euclid(cv::Point A, cv::Point B);
+	bool est_dans_image(ConstImageView<int> img_niv, int x, int y);
 
-	bool get_boundaries (cv::Mat img_niv, cv::Point P, cv::Point &B1, cv::Point &B2);
-	void sedt_balayageX();
-	int search_min_dist_square_of_col(cv::Mat myCol, int x, int y);
-	void sedt_balayageY();
 	void calculer_sedt_saito_toriwaki ();
 	void calculer_sedt_courbes_niveau ();
 };
@@ -0,0 +1,196 @@
+#include "ImageBinaire.h"
+
+//------------------- C L A S S E     I M A G E B I N A I R E ------------------
+
+ImageBinaire::ImageBinaire (ConstImageView<int> img_niv) :
+	rows(img_niv._rows()), cols(img_niv._cols())
+{
+	mots = (cols + 63) / 64;
+	masque_fin = (cols % 64 == 0) ? ~uint64_t(0) : (uint64_t(1) << (cols % 64)) - 1;
+	bits.assign(rows * mots, 0);
+
+	for (int y = 0; y < rows; y++)
+	{
+		const int *src = img_niv.ligne(y);
+		uint64_t *l = ligne(y);
+		for (int x = 0; x < cols; x++)
+		{
+			if (src[x] == 0) l[x / 64] |= uint64_t(1) << (x % 64);
+		}
+	}
+}
+
+ImageBinaire::~ImageBinaire()
+{
+	;
+}
+
+int ImageBinaire::_rows() {	return rows;	}
+int ImageBinaire::_cols() {	return cols;	}
+
+uint64_t *ImageBinaire::ligne(int y) {	return &bits[y * mots];	}
+
+bool ImageBinaire::get(int x, int y)
+{
+	return (ligne(y)[x / 64] >> (x % 64)) & 1;
+}
+
+/*--------------------------------------------------------------
+ * Recopie dans @img_niv : forme à 0, fond à 255.
+ * ------------------------------------------------------------*/
+void ImageBinaire::vers_img_niv(ImageView<int> img_niv)
+{
+	for (int y = 0; y < rows; y++)
+	{
+		int *dst = img_niv.ligne(y);
+		const uint64_t *l = ligne(y);
+		for (int x = 0; x < cols; x++)
+			dst[x] = ((l[x / 64] >> (x % 64)) & 1) ? 0 : 255;
+	}
+}
+
+void ImageBinaire::complementer()
+{
+	for (int y = 0; y < rows; y++)
+	{
+		uint64_t *l = ligne(y);
+		for (int i = 0; i < mots; i++) l[i] = ~l[i];
+		l[mots-1] &= masque_fin;
+	}
+}
+
+/*--------------------------------------------------------------
+ * Comme Morphologie, le bord de l'image n'est jamais forme.
+ * ------------------------------------------------------------*/
+void ImageBinaire::effacer_bord()
+{
+	if (rows == 0 || cols == 0) return;
+	memset(ligne(0), 0, mots * sizeof(uint64_t));
+	memset(ligne(rows-1), 0, mots * sizeof(uint64_t));
+	uint64_t bit_fin = uint64_t(1) << ((cols-1) % 64);
+	for (int y = 0; y < rows; y++)
+	{
+		uint64_t *l = ligne(y);
+		l[0] &= ~uint64_t(1);
+		l[(cols-1) / 64] &= ~bit_fin;
+	}
+}
+
+/*--------------------------------------------------------------
+ * Bit x de @dst = bit x+@s de @src (0 s'il sort de la ligne).
+ * ------------------------------------------------------------*/
+void ImageBinaire::decaler_ligne(const uint64_t *src, uint64_t *dst, int s)
+{
+	int q = abs(s) / 64, r = abs(s) % 64;
+
+	for (int i = 0; i < mots; i++)
+	{
+		uint64_t v = 0;
+		if (s >= 0)
+		{
+			int j = i + q;
+			if (j < mots)						v = src[j] >> r;
+			if (r != 0 && j+1 < mots)			v |= src[j+1] << (64 - r);
+		}
+		else
+		{
+			int j = i - q;
+			if (j >= 0)							v = src[j] << r;
+			if (r != 0 && j-1 >= 0)				v |= src[j-1] >> (64 - r);
+		}
+		dst[i] = v;
+	}
+	dst[mots-1] &= masque_fin;
+}
+
+/*--------------------------------------------------------------
+ * Remplace le bit x de @l par le OU des bits x .. x+@k-1
+ * (@sens > 0) ou x-@k+1 .. x (@sens < 0). La fenêtre est
+ * doublée à chaque étape : log2(k) décalages par ligne au
+ * lieu d'un par pixel du segment.
+ * ------------------------------------------------------------*/
+void ImageBinaire::etendre_fenetre(uint64_t *l, int k, int sens, uint64_t *tampon)
+{
+	int longueur = 1;
+	while (longueur < k)
+	{
+		int pas = min(longueur, k - longueur);
+		decaler_ligne(l, tampon, sens > 0 ? pas : -pas);
+		for (int i = 0; i < mots; i++) l[i] |= tampon[i];
+		longueur += pas;
+	}
+}
+
+/*--------------------------------------------------------------
+ * Bit x de @dst = OU des bits x+@dx0 .. x+@dx1 de @src.
+ * La fenêtre est d'abord construite du côté du pixel x, puis
+ * décalée : un décalage ne perd ainsi que des bits dont
+ * toute la fenêtre est hors de la ligne.
+ * ------------------------------------------------------------*/
+void ImageBinaire::ou_fenetre(const uint64_t *src, uint64_t *dst, int dx0, int dx1)
+{
+	tamponA.assign(src, src + mots);
+	tamponB.resize(mots);
+
+	if (dx0 > 0)
+	{
+		etendre_fenetre(tamponA.data(), dx1 - dx0 + 1, 1, tamponB.data());
+		decaler_ligne(tamponA.data(), dst, dx0);
+	}
+	else if (dx1 < 0)
+	{
+		etendre_fenetre(tamponA.data(), dx1 - dx0 + 1, -1, tamponB.data());
+		decaler_ligne(tamponA.data(), dst, dx1);
+	}
+	else
+	{
+		// x+dx0 .. x  et  x .. x+dx1
+		memcpy(dst, src, mots * sizeof(uint64_t));
+		etendre_fenetre(tamponA.data(), dx1 + 1, 1, tamponB.data());
+		etendre_fenetre(dst, 1 - dx0, -1, tamponB.data());
+		for (int i = 0; i < mots; i++) dst[i] |= tamponA[i];
+	}
+}
+
+/*--------------------------------------------------------------
+ * Un pixel P devient forme si un segment de l'élément
+ * structurant calqué sur P touche la forme.
+ * ------------------------------------------------------------*/
+void ImageBinaire::dilatation(const vector<SegmentES> &segments)
+{
+	if (rows == 0 || cols == 0) return;
+
+	vector<uint64_t> res(bits.size(), 0);
+	tamponFenetre.resize(mots);
+
+	for (unsigned s = 0; s < segments.size(); s++)
+	{
+		for (int y = 0; y < rows; y++)
+		{
+			int yy = y + segments[s].dy;
+			if (yy < 0 || yy >= rows) continue;
+			ou_fenetre(ligne(yy), tamponFenetre.data(),
+				segments[s].dx0, segments[s].dx1);
+			uint64_t *r = &res[y * mots];
+			for (int i = 0; i < mots; i++) r[i] |= tamponFenetre[i];
+		}
+	}
+
+	bits.swap(res);
+	effacer_bord();
+}
+
+/*--------------------------------------------------------------
+ * Érosion par dualité : les pixels hors de l'image comptant
+ * comme forme, éroder F revient à complémenter la dilatation
+ * du complémentaire de F.
+ * ------------------------------------------------------------*/
+void ImageBinaire::erosion(const vector<SegmentES> &segments)
+{
+	if (rows == 0 || cols == 0) return;
+
+	complementer();
+	dilatation(segments);
+	complementer();
+	effacer_bord();
+}
@@ -0,0 +1,56 @@
+#ifndef IMAGE_BINAIRE_H
+#define IMAGE_BINAIRE_H
+
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+
+#include "Morphologie.h"
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Image binaire compactée : 1 bit par pixel, 64 pixels par mot.
+ * Le bit x%64 du mot x/64 d'une ligne vaut 1 si le pixel (x, y)
+ * appartient à la forme (pixel à 0 dans img_niv).
+ * Les bits au delà de cols dans le dernier mot sont toujours à 0.
+ *
+ * Dilatation et érosion se font mot par mot : chaque segment de
+ * l'élément structurant devient quelques décalages + OU sur des
+ * lignes entières, soit 64 pixels par opération.
+ * ------------------------------------------------------------*/
+class ImageBinaire
+{
+public:
+
+	ImageBinaire (ConstImageView<int> img_niv);
+	~ImageBinaire();
+
+	int _rows();
+	int _cols();
+	bool get(int x, int y);
+	void vers_img_niv(ImageView<int> img_niv);
+
+	void dilatation(const vector<SegmentES> &segments);
+	void erosion(const vector<SegmentES> &segments);
+
+private:
+
+	int rows, cols;
+	int mots;		// nombre de mots par ligne
+	uint64_t masque_fin;	// bits valides du dernier mot d'une ligne
+	vector<uint64_t> bits;
+
+	uint64_t *ligne(int y);
+	void complementer();
+	void effacer_bord();
+	void decaler_ligne(const uint64_t *src, uint64_t *dst, int s);
+	void etendre_fenetre(uint64_t *l, int k, int sens, uint64_t *tampon);
+	void ou_fenetre(const uint64_t *src, uint64_t *dst, int dx0, int dx1);
+
+	vector<uint64_t> tamponFenetre, tamponA, tamponB;
+};
+
+#endif // IMAGE_BINAIRE_H
@@ -0,0 +1,253 @@
+#include "Morphologie.h"
+
+//------------------- C L A S S E     M O R P H O L O G I E --------------------
+
+Morphologie::Morphologie (ConstImageView<int> eltStruct, cv::Point centreES) :
+	rectangle(false),
+	rect_dx0(0), rect_dx1(0), rect_dy0(0), rect_dy1(0)
+{
+	decomposer_eltStruct(eltStruct, centreES);
+}
+
+Morphologie::~Morphologie()
+{
+	;
+}
+
+bool Morphologie::est_rectangle() {	return rectangle;	}
+
+const vector<SegmentES> &Morphologie::get_segments() {	return segments;	}
+
+/*--------------------------------------------------------------
+ * Découpe l'élément structurant (pixels à 0 de @eltStruct)
+ * en segments horizontaux relatifs à @centreES.
+ * Comme dans est_dans_eltStruct(), le centre en fait
+ * toujours partie.
+ * Détecte au passage si l'élément est un rectangle plein.
+ * ------------------------------------------------------------*/
+void Morphologie::decomposer_eltStruct(ConstImageView<int> eltStruct, cv::Point centreES)
+{
+	segments.clear();
+
+	int xmin = centreES.x, xmax = centreES.x;
+	int ymin = centreES.y, ymax = centreES.y;
+	int nbPixels = 0;
+
+	for (int y = 0; y < eltStruct._rows(); y++)
+	{
+		const int *l = eltStruct.ligne(y);
+		int debut = -1;
+		for (int x = 0; x <= eltStruct._cols(); x++)
+		{
+			bool dedans = x < eltStruct._cols()
+				&& (l[x] == 0 || cv::Point(x, y) == centreES);
+			if (dedans && debut < 0) {
+				debut = x;
+			}
+			else if (!dedans && debut >= 0) {
+				segments.push_back(SegmentES(y - centreES.y,
+					debut - centreES.x, x - 1 - centreES.x));
+				nbPixels += x - debut;
+				xmin = min(xmin, debut);		xmax = max(xmax, x - 1);
+				ymin = min(ymin, y);			ymax = max(ymax, y);
+				debut = -1;
+			}
+		}
+	}
+
+	rect_dx0 = xmin - centreES.x;	rect_dx1 = xmax - centreES.x;
+	rect_dy0 = ymin - centreES.y;	rect_dy1 = ymax - centreES.y;
+	rectangle = (nbPixels == (xmax - xmin + 1) * (ymax - ymin + 1));
+}
+
+/*--------------------------------------------------------------
+ * Algorithme de van Herk/Gil-Werman : @dst[i] reçoit le min
+ * (ou le max) de @src[i+a .. i+b], les cases hors de @src
+ * valant @bord. Coût : 3 comparaisons par pixel quelle que
+ * soit la longueur k = b-a+1 de la fenêtre.
+ * ------------------------------------------------------------*/
+void Morphologie::van_herk_1d(const int *src, int *dst, int n, int a, int b,
+	int bord, bool prendre_min)
+{
+	int k = b - a + 1;
+	int l = ((n + k - 1 + k - 1) / k) * k;	// arrondi au multiple de k
+
+	tamponP.resize(l);
+	tamponG.resize(l);
+	tamponH.resize(l);
+	int *p = tamponP.data(), *g = tamponG.data(), *h = tamponH.data();
+
+	for (int j = 0; j < l; j++)
+	{
+		int i = j + a;
+		p[j] = (i >= 0 && i < n) ? src[i] : bord;
+	}
+
+	// g : min cumulé depuis le début du bloc, h : depuis la fin du bloc
+	for (int j = 0; j < l; j++)
+	{
+		if (j % k == 0)	g[j] = p[j];
+		else			g[j] = prendre_min ? min(g[j-1], p[j]) : max(g[j-1], p[j]);
+	}
+	for (int j = l-1; j >= 0; j--)
+	{
+		if ((j+1) % k == 0)	h[j] = p[j];
+		else				h[j] = prendre_min ? min(h[j+1], p[j]) : max(h[j+1], p[j]);
+	}
+
+	for (int i = 0; i < n; i++)
+		dst[i] = prendre_min ? min(h[i], g[i+k-1]) : max(h[i], g[i+k-1]);
+}
+
+/*--------------------------------------------------------------
+ * Passe sur les lignes puis sur les colonnes pour le
+ * rectangle [rect_dx0..rect_dx1] x [rect_dy0..rect_dy1].
+ * ------------------------------------------------------------*/
+void Morphologie::van_herk_2d(ImageView<int> img_niv, int bord, bool prendre_min)
+{
+	int rows = img_niv._rows(), cols = img_niv._cols();
+	cv::Mat tmp_mat(rows, cols, CV_32SC1);
+	ImageView<int> tmp(tmp_mat);
+
+	for (int y = 0; y < rows; y++)
+	{
+		van_herk_1d(img_niv.ligne(y), tmp.ligne(y), cols,
+			rect_dx0, rect_dx1, bord, prendre_min);
+	}
+
+	tamponCol.resize(rows);
+	tamponRes.resize(rows);
+	for (int x = 0; x < cols; x++)
+	{
+		for (int y = 0; y < rows; y++)
+			tamponCol[y] = tmp(y, x);
+
+		van_herk_1d(tamponCol.data(), tamponRes.data(), rows,
+			rect_dy0, rect_dy1, bord, prendre_min);
+
+		for (int y = 0; y < rows; y++)
+			img_niv(y, x) = tamponRes[y] == 0 ? 0 : 255;
+	}
+}
+
+/*--------------------------------------------------------------
+ * @cumul[y*(cols+1) + x] = nombre de pixels de la forme
+ * sur la ligne y, entre les colonnes 0 et x-1.
+ * ------------------------------------------------------------*/
+void Morphologie::sommes_cumulees(ConstImageView<int> img_niv, vector<int> &cumul)
+{
+	int largeur = img_niv._cols() + 1;
+	cumul.assign(img_niv._rows() * largeur, 0);
+
+	for (int y = 0; y < img_niv._rows(); y++)
+	{
+		const int *ligne = img_niv.ligne(y);
+		int *c = &cumul[y * largeur];
+		for (int x = 0; x < img_niv._cols(); x++)
+			c[x+1] = c[x] + (ligne[x] == 0);
+	}
+}
+
+void Morphologie::remplir(ImageView<int> img_niv, int val)
+{
+	for (int y = 0; y < img_niv._rows(); y++)
+		fill(img_niv.ligne(y), img_niv.ligne(y) + img_niv._cols(), val);
+}
+
+/*--------------------------------------------------------------
+ * Les anciennes versions ne calculaient pas le bord de
+ * l'image : on garde le même résultat.
+ * ------------------------------------------------------------*/
+void Morphologie::blanchir_bord(ImageView<int> img_niv)
+{
+	int rows = img_niv._rows(), cols = img_niv._cols();
+	fill(img_niv.ligne(0), img_niv.ligne(0) + cols, 255);
+	fill(img_niv.ligne(rows-1), img_niv.ligne(rows-1) + cols, 255);
+	for (int y = 0; y < rows; y++)
+	{
+		img_niv(y, 0) = 255;
+		img_niv(y, cols-1) = 255;
+	}
+}
+
+/*--------------------------------------------------------------
+ * Un pixel P devient forme si l'élément structurant calqué
+ * sur P touche au moins un pixel de la forme.
+ * ------------------------------------------------------------*/
+void Morphologie::dilatation(ImageView<int> img_niv)
+{
+	int rows = img_niv._rows(), cols = img_niv._cols();
+	if (rows == 0 || cols == 0) return;
+
+	if (rectangle)
+	{
+		// hors de l'image = fond
+		van_herk_2d(img_niv, 255, true);
+		blanchir_bord(img_niv);
+		return;
+	}
+
+	vector<int> cumul;
+	sommes_cumulees(img_niv, cumul);
+	int largeur = cols + 1;
+	remplir(img_niv, 255);
+
+	for (int y = 1; y < rows-1; y++)
+	for (int x = 1; x < cols-1; x++)
+	{
+		for (unsigned i = 0; i < segments.size(); i++)
+		{
+			int yy = y + segments[i].dy;
+			if (yy < 0 || yy >= rows) continue;
+			int x0 = max(0, x + segments[i].dx0);
+			int x1 = min(cols-1, x + segments[i].dx1);
+			if (x0 > x1) continue;
+			const int *c = &cumul[yy * largeur];
+			if (c[x1+1] - c[x0] > 0) {
+				img_niv(y, x) = 0;
+				break;
+			}
+		}
+	}
+}
+
+/*--------------------------------------------------------------
+ * Un pixel P reste forme si l'élément structurant calqué
+ * sur P est inclus dans la forme (les pixels hors de
+ * l'image sont ignorés).
+ * ------------------------------------------------------------*/
+void Morphologie::erosion(ImageView<int> img_niv)
+{
+	int rows = img_niv._rows(), cols = img_niv._cols();
+	if (rows == 0 || cols == 0) return;
+
+	if (rectangle)
+	{
+		// hors de l'image = forme
+		van_herk_2d(img_niv, 0, false);
+		blanchir_bord(img_niv);
+		return;
+	}
+
+	vector<int> cumul;
+	sommes_cumulees(img_niv, cumul);
+	int largeur = cols + 1;
+	remplir(img_niv, 255);
+
+	for (int y = 1; y < rows-1; y++)
+	for (int x = 1; x < cols-1; x++)
+	{
+		bool inclus = true;
+		for (unsigned i = 0; i < segments.size() && inclus; i++)
+		{
+			int yy = y + segments[i].dy;
+			if (yy < 0 || yy >= rows) continue;
+			int x0 = max(0, x + segments[i].dx0);
+			int x1 = min(cols-1, x + segments[i].dx1);
+			if (x0 > x1) continue;
+			const int *c = &cumul[yy * largeur];
+			if (c[x1+1] - c[x0] != x1 - x0 + 1) inclus = false;
+		}
+		if (inclus) img_niv(y, x) = 0;
+	}
+}
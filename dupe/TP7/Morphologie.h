@@ -0,0 +1,70 @@
+#ifndef MORPHOLOGIE_H
+#define MORPHOLOGIE_H
+
+#include <iostream>
+#include <cstring>
+#include <opencv2/opencv.hpp>
+
+#include "ImageView.h"
+
+#include <vector>
+using namespace std;
+
+/*--------------------------------------------------------------
+ * Segment horizontal de l'élément structurant, exprimé en
+ * décalages par rapport à son centre : les pixels
+ * (dx0..dx1, dy) appartiennent à l'élément structurant.
+ * ------------------------------------------------------------*/
+struct SegmentES
+{
+	int dy;
+	int dx0;
+	int dx1;
+	SegmentES(int dy, int dx0, int dx1) {this->dy=dy; this->dx0=dx0; this->dx1=dx1;}
+};
+
+/*--------------------------------------------------------------
+ * Dilatation et érosion en temps linéaire en la taille de
+ * l'image (forme à 0, fond à 255, comme dans le reste du TP).
+ *
+ * L'élément structurant est décomposé une seule fois :
+ *  - si c'est un rectangle (ou une ligne horizontale/verticale),
+ *    on fait 2 passes 1D de van Herk/Gil-Werman, en O(1) par
+ *    pixel quelle que soit la taille du rectangle ;
+ *  - sinon on le code en segments (RLE) et chaque segment est
+ *    testé en O(1) grâce aux sommes cumulées des lignes.
+ *
+ * Les images passent par des vues (commun/ImageView.h) : un
+ * cv::Mat s'y convertit implicitement à l'appel, et les boucles
+ * internes ne touchent plus au compteur de références.
+ * ------------------------------------------------------------*/
+class Morphologie
+{
+public:
+
+	Morphologie (ConstImageView<int> eltStruct, cv::Point centreES);
+	~Morphologie();
+
+	bool est_rectangle();
+	const vector<SegmentES> &get_segments();
+	void dilatation(ImageView<int> img_niv);
+	void erosion(ImageView<int> img_niv);
+
+private:
+
+	vector<SegmentES> segments;
+	bool rectangle;
+	int rect_dx0, rect_dx1, rect_dy0, rect_dy1;
+
+	void decomposer_eltStruct(ConstImageView<int> eltStruct, cv::Point centreES);
+	void van_herk_1d(const int *src, int *dst, int n, int a, int b,
+		int bord, bool prendre_min);
+	void van_herk_2d(ImageView<int> img_niv, int bord, bool prendre_min);
+	void sommes_cumulees(ConstImageView<int> img_niv, vector<int> &cumul);
+	void remplir(ImageView<int> img_niv, int val);
+	void blanchir_bord(ImageView<int> img_niv);
+
+	vector<int> tamponG, tamponH, tamponP, tamponCol, tamponRes;
+};
+
+#endif // MORPHOLOGIE_H
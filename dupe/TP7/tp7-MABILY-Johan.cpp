@@ -3,7 +3,7 @@
 
     g++ -Wall --std=c++14 $(pkg-config opencv --cflags)  tp7.cpp \
                           $(pkg-config opencv --libs) -o tp7
-    ./tp7 [-mag width height] [-thr seuil] image_in eltStruct [image_out]
+    ./tp7 [-mag width height] [-thr seuil] [--threads N] image_in eltStruct [image_out]
 
     CC-BY Edouard.Thiel@univ-amu.fr - 29/09/2019
 
@@ -17,6 +17,16 @@
 #include <opencv2/opencv.hpp>
 
 #include "Contour.h"
+#include "Morphologie.h"
+#include "ImageBinaire.h"
+#include "PoolThreads.h"
+#include "Batch.h"
+#include "Flux.h"
+#include "LoupeVue.h"
+#include "RenduTuiles.h"
+#include "CouleursVGA.h"
+#include "GrapheCalcul.h"
+#include "ImageView.h"
 
 #include <vector>
 using namespace std;
@@ -28,84 +38,6 @@ using namespace std;
             "' pour la matrice '" # mat "'");
 
 
-//--------------------------------- L O U P E ---------------------------------
-
-class Loupe {
-  public:
-    int zoom = 5;
-    int zoom_max = 20;
-    int zoom_x0 = 0;
-    int zoom_y0 = 0;
-    int zoom_x1 = 100;
-    int zoom_y1 = 100;
-
-    void reborner (cv::Mat &res1, cv::Mat &res2)
-    {
-        int bon_zoom = zoom >= 1 ? zoom : 1;
-
-        int h = res2.rows / bon_zoom;
-        int w = res2.cols / bon_zoom;
-
-        if (zoom_x0 < 0) zoom_x0 = 0;
-        zoom_x1 = zoom_x0 + w;
-        if (zoom_x1 > res1.cols) {
-            zoom_x1 = res1.cols;
-            zoom_x0 = zoom_x1 - w;
-            if (zoom_x0 < 0) zoom_x0 = 0;
-        }
-
-        if (zoom_y0 < 0) zoom_y0 = 0;
-        zoom_y1 = zoom_y0 + h;
-        if (zoom_y1 > res1.rows) {
-            zoom_y1 = res1.rows;
-            zoom_y0 = zoom_y1 - h;
-            if (zoom_y0 < 0) zoom_y0 = 0;
-        }
-    }
-
-    void deplacer (cv::Mat &res1, cv::Mat &res2, int dx, int dy)
-    {
-        zoom_x0 += dx; zoom_y0 += dy;
-        zoom_x1 += dx; zoom_y1 += dy;
-        reborner (res1, res2);
-    }
-
-    void dessiner_rect (cv::Mat &src, cv::Mat &dest)
-    {
-        dest = src.clone();
-        if (zoom == 0) return;
-        cv::Point p0 = cv::Point(zoom_x0, zoom_y0),
-                  p1 = cv::Point(zoom_x1, zoom_y1);
-        cv::rectangle(dest, p0, p1, cv::Scalar (255, 255, 255), 3, 4);
-        cv::rectangle(dest, p0, p1, cv::Scalar (  0,   0, 255), 1, 4);
-    }
-
-    void dessiner_portion (cv::Mat &src, cv::Mat &dest)
-    {
-        CHECK_MAT_TYPE(src, CV_8UC3)
-
-        int bon_zoom = zoom >= 1 ? zoom : 1;
-
-        for (int y = 0; y < dest.rows; y++)
-        for (int x = 0; x < dest.cols; x++)
-        {
-            int x0 = zoom_x0 + x / bon_zoom;
-            int y0 = zoom_y0 + y / bon_zoom;
-
-            if (x0 < 0 || x0 >= src.cols || y0 < 0 || y0 >= src.rows) {
-                dest.at<cv::Vec3b>(y,x)[0] = 64;
-                dest.at<cv::Vec3b>(y,x)[1] = 64;
-                dest.at<cv::Vec3b>(y,x)[2] = 64;
-                continue;
-            }
-            dest.at<cv::Vec3b>(y,x)[0] = src.at<cv::Vec3b>(y0,x0)[0];
-            dest.at<cv::Vec3b>(y,x)[1] = src.at<cv::Vec3b>(y0,x0)[1];
-            dest.at<cv::Vec3b>(y,x)[2] = src.at<cv::Vec3b>(y0,x0)[2];
-        }
-    }
-};
-
-
 //----------------------- C O U L E U R S   V G A -----------------------------
 
 void representer_en_couleurs_vga (cv::Mat img_niv, cv::Mat img_coul)
@@ -113,36 +45,9 @@ void representer_en_couleurs_vga (cv::Mat img_niv, cv::Mat img_coul)
     CHECK_MAT_TYPE(img_niv, CV_32SC1)
     CHECK_MAT_TYPE(img_coul, CV_8UC3)
 
-    unsigned char couls[16][3] = {  // R, G, B
-        {   0,   0,   0 },   //  0  black           ->  0 uniquement
-        {  20,  20, 190 },   //  1  blue            ->  1, 15, 29, ...
-        {  30, 200,  30 },   //  2  green           ->  2, 16, 30, ...
-        {  30, 200, 200 },   //  3  cyan            ->  3, 17, 31, ...
-        { 200,  30,  30 },   //  4  red             ->  4, 18, 32, ...
-        { 200,  30, 200 },   //  5  magenta         ->  5, 19, 33, ...
-        { 200, 130,  50 },   //  6  brown           ->  6, 20, 34, ...
-        { 200, 200, 200 },   //  7  light gray      ->  7, 21, 35, ...
-        { 110, 110, 140 },   //  8  dark gray       ->  8, 22, 36, ...
-        {  84, 130, 252 },   //  9  light blue      ->  9, 23, 37, ...
-        {  84, 252,  84 },   // 10  light green     -> 10, 24, 38, ...
-        {  84, 252, 252 },   // 11  light cyan      -> 11, 25, 39, ...
-        { 252,  84,  84 },   // 12  light red       -> 12, 26, 40, ...
-        { 252,  84, 252 },   // 13  light magenta   -> 13, 27, 41, ...
-        { 252, 252,  84 },   // 14  yellow          -> 14, 28, 42, ...
-        { 252, 252, 252 },   // 15  white           -> 255 uniquement
-    };
-
-    for (int y = 0; y < img_niv.rows; y++)
-    for (int x = 0; x < img_niv.cols; x++)
-    {
-        int g = img_niv.at<int>(y,x), c = 0;
-        if (g == 255) c = 15;                      // seul 255 est blanc
-        else if (g != 0) c = 1 + abs(g-1) % 14;    // seul 0 est noir
-        // Attention img_coul est en B, G, R -> inverser les canaux
-        img_coul.at<cv::Vec3b>(y,x)[0] = couls[c][2];
-        img_coul.at<cv::Vec3b>(y,x)[1] = couls[c][1];
-        img_coul.at<cv::Vec3b>(y,x)[2] = couls[c][0];
-    }
+    // 0 noir, 255 blanc, sinon la couleur 1 + |g-1| % 14 de la palette
+    // VGA : conversion vectorisee (AVX2 si dispo), voir commun/CouleursVGA.h
+    colorier_vga (img_niv, img_coul);
 }
 
 //------------------------ M E S    D O N N E E S -----------------------------
@@ -150,10 +55,9 @@ void representer_en_couleurs_vga (cv::Mat img_niv, cv::Mat img_coul)
 const int g_nx8[] = {1, 1, 0, -1, -1, -1, 0, 1};
 const int g_ny8[] = {0, 1, 1, 1, 0, -1, -1, -1};
 enum enum_type_forme { FORME_0, FORME_255};
-enum enum_algo_type { ITERATIF, RECURSIF};
-int g_typeAlgo = ITERATIF;
+enum enum_algo_type { ITERATIF, RECURSIF, LINEAIRE, BINAIRE};
+int g_typeAlgo = LINEAIRE;
 bool g_chargement = false;
-const int LIMITE_ELT_STRUCT = 50;
 void rotate_eltStruct(cv::Mat img);
 void adapt_eltStruct(cv::Mat img_eltStruct, cv::Point &centre);
 
@@ -163,7 +67,8 @@ class My {
   public:
     cv::Mat img_src, img_res1, img_res2, img_niv, img_coul;
     cv::Mat img_srcES, img_res1ES, img_res2ES, img_eltStruct, img_coulES;
-    Loupe loupe;
+    LoupeVue loupe;
+    RenduTuiles rendu;   //couleurs rendues par tuiles, a la demande
     int seuil = 127;
     int clic_x = 0;
     int clic_y = 0;
@@ -182,6 +87,10 @@ class My {
 		 A_TRANS5, A_TRANS6, A_TRANS7, A_TRANS8 };
     Affi affi = A_ORIG;
 
+    //graphe de calcul memorise (voir commun/GrapheCalcul.h) : un noeud par
+    //operation morphologique, pour revenir sans recalcul sur un affichage deja vu
+    long version_src = 0;   //a incrementer quand img_src change
+    NoeudCalcul n_gris, n_seuil, n_seuilES, n_morpho[A_TRANS8 - A_TRANS1 + 1];
 };
 
 
@@ -191,13 +100,7 @@ void inverser_couleurs (cv::Mat img)
 {
     CHECK_MAT_TYPE(img, CV_8UC3)
 
-    for (int y = 0; y < img.rows; y++)
-    for (int x = 0; x < img.cols; x++)
-    {
-        img.at<cv::Vec3b>(y,x)[0] = 255 - img.at<cv::Vec3b>(y,x)[0];
-        img.at<cv::Vec3b>(y,x)[1] = 255 - img.at<cv::Vec3b>(y,x)[1];
-        img.at<cv::Vec3b>(y,x)[2] = 255 - img.at<cv::Vec3b>(y,x)[2];
-    }
+    complementer_couleurs (img);
 }
 
 void inverser_code_couleur(cv::Mat img)
@@ -217,10 +120,10 @@ void inverser_code_couleur(cv::Mat img)
 /*--------------------------------------------------------------
 * Vrai si la coord (@x, @y) se trouve dans le plan de l'image
 * ------------------------------------------------------------*/
-bool est_dans_image(cv::Mat img_niv, int x, int y)
+bool est_dans_image(ConstImageView<int> img_niv, int x, int y)
 {
-	if ( x<0 || x>= img_niv.cols
-		|| y<0 || y>= img_niv.rows)
+	if ( x<0 || x>= img_niv._cols()
+		|| y<0 || y>= img_niv._rows())
 	{
 		return false;
 	}
@@ -240,7 +143,7 @@ void recolor(cv::Mat img_niv, int color)
 	}
 }
 
-bool est_dans_forme(cv::Mat img, cv::Point P, int typeForme)
+bool est_dans_forme(ConstImageView<int> img, cv::Point P, int typeForme)
 {
     int val;
     if (typeForme == FORME_0) {
@@ -249,7 +152,7 @@ bool est_dans_forme(cv::Mat img, cv::Point P, int typeForme)
     else {
         val = 255;
     }
-    if (img.at<int>(P.y, P.x) == val)
+    if (img(P.y, P.x) == val)
         return true;
     return false;
 }
@@ -258,7 +161,7 @@ bool est_dans_forme(cv::Mat img, cv::Point P, int typeForme)
  * Vrai si @P2 est dans l'élément structurant calqué sur @P1.
  * (dont le centre @centreES est calqué sur @P1)
 * ------------------------------------------------------------*/
-bool est_dans_eltStruct(cv::Mat eltStruct, cv::Point centreES,
+bool est_dans_eltStruct(ConstImageView<int> eltStruct, cv::Point centreES,
         cv::Point P1, cv::Point P2)
 {
     if (P1 == P2)   return true;
@@ -266,11 +169,11 @@ bool est_dans_eltStruct(cv::Mat eltStruct, cv::Point centreES,
     cv::Point test = centreES - chemin;
     if (!est_dans_image(eltStruct, test.x, test.y)) return false;
     // cout << __FUNCTION__ << ": eltStruct.at<int>(" << test.y << ", " << test.x << ") = " << eltStruct.at<int>(test.y, test.x) << endl;
-    if (eltStruct.at<int>(test.y, test.x) == 0)   return true;
+    if (eltStruct(test.y, test.x) == 0)   return true;
     return false;
 }
 
-bool point_est_dans_vector(vector<cv::Point> v, cv::Point P)
+bool point_est_dans_vector(const vector<cv::Point> &v, cv::Point P)
 {
     for (unsigned i=0; i<v.size(); i++)
     {
@@ -288,7 +191,7 @@ bool point_est_dans_vector(vector<cv::Point> v, cv::Point P)
  * calque sur la forme dans @img_niv.
  * (Fonction récursive)
 * ------------------------------------------------------------*/
-bool intersection_test_rec(cv::Mat img_niv, cv::Mat eltStruct,
+bool intersection_test_rec(ConstImageView<int> img_niv, ConstImageView<int> eltStruct,
         cv::Point centreES,
         cv::Point P1, cv::Point P2, vector<cv::Point> &pointsVisites, int prof)
 {
@@ -330,13 +233,13 @@ bool intersection_test_rec(cv::Mat img_niv, cv::Mat eltStruct,
  * calque sur la forme dans @img_niv.
  * (Fonction itérative)
 * ------------------------------------------------------------*/
-bool intersection_test_iteratif(cv::Mat img_niv, cv::Mat eltStruct,
+bool intersection_test_iteratif(ConstImageView<int> img_niv, ConstImageView<int> eltStruct,
         cv::Point centreES, cv::Point P1)
 {
     cv::Point P2;
-    for (int y = 0; y < img_niv.rows; y++)
+    for (int y = 0; y < img_niv._rows(); y++)
 	{
-		for (int x = 0; x < img_niv.cols; x++)
+		for (int x = 0; x < img_niv._cols(); x++)
 		{
             P2 = cv::Point(x, y);
             if (est_dans_forme(img_niv, P2, FORME_0)
@@ -352,10 +255,25 @@ bool intersection_test_iteratif(cv::Mat img_niv, cv::Mat eltStruct,
 void dilatation(cv::Mat img_niv, cv::Mat eltStruct, cv::Point centreES)
 {
     if (g_chargement) cout << "\t\t<" << __FUNCTION__ << ">" << endl;
-	float xn, yn;
+    if (g_typeAlgo == LINEAIRE) {
+        Morphologie morpho(eltStruct, centreES);
+        morpho.dilatation(img_niv);
+        if (g_chargement) cout << "\t\t</" << __FUNCTION__ << ">" << endl;
+        return;
+    }
+    if (g_typeAlgo == BINAIRE) {
+        Morphologie morpho(eltStruct, centreES);
+        ImageBinaire img_bin(img_niv);
+        img_bin.dilatation(morpho.get_segments());
+        img_bin.vers_img_niv(img_niv);
+        if (g_chargement) cout << "\t\t</" << __FUNCTION__ << ">" << endl;
+        return;
+    }
 	cv::Mat tmp;
 	img_niv.copyTo(tmp);
 	img_niv.setTo(255);
+    //vues construites une fois : pas de compteur de references par pixel
+    ConstImageView<int> vue_tmp(tmp), vue_es(eltStruct);
     bool intersect = false;
     vector<cv::Point> pointsVisites;
 
@@ -367,12 +285,12 @@ void dilatation(cv::Mat img_niv, cv::Mat eltStruct, cv::Point centreES)
 		{
             cv::Point P1(x, y);
             if (g_typeAlgo == ITERATIF) {
-                intersect = intersection_test_iteratif(tmp, eltStruct, centreES, P1);
+                intersect = intersection_test_iteratif(vue_tmp, vue_es, centreES, P1);
             }
-            else if (g_typeAlgo >= RECURSIF)
+            else if (g_typeAlgo == RECURSIF)
             {
                 pointsVisites.clear();
-                intersect = intersection_test_rec(tmp, eltStruct,
+                intersect = intersection_test_rec(vue_tmp, vue_es,
                     centreES, P1, P1,
                     pointsVisites, 0);
             }
@@ -382,13 +300,13 @@ void dilatation(cv::Mat img_niv, cv::Mat eltStruct, cv::Point centreES)
     if (g_chargement) cout << "\t\t</" << __FUNCTION__ << ">" << endl;
 }
 
-bool inclusion_test_iteratif(cv::Mat img_niv, cv::Mat eltStruct,
+bool inclusion_test_iteratif(ConstImageView<int> img_niv, ConstImageView<int> eltStruct,
         cv::Point centreES, cv::Point P1)
 {
     cv::Point P2;
-    for (int y = 0; y < img_niv.rows; y++)
+    for (int y = 0; y < img_niv._rows(); y++)
 	{
-		for (int x = 0; x < img_niv.cols; x++)
+		for (int x = 0; x < img_niv._cols(); x++)
 		{
             P2 = cv::Point(x, y);
             if (!est_dans_forme(img_niv, P2, FORME_0)
@@ -401,7 +319,7 @@ bool inclusion_test_iteratif(cv::Mat img_niv, cv::Mat eltStruct,
     return true;
 }
 
-bool inclusion_test_rec(cv::Mat img_niv, cv::Mat eltStruct,
+bool inclusion_test_rec(ConstImageView<int> img_niv, ConstImageView<int> eltStruct,
         cv::Point centreES,
         cv::Point P1, cv::Point P2, vector<cv::Point> &pointsVisites)
 {
@@ -438,9 +356,24 @@ bool inclusion_test_rec(cv::Mat img_niv, cv::Mat eltStruct,
 void erosion(cv::Mat img_niv, cv::Mat eltStruct, cv::Point centreES)
 {
 	if (g_chargement) cout << "\t\t<" << __FUNCTION__ << ">" << endl;
+    if (g_typeAlgo == LINEAIRE) {
+        Morphologie morpho(eltStruct, centreES);
+        morpho.erosion(img_niv);
+        if (g_chargement) cout << "\t\t</" << __FUNCTION__ << ">" << endl;
+        return;
+    }
+    if (g_typeAlgo == BINAIRE) {
+        Morphologie morpho(eltStruct, centreES);
+        ImageBinaire img_bin(img_niv);
+        img_bin.erosion(morpho.get_segments());
+        img_bin.vers_img_niv(img_niv);
+        if (g_chargement) cout << "\t\t</" << __FUNCTION__ << ">" << endl;
+        return;
+    }
     cv::Mat tmp;
     img_niv.copyTo(tmp);
     img_niv.setTo(255);
+    ConstImageView<int> vue_tmp(tmp), vue_es(eltStruct);
     vector<cv::Point> pointsVisites;
     bool inclus;
     for (int y = 1; y < tmp.rows-1; y++)
@@ -450,11 +383,11 @@ void erosion(cv::Mat img_niv, cv::Mat eltStruct, cv::Point centreES)
 		{
             cv::Point P1(x, y);
             if (g_typeAlgo == ITERATIF) {
-                inclus = inclusion_test_iteratif(tmp, eltStruct, centreES, P1);
+                inclus = inclusion_test_iteratif(vue_tmp, vue_es, centreES, P1);
             }
-            else if (g_typeAlgo >= RECURSIF) {
+            else if (g_typeAlgo == RECURSIF) {
                 pointsVisites.clear();
-                inclus = inclusion_test_rec(tmp, eltStruct,
+                inclus = inclusion_test_rec(vue_tmp, vue_es,
                     centreES, P1, P1,
                     pointsVisites);
             }
@@ -610,45 +543,72 @@ void adapt_eltStruct(cv::Mat img_eltStruct, cv::Point &centre)
 }
 
 // Appelez ici vos transformations selon affi
-void effectuer_transformations (My::Affi affi, cv::Mat img_niv, cv::Mat img_eltStruct, int filtre)
+// Le resultat est calcule par le graphe memorise de my : seuls les noeuds dont
+// la cle a change sont refaits, puis le resultat est recopie dans my.img_niv
+void effectuer_transformations (My &my)
 {
-    cout << "\t<" << __FUNCTION__ << ">" << endl;
-    cv::Point centreES;
-    adapt_eltStruct(img_eltStruct, centreES);
-
-    switch (affi) {
-        case My::A_TRANS1 :
-            //transformer_bandes_horizontales (img_niv);
-            dilatation(img_niv, img_eltStruct, centreES);
-            //recolor(img_niv, 0);
-            break;
-        case My::A_TRANS2 :
-            //~ transformer_bandes_verticales (img_niv);
-            erosion(img_niv, img_eltStruct, centreES);
-            break;
-        case My::A_TRANS3 :
-			ouverture(img_niv, img_eltStruct, centreES);
-            //~ transformer_bandes_diagonales (img_niv);
-            break;
-		case My::A_TRANS4 :
-			fermeture(img_niv, img_eltStruct, centreES);
-			break;
-		case My::A_TRANS5 :
-			gradient_inf(img_niv, img_eltStruct, centreES);
-			break;
-		case My::A_TRANS6 :
-			gradient_externe(img_niv, img_eltStruct, centreES);
-			break;
-		case My::A_TRANS7 :
-			gradient_morphologique(img_niv, img_eltStruct, centreES);
-			break;
-		case My::A_TRANS8 :
-			laplacien_morphologique(img_niv, img_eltStruct, centreES);
-			break;
-        default : break;
-    }
-    cout << "\t</" << __FUNCTION__ << ">" << endl;
-    cout << endl;
+    cv::Mat gris = my.n_gris.obtenir ({my.version_src}, [&](cv::Mat &r) {
+        cv::cvtColor (my.img_src, r, cv::COLOR_BGR2GRAY);
+    });
+    cv::Mat niv = my.n_seuil.obtenir ({my.n_gris._version(), my.seuil}, [&](cv::Mat &r) {
+        cv::Mat img_gry;
+        cv::threshold (gris, img_gry, my.seuil, 255, cv::THRESH_BINARY);
+        img_gry.convertTo (r, CV_32SC1,1., 0.);
+    });
+    if (my.affi == My::A_SEUIL) { niv.copyTo (my.img_niv); return; }
+    if (my.affi < My::A_TRANS1) return;
+
+    cv::Mat es = my.n_seuilES.obtenir ({my.seuil}, [&](cv::Mat &r) {
+        cv::Mat img_gryES;
+        cv::cvtColor (my.img_srcES, img_gryES, cv::COLOR_BGR2GRAY);
+        cv::threshold (img_gryES, img_gryES, my.seuil, 255, cv::THRESH_BINARY);
+        img_gryES.convertTo (r, CV_32SC1,1., 0.);
+    });
+
+    NoeudCalcul &n_morpho = my.n_morpho[my.affi - My::A_TRANS1];
+    n_morpho.obtenir ({my.n_seuil._version(), my.n_seuilES._version(), g_typeAlgo},
+      [&](cv::Mat &img_niv) {
+        cout << "\t<" << __FUNCTION__ << ">" << endl;
+        //les operations modifient l'image et l'element structurant sur place
+        img_niv = niv.clone();
+        cv::Mat img_eltStruct = es.clone();
+        cv::Point centreES;
+        adapt_eltStruct(img_eltStruct, centreES);
+
+        switch (my.affi) {
+            case My::A_TRANS1 :
+                //transformer_bandes_horizontales (img_niv);
+                dilatation(img_niv, img_eltStruct, centreES);
+                //recolor(img_niv, 0);
+                break;
+            case My::A_TRANS2 :
+                //~ transformer_bandes_verticales (img_niv);
+                erosion(img_niv, img_eltStruct, centreES);
+                break;
+            case My::A_TRANS3 :
+                ouverture(img_niv, img_eltStruct, centreES);
+                //~ transformer_bandes_diagonales (img_niv);
+                break;
+            case My::A_TRANS4 :
+                fermeture(img_niv, img_eltStruct, centreES);
+                break;
+            case My::A_TRANS5 :
+                gradient_inf(img_niv, img_eltStruct, centreES);
+                break;
+            case My::A_TRANS6 :
+                gradient_externe(img_niv, img_eltStruct, centreES);
+                break;
+            case My::A_TRANS7 :
+                gradient_morphologique(img_niv, img_eltStruct, centreES);
+                break;
+            case My::A_TRANS8 :
+                laplacien_morphologique(img_niv, img_eltStruct, centreES);
+                break;
+            default : break;
+        }
+        cout << "\t</" << __FUNCTION__ << ">" << endl;
+        cout << endl;
+    }).copyTo (my.img_niv);
 }
 
 
@@ -715,7 +675,7 @@ void afficher_aide() {
 
         "\n"
 
-        "   r    change le type d'algo : itératif ou récursif\n"
+        "   r    change le type d'algo : linéaire, binaire, itératif ou récursif\n"
         "   c    affiche le chargement des transformations\n"
 
         "\n"
@@ -763,6 +723,7 @@ int onKeyPressEvent (int key, void *data)
         case 'i' :
             std::cout << "Couleurs inversées" << std::endl;
             inverser_couleurs(my->img_src);
+            my->version_src++;
             my->set_recalc(My::R_SEUIL);
             break;
         case 'o' :
@@ -777,13 +738,21 @@ int onKeyPressEvent (int key, void *data)
             break;
         case 'r' :
             std::cout << "type algo : ";
-            if (g_typeAlgo == ITERATIF) {
+            if (g_typeAlgo == LINEAIRE) {
+                g_typeAlgo = BINAIRE;
+                std::cout << "binaire (64 pixels par mot)" << endl;
+            }
+            else if (g_typeAlgo == BINAIRE) {
+                g_typeAlgo = ITERATIF;
+                std::cout << "itératif" << endl;
+            }
+            else if (g_typeAlgo == ITERATIF) {
                 g_typeAlgo = RECURSIF;
                 std::cout << "récursif" << endl;
             }
             else {
-                g_typeAlgo = ITERATIF;
-                std::cout << "itératif" << endl;
+                g_typeAlgo = LINEAIRE;
+                std::cout << "linéaire (van Herk / segments)" << endl;
             }
             //~ my->affi = My::A_SEUIL;
             //~ my->set_recalc(My::R_SEUIL);
@@ -851,34 +820,72 @@ int onKeyPressEvent (int key, void *data)
     return 1;
 }
 
-void choose_type_algo(cv::Mat img_niv, cv::Mat eltStruct)
+//--------------------------------- B A T C H ---------------------------------
+
+typedef void (*OperationMorpho)(cv::Mat, cv::Mat, cv::Point);
+
+/*
+ * Opération morphologique avec l'élément structurant de l'image @nom_es,
+ * seuillé à 127 comme dans la boucle interactive. ouverture et fermeture
+ * retournent l'élément structurant : chaque appel travaille sur une copie.
+ */
+OperationBatch fabriquer_morpho (const std::string &nom_es, OperationMorpho op)
 {
-	int imgTaille = img_niv.rows + img_niv.cols;
-	int eSTaille = eltStruct.rows + eltStruct.cols;
-	imgTaille/= 10;
-
-	cout << "type algo : ";
-	if (eSTaille <= LIMITE_ELT_STRUCT
-		|| eSTaille < imgTaille) {
-		g_typeAlgo = RECURSIF;
-		std::cout << "récursif" << endl;
-	}
-	else {
-		g_typeAlgo = ITERATIF;
-		std::cout << "itératif" << endl;
-	}
+    cv::Mat img_srcES = cv::imread (nom_es, cv::IMREAD_COLOR);
+    if (img_srcES.empty())
+        throw std::runtime_error("élément structurant '" + nom_es + "' illisible");
+    cv::Mat img_gryES, img_eltStruct;
+    cv::cvtColor (img_srcES, img_gryES, cv::COLOR_BGR2GRAY);
+    cv::threshold (img_gryES, img_gryES, 127, 255, cv::THRESH_BINARY);
+    img_gryES.convertTo (img_eltStruct, CV_32SC1,1., 0.);
+
+    return [img_eltStruct, op](cv::Mat img_niv) {
+        cv::Mat es = img_eltStruct.clone();
+        cv::Point centreES;
+        adapt_eltStruct(es, centreES);
+        op(img_niv, es, centreES);
+    };
+}
+
+CatalogueBatch catalogue_batch ()
+{
+    struct { const char *nom, *aide; OperationMorpho op; } ops[] = {
+        { "dilatation",   "dilatation",                dilatation },
+        { "erosion",      "érosion",                   erosion },
+        { "ouverture",    "ouverture",                 ouverture },
+        { "fermeture",    "fermeture",                 fermeture },
+        { "gradient_inf", "gradient intérieur",        gradient_inf },
+        { "gradient_ext", "gradient extérieur",        gradient_externe },
+        { "gradient",     "gradient morphologique",    gradient_morphologique },
+        { "laplacien",    "laplacien morphologique",   laplacien_morphologique },
+    };
+    CatalogueBatch cat;
+    for (auto &o : ops)
+    {
+        OperationMorpho op = o.op;
+        cat[o.nom] = { "image_es", o.aide,
+            [op](const std::string &p) { return fabriquer_morpho(p, op); } };
+    }
+    return cat;
 }
 
 //---------------------------------- M A I N ----------------------------------
 
 void afficher_usage (char *nom_prog) {
     std::cout << "Usage: " << nom_prog
-              << "[-mag width height] [-thr seuil] in1 eltStruct [out2] [typeAlgo: -i | -r]"
+              << "[-mag width height] [-thr seuil] [--threads N] in1 eltStruct [out2] [typeAlgo: -l | -b | -i | -r]"
+              << "\n       " << nom_prog << " --batch -h"
+              << "\n       " << nom_prog << " --flux -h"
               << std::endl;
 }
 
 int main (int argc, char**argv)
 {
+    if (argc > 1 && !strcmp(argv[1], "--batch"))
+        return executer_batch (argc-1, argv+1, catalogue_batch());
+    if (argc > 1 && !strcmp(argv[1], "--flux"))
+        return executer_flux (argc-1, argv+1);
+
     My my;
     //~ cout << "my.currDemiMask->nom = " << my.currDemiMask->nom << endl;
     char *nom_in1, *nom_out2, *nom_prog = argv[0];
@@ -895,6 +902,10 @@ int main (int argc, char**argv)
             if (argc-1 < 2) { afficher_usage(nom_prog); return 1; }
             my.seuil = atoi(argv[2]);
             argc -= 2; argv += 2;
+        } else if (!strcmp(argv[1], "--threads")) {
+            if (argc-1 < 2) { afficher_usage(nom_prog); return 1; }
+            definir_nb_threads (atoi(argv[2]));
+            argc -= 2; argv += 2;
         } else break;
     }
     if (argc-1 < 1 or argc-1 > 4) { afficher_usage(nom_prog); return 1; }
@@ -902,7 +913,13 @@ int main (int argc, char**argv)
     nom_eltStruct = argv[2];
     if (argv[3]!=nullptr)
     {
-        if (strcmp(argv[3], "-i") == 0) {
+        if (strcmp(argv[3], "-l") == 0) {
+            g_typeAlgo = LINEAIRE;
+        }
+        else if (strcmp(argv[3], "-b") == 0) {
+            g_typeAlgo = BINAIRE;
+        }
+        else if (strcmp(argv[3], "-i") == 0) {
             g_typeAlgo = ITERATIF;
         }
         else if (strcmp(argv[3], "-r") == 0) {
@@ -951,41 +968,39 @@ int main (int argc, char**argv)
     cv::namedWindow ("Loupe", cv::WINDOW_AUTOSIZE);
     afficher_aide();
 
-	choose_type_algo(my.img_niv, my.img_eltStruct);
-
 
     // Boucle d'événements
     for (;;) {
 
-        if (my.need_recalc(My::R_SEUIL))
-        {
-            // std::cout << "Calcul seuil" << std::endl;
-            cv::Mat img_gry;
-            cv::cvtColor (my.img_src, img_gry, cv::COLOR_BGR2GRAY);
-            cv::threshold (img_gry, img_gry, my.seuil, 255, cv::THRESH_BINARY);
-            img_gry.convertTo (my.img_niv, CV_32SC1,1., 0.);
-
-            cv::Mat img_gryES;
-            cv::cvtColor (my.img_srcES, img_gryES, cv::COLOR_BGR2GRAY);
-            cv::threshold (img_gryES, img_gryES, my.seuil, 255, cv::THRESH_BINARY);
-            img_gryES.convertTo (my.img_eltStruct, CV_32SC1,1., 0.);
-        }
-
+        // le seuil fait partie du graphe de calcul : R_SEUIL et R_TRANSFOS
+        // passent tous les deux par effectuer_transformations
         if (my.need_recalc(My::R_TRANSFOS))
         {
             // std::cout << "Calcul transfos" << std::endl;
-            if (my.affi != My::A_ORIG) {
-                effectuer_transformations (my.affi, my.img_niv, my.img_eltStruct, my.filtre);
-                representer_en_couleurs_vga (my.img_niv, my.img_coul);
-            } else my.img_coul = my.img_src.clone();
+            if (my.affi != My::A_ORIG)
+                effectuer_transformations (my);
+            // couleurs et vue generale calculees par tuiles : celles sous la
+            // loupe tout de suite, les autres a chaque tour de boucle
+            bool orig = my.affi == My::A_ORIG;
+            my.rendu.lancer (my.img_src.rows, my.img_src.cols, [&my, orig](cv::Rect r) {
+                cv::Mat coul = my.img_coul(r), res1 = my.img_res1(r);
+                if (orig) my.img_src(r).copyTo (coul);
+                else representer_en_couleurs_vga (my.img_niv(r), coul);
+                coul.copyTo (res1);
+            });
         }
 
         if (my.need_recalc(My::R_LOUPE)) {
             // std::cout << "Calcul loupe puis affichage" << std::endl;
+            my.rendu.exiger (my.loupe._portion());
             my.loupe.dessiner_rect    (my.img_coul, my.img_res1);
             my.loupe.dessiner_portion (my.img_coul, my.img_res2);
             cv::imshow ("ImageSrc", my.img_res1);
             cv::imshow ("Loupe"   , my.img_res2);
+        } else if (my.rendu.avancer (RENDU_BUDGET_MS)) {
+            // reste de l'image, rendu en tache de fond
+            my.loupe.dessiner_rect (my.img_coul, my.img_res1);
+            cv::imshow ("ImageSrc", my.img_res1);
         }
         my.reset_recalc();
 
@@ -1001,6 +1016,7 @@ int main (int argc, char**argv)
 
     // Enregistrement résultat
     if (nom_out2) {
+        my.rendu.terminer();
         if (! cv::imwrite (nom_out2, my.img_coul))
              std::cout << "Erreur d'enregistrement" << std::endl;
         else std::cout << "Enregistrement effectué" << std::endl;
@@ -14,6 +14,15 @@
 #include <cstring>
 #include <opencv2/opencv.hpp>
 
+#include "Etiquetage.h"
+#include "SuiviContours.h"
+#include "Batch.h"
+#include "Flux.h"
+#include "LoupeVue.h"
+#include "RenduTuiles.h"
+#include "CouleursVGA.h"
+#include "MarquageContours.h"
+
 #define CHECK_MAT_TYPE(mat, format_type) \
     if (mat.type() != int(format_type)) \
         throw std::runtime_error(std::string(__func__) +\
@@ -21,84 +30,6 @@
             "' pour la matrice '" # mat "'");
 
 
-//--------------------------------- L O U P E ---------------------------------
-
-class Loupe {
-  public:
-    int zoom = 5;
-    int zoom_max = 20;
-    int zoom_x0 = 0;
-    int zoom_y0 = 0;
-    int zoom_x1 = 100;
-    int zoom_y1 = 100;
-
-    void reborner (cv::Mat &res1, cv::Mat &res2)
-    {
-        int bon_zoom = zoom >= 1 ? zoom : 1;
-
-        int h = res2.rows / bon_zoom;
-        int w = res2.cols / bon_zoom;
-
-        if (zoom_x0 < 0) zoom_x0 = 0;
-        zoom_x1 = zoom_x0 + w;
-        if (zoom_x1 > res1.cols) {
-            zoom_x1 = res1.cols;
-            zoom_x0 = zoom_x1 - w;
-            if (zoom_x0 < 0) zoom_x0 = 0;
-        }
-
-        if (zoom_y0 < 0) zoom_y0 = 0;
-        zoom_y1 = zoom_y0 + h;
-        if (zoom_y1 > res1.rows) {
-            zoom_y1 = res1.rows;
-            zoom_y0 = zoom_y1 - h;
-            if (zoom_y0 < 0) zoom_y0 = 0;
-        }
-    }
-
-    void deplacer (cv::Mat &res1, cv::Mat &res2, int dx, int dy)
-    {
-        zoom_x0 += dx; zoom_y0 += dy; 
-        zoom_x1 += dx; zoom_y1 += dy; 
-        reborner (res1, res2);
-    }
-
-    void dessiner_rect (cv::Mat &src, cv::Mat &dest)
-    {
-        dest = src.clone();
-        if (zoom == 0) return;
-        cv::Point p0 = cv::Point(zoom_x0, zoom_y0),
-                  p1 = cv::Point(zoom_x1, zoom_y1);
-        cv::rectangle(dest, p0, p1, cv::Scalar (255, 255, 255), 3, 4);
-        cv::rectangle(dest, p0, p1, cv::Scalar (  0,   0, 255), 1, 4);
-    }
-
-    void dessiner_portion (cv::Mat &src, cv::Mat &dest)
-    {
-        CHECK_MAT_TYPE(src, CV_8UC3)
-
-        int bon_zoom = zoom >= 1 ? zoom : 1;
-
-        for (int y = 0; y < dest.rows; y++)
-        for (int x = 0; x < dest.cols; x++)
-        {
-            int x0 = zoom_x0 + x / bon_zoom;
-            int y0 = zoom_y0 + y / bon_zoom;
-
-            if (x0 < 0 || x0 >= src.cols || y0 < 0 || y0 >= src.rows) {
-                dest.at<cv::Vec3b>(y,x)[0] = 64;
-                dest.at<cv::Vec3b>(y,x)[1] = 64;
-                dest.at<cv::Vec3b>(y,x)[2] = 64;
-                continue;
-            }
-            dest.at<cv::Vec3b>(y,x)[0] = src.at<cv::Vec3b>(y0,x0)[0];
-            dest.at<cv::Vec3b>(y,x)[1] = src.at<cv::Vec3b>(y0,x0)[1];
-            dest.at<cv::Vec3b>(y,x)[2] = src.at<cv::Vec3b>(y0,x0)[2];
-        }
-    }
-};
-
-
 //----------------------- C O U L E U R S   V G A -----------------------------
 
 void representer_en_couleurs_vga (cv::Mat img_niv, cv::Mat img_coul)
@@ -106,36 +37,9 @@ void representer_en_couleurs_vga (cv::Mat img_niv, cv::Mat img_coul)
     CHECK_MAT_TYPE(img_niv, CV_32SC1)
     CHECK_MAT_TYPE(img_coul, CV_8UC3)
 
-    unsigned char couls[16][3] = {  // R, G, B
-        {   0,   0,   0 },   //  0  black           ->  0 uniquement
-        {  20,  20, 190 },   //  1  blue            ->  1, 15, 29, ...
-        {  30, 200,  30 },   //  2  green           ->  2, 16, 30, ...
-        {  30, 200, 200 },   //  3  cyan            ->  3, 17, 31, ...
-        { 200,  30,  30 },   //  4  red             ->  4, 18, 32, ...
-        { 200,  30, 200 },   //  5  magenta         ->  5, 19, 33, ...
-        { 200, 130,  50 },   //  6  brown           ->  6, 20, 34, ...
-        { 200, 200, 200 },   //  7  light gray      ->  7, 21, 35, ...
-        { 110, 110, 140 },   //  8  dark gray       ->  8, 22, 36, ...
-        {  84, 130, 252 },   //  9  light blue      ->  9, 23, 37, ...
-        {  84, 252,  84 },   // 10  light green     -> 10, 24, 38, ...
-        {  84, 252, 252 },   // 11  light cyan      -> 11, 25, 39, ...
-        { 252,  84,  84 },   // 12  light red       -> 12, 26, 40, ...
-        { 252,  84, 252 },   // 13  light magenta   -> 13, 27, 41, ...
-        { 252, 252,  84 },   // 14  yellow          -> 14, 28, 42, ...
-        { 252, 252, 252 },   // 15  white           -> 255 uniquement
-    };
-
-    for (int y = 0; y < img_niv.rows; y++)
-    for (int x = 0; x < img_niv.cols; x++)
-    {
-        int g = img_niv.at<int>(y,x), c = 0;
-        if (g == 255) c = 15;                      // seul 255 est blanc
-        else if (g != 0) c = 1 + abs(g-1) % 14;    // seul 0 est noir
-        // Attention img_coul est en B, G, R -> inverser les canaux
-        img_coul.at<cv::Vec3b>(y,x)[0] = couls[c][2];
-        img_coul.at<cv::Vec3b>(y,x)[1] = couls[c][1];
-        img_coul.at<cv::Vec3b>(y,x)[2] = couls[c][0];
-    }
+    // 0 noir, 255 blanc, sinon la couleur 1 + |g-1| % 14 de la palette
+    // VGA : conversion vectorisee (AVX2 si dispo), voir commun/CouleursVGA.h
+    colorier_vga (img_niv, img_coul);
 }
 
 
@@ -144,7 +48,8 @@ void representer_en_couleurs_vga (cv::Mat img_niv, cv::Mat img_coul)
 class My {
   public:
     cv::Mat img_src, img_res1, img_res2, img_niv, img_coul;
-    Loupe loupe;
+    LoupeVue loupe;
+    RenduTuiles rendu;   //couleurs rendues par tuiles, a la demande
     int seuil = 127;
     int clic_x = 0;
     int clic_y = 0;
@@ -169,13 +74,7 @@ void inverser_couleurs (cv::Mat img)
 {
     CHECK_MAT_TYPE(img, CV_8UC3)
 
-    for (int y = 0; y < img.rows; y++)
-    for (int x = 0; x < img.cols; x++)
-    {
-        img.at<cv::Vec3b>(y,x)[0] = 255 - img.at<cv::Vec3b>(y,x)[0];
-        img.at<cv::Vec3b>(y,x)[1] = 255 - img.at<cv::Vec3b>(y,x)[1];
-        img.at<cv::Vec3b>(y,x)[2] = 255 - img.at<cv::Vec3b>(y,x)[2];
-    }
+    complementer_couleurs (img);
 }
 
 
@@ -187,25 +86,9 @@ void marquer_contours_c8 (cv::Mat img_niv) // exercice a
 {
     CHECK_MAT_TYPE(img_niv, CV_32SC1)
 
-    for (int y = 0; y < img_niv.rows-1; y++)
-    {
-    for (int x = 0; x < img_niv.cols-1; x++)
-    {
-        int g = img_niv.at<int>(y,x);
-        //if (g > 0) {
-        //    img_niv.at<int>(y,x) = y;
-        if (g!=0)
-        {
-			if (x==0 || x==img_niv.cols-1 // on verifie chaque pixel du 4-voisinage si celui-ci est un point contour
-				|| y==0 || y==img_niv.rows-1 
-				|| img_niv.at<int>(y,x-1)==0 
-				|| img_niv.at<int>(y,x+1)==0
-				|| img_niv.at<int>(y-1,x)==0 
-				|| img_niv.at<int>(y+1,x)==0)
-				img_niv.at<int>(y,x) = 1; //on lui met la label 1 si c'est un point contour
-		}
-        }
-    }
+    // point contour : pixel de la forme dont un 4-voisin est du fond ou hors
+    // de l'image, voir commun/MarquageContours.h
+    marquer_contours (img_niv, 8);
 }
 
 
@@ -213,40 +96,20 @@ void marquer_contours_c4 (cv::Mat img_niv) //exercice b
 {
     CHECK_MAT_TYPE(img_niv, CV_32SC1)
 
-    for (int y = 0; y < img_niv.rows; y++)
-    for (int x = 0; x < img_niv.cols; x++)
-    {
-        int g = img_niv.at<int>(y,x);
-        //if (g > 0) {
-        //   img_niv.at<int>(y,x) = x;
-        if (g!=0)
-        {
-			if (x==0 || x==img_niv.cols-1 //on verifie chaque pixel du 8-voisinage si celui-ci est un point contour
-				|| y==0 || y==img_niv.rows-1
-				|| img_niv.at<int>(y-1,x-1)==0 
-				|| img_niv.at<int>(y,x-1)==0
-				|| img_niv.at<int>(y+1,x-1)==0 
-				|| img_niv.at<int>(y,x+1)==0
-				|| img_niv.at<int>(y-1,x)==0 
-				|| img_niv.at<int>(y-1,x+1)==0
-				|| img_niv.at<int>(y+1,x+1)==0  
-				|| img_niv.at<int>(y+1,x)==0)
-				img_niv.at<int>(y,x) = 1; //on lui met la label 1 si c'est un point contour
-		}
-    }
+    // point contour : pixel de la forme dont un 8-voisin est du fond ou hors
+    // de l'image, voir commun/MarquageContours.h
+    marquer_contours (img_niv, 4);
 }
 
 
 void numeroter_contours_c8 (cv::Mat img_niv) //exercice final
 {
     CHECK_MAT_TYPE(img_niv, CV_32SC1)
-    
-    //int label=1; //variable pour l'etape 1 seule (sans groupe d'equivalence)
-    int label_max=1;
-    std::vector<int> p8v(8,0); //liste des pixels appartenant au 8-voisinage
-    std::vector<int> label_dispo; //liste des labels disponibles pour chaque pixel
-    std::vector<std::vector<int>> tab_eq; //groupe d'equivalence
-    
+
+    //composantes 8-connexes par union-find (voir commun/Etiquetage.h) :
+    //chaque point contour prend le numero de sa composante
+    Etiquetage etiq (img_niv, 8);
+
     for (int y = 0; y < img_niv.rows; y++)
     for (int x = 0; x < img_niv.cols; x++)
     {
@@ -259,135 +122,22 @@ void numeroter_contours_c8 (cv::Mat img_niv) //exercice final
 				|| img_niv.at<int>(y,x+1)==0
 				|| img_niv.at<int>(y-1,x)==0 
 				|| img_niv.at<int>(y+1,x)==0)
-                {
-                //etape 1 seule (sans groupe d'equivalence)
-                    
-                /*if (img_niv.at<int>(y-1,x-1)!=0 && img_niv.at<int>(y-1,x-1)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y-1,x-1);
-                else if (img_niv.at<int>(y-1,x)!=0 && img_niv.at<int>(y-1,x)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y-1,x);
-                else if (img_niv.at<int>(y-1,x+1)!=0 && img_niv.at<int>(y-1,x+1)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y-1,x+1);
-                else if (img_niv.at<int>(y,x-1)!=0 && img_niv.at<int>(y,x-1)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y,x-1);
-                else if (img_niv.at<int>(y,x+1)!=0 && img_niv.at<int>(y,x+1)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y,x+1);
-                else if (img_niv.at<int>(y+1,x-1)!=0 && img_niv.at<int>(y+1,x-1)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y+1,x-1);
-                else if (img_niv.at<int>(y+1,x)!=0 && img_niv.at<int>(y+1,x)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y+1,x);
-                else if (img_niv.at<int>(y+1,x+1)!=0 && img_niv.at<int>(y+1,x+1)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y+1,x+1);
-                else {
-                    img_niv.at<int>(y,x)=label;
-                    label++;
-                    if (label==255) label++;}
-                }*/
-                
-                // etape 1 + groupe d'equivalence => exercice final
-                
-                //p8v contient la valeur des pixels appartenant au 8-voisinage du pixel ou l'on se trouve
-                p8v[0]=img_niv.at<int>(y,x-1);
-                p8v[1]=img_niv.at<int>(y-1,x-1);
-                p8v[2]=img_niv.at<int>(y-1,x);
-                p8v[3]=img_niv.at<int>(y-1,x+1);
-                p8v[4]=img_niv.at<int>(y,x+1);
-                p8v[5]=img_niv.at<int>(y+1,x-1);
-                p8v[6]=img_niv.at<int>(y+1,x);
-                p8v[7]=img_niv.at<int>(y+1,x+1);
-                for (int i=0; i<8; i++)
-                    {if ((p8v[i]!=0) && (p8v[i]!=255)) label_dispo.push_back(p8v[i]);}
-                if (label_dispo.size()==0) //si aucun label n'est disponible
-                    {
-                        img_niv.at<int>(y,x)=label_max; //le pixel prend la valeur d'un nouveau label
-                        label_max++;
-                        if (label_max==255) label_max++; //on ignore la valeur 255 qui est la valeur pour la forme dans l'image
-                    }
-                else if (label_dispo.size()==1) //si un seul label est disponible
-                    {
-                        img_niv.at<int>(y,x)=label_dispo[0]; //le pixel prend la valeur de ce label
-                        label_dispo.pop_back();
-                    }
-                else //si plusieurs labels sont disponibles 
-                    {   
-                        tab_eq.push_back(label_dispo); //on remplit notre table d'equivalence
-                        //for (int j=0; j<label_dispo.size(); j++)
-                        //    std::cout << label_dispo[j] << "  ";
-                        //std::cout << std::endl;
-                        img_niv.at<int>(y,x)=label_dispo[0]; //le pixel prend la valeur d'un des labels disponibles
-                        while (!label_dispo.empty()) label_dispo.pop_back(); //on vide notre liste de label disponible pour le prochain pixel
-                    }
-                }
+            {
+                int label = etiq.etiquette(x, y);
+                if (label >= 255) label++; //on ignore la valeur 255 qui est la valeur pour la forme dans l'image
+                img_niv.at<int>(y,x) = label;
+            }
         }
     }
 }
 
 // ****************************** TP2 ******************************
 
-void suivre_un_contour_c8 (cv::Mat img_niv, int xA, int yA, int dirA, int num_contour)
-{
-    // 1) recherche de la direction d'arrivee sur xA,yA :
-    //    on tourne autour de xA,yA dans le sens croissant à partir de dirA
-    int nx8[]={1,1,0,-1,-1,-1,0,1};
-    int ny8[]={0,1,1,1,0,-1,-1,-1};
-    int d=0, dir_finale=0;
-    for (int i=0; i<8; i++){
-        d = (dirA+i) % 8;
-        // si N8(A,d) est dans l'image et > 0:
-        if ((img_niv.at<int>(yA+ny8[d],xA+nx8[d])>0) && (!(xA+nx8[d] < 0 || xA+nx8[d] >= img_niv.cols || yA+ny8[d] < 0 || yA+ny8[d] >= img_niv.rows)))
-        {
-            dir_finale=(d+4)%8;
-            break;
-        }
-    }
-    // 2) suivi et marquage du contour
-    int x = xA, y = yA, dir = dir_finale;
-    do 
-    {
-        img_niv.at<int>(y,x)=num_contour;
-        // direction de départ pour chercher le point suivant
-        dir = (dir+4-1) % 8;
-        // on tourne autour de x,y dans le sens décroissant à partir de dir
-        for (int i=0; i<8; i++)
-        {
-            d = (dir+8-i) % 8;
-            //Q = N8((x,y),d)
-            if ((img_niv.at<int>(y+ny8[d],x+nx8[d])>0) && (!(x+nx8[d] < 0 || x+nx8[d] >= img_niv.cols || y+ny8[d] < 0 || y+ny8[d] >= img_niv.rows)))
-            { 
-                y = y+ny8[d];
-                x = x+nx8[d]; 
-                dir = d;
-                // emplacement pour mémoriser d dans la chaîne de Freeman
-                break;
-            }
-        if (i==8) break; // aucun point trouvé -> point isolé
-        }
-    } while (!(x==xA && y==yA && dir==dir_finale));
-}
-
-
 void effectuer_suivi_contours_c8(cv::Mat img_niv)
 {
-    int num_contour = 1;
-    int dir;
-    for (int y = 0; y < img_niv.rows; y++)
-        for (int x = 0; x < img_niv.cols; x++)
-        {
-            int g = img_niv.at<int>(y,x);
-            if (g==255)
-            {
-                dir=-1; //pas trouve
-                if (x==img_niv.cols-1 || img_niv.at<int>(y,x+1)==0) dir=0;
-                else if (y==img_niv.rows-1 || img_niv.at<int>(y+1,x)==0) dir=2;
-                else if (x==0 || img_niv.at<int>(y,x-1)==0) dir=4;
-                else if (y==0 || img_niv.at<int>(y-1,x)==0) dir=6;
-                if (dir>=0) //trouve
-                {
-                    suivre_un_contour_c8 (img_niv, x, y, dir, num_contour++);
-                    if (num_contour==255) num_contour++;
-                }
-            }
-        }
+    //un contour par germe de Etiquetage (exterieur ou trou), suivi dans le
+    //sens des directions decroissantes, voir commun/SuiviContours.h
+    suivre_contours_c8 (img_niv);
 }
 
 
@@ -546,16 +296,40 @@ int onKeyPressEvent (int key, void *data)
 }
 
 
+//--------------------------------- B A T C H ---------------------------------
+
+CatalogueBatch catalogue_batch ()
+{
+    CatalogueBatch cat;
+    cat["contours8"] = { "", "marque les contours 8-connexes",
+        [](const std::string &) { return OperationBatch(marquer_contours_c8); } };
+    cat["contours4"] = { "", "marque les contours 4-connexes",
+        [](const std::string &) { return OperationBatch(marquer_contours_c4); } };
+    cat["numeroter"] = { "", "numérote les contours 8-connexes",
+        [](const std::string &) { return OperationBatch(numeroter_contours_c8); } };
+    cat["suivi"] = { "", "suit et numérote chaque contour",
+        [](const std::string &) { return OperationBatch(
+            [](cv::Mat img_niv) { effectuer_suivi_contours_c8 (img_niv); }); } };
+    return cat;
+}
+
 //---------------------------------- M A I N ----------------------------------
 
 void afficher_usage (char *nom_prog) {
     std::cout << "Usage: " << nom_prog
               << "[-mag width height] [-thr seuil] in1 [out2]" 
+              << "\n       " << nom_prog << " --batch -h"
+              << "\n       " << nom_prog << " --flux -h"
               << std::endl;
 }
 
 int main (int argc, char**argv)
 {
+    if (argc > 1 && !strcmp(argv[1], "--batch"))
+        return executer_batch (argc-1, argv+1, catalogue_batch());
+    if (argc > 1 && !strcmp(argv[1], "--flux"))
+        return executer_flux (argc-1, argv+1);
+
     My my;
     char *nom_in1, *nom_out2, *nom_prog = argv[0];
     int zoom_w = 600, zoom_h = 500;
@@ -616,18 +390,30 @@ int main (int argc, char**argv)
         if (my.need_recalc(My::R_TRANSFOS))
         {
             // std::cout << "Calcul transfos" << std::endl;
-            if (my.affi != My::A_ORIG) {
+            if (my.affi != My::A_ORIG)
                 effectuer_transformations (my.affi, my.img_niv);
-                representer_en_couleurs_vga (my.img_niv, my.img_coul);
-            } else my.img_coul = my.img_src.clone();
+            // couleurs et vue generale calculees par tuiles : celles sous la
+            // loupe tout de suite, les autres a chaque tour de boucle
+            bool orig = my.affi == My::A_ORIG;
+            my.rendu.lancer (my.img_src.rows, my.img_src.cols, [&my, orig](cv::Rect r) {
+                cv::Mat coul = my.img_coul(r), res1 = my.img_res1(r);
+                if (orig) my.img_src(r).copyTo (coul);
+                else representer_en_couleurs_vga (my.img_niv(r), coul);
+                coul.copyTo (res1);
+            });
         }
 
         if (my.need_recalc(My::R_LOUPE)) {
             // std::cout << "Calcul loupe puis affichage" << std::endl;
+            my.rendu.exiger (my.loupe._portion());
             my.loupe.dessiner_rect    (my.img_coul, my.img_res1);
             my.loupe.dessiner_portion (my.img_coul, my.img_res2);
             cv::imshow ("ImageSrc", my.img_res1);
             cv::imshow ("Loupe"   , my.img_res2);
+        } else if (my.rendu.avancer (RENDU_BUDGET_MS)) {
+            // reste de l'image, rendu en tache de fond
+            my.loupe.dessiner_rect (my.img_coul, my.img_res1);
+            cv::imshow ("ImageSrc", my.img_res1);
         }
         my.reset_recalc();
 
@@ -643,6 +429,7 @@ int main (int argc, char**argv)
 
     // Enregistrement résultat
     if (nom_out2) {
+        my.rendu.terminer();
         if (! cv::imwrite (nom_out2, my.img_coul))
              std::cout << "Erreur d'enregistrement" << std::endl;
         else std::cout << "Enregistrement effectué" << std::endl;
@@ -14,6 +14,17 @@
 #include <cstring>
 #include <opencv2/opencv.hpp>
 
+#include "Etiquetage.h"
+#include "SuiviContours.h"
+#include "ContoursF8.h"
+#include "ApproxPolygonale.h"
+#include "Batch.h"
+#include "Flux.h"
+#include "LoupeVue.h"
+#include "RenduTuiles.h"
+#include "CouleursVGA.h"
+#include "MarquageContours.h"
+
 #define CHECK_MAT_TYPE(mat, format_type) \
     if (mat.type() != int(format_type)) \
         throw std::runtime_error(std::string(__func__) +\
@@ -21,84 +32,6 @@
             "' pour la matrice '" # mat "'");
 
 
-//--------------------------------- L O U P E ---------------------------------
-
-class Loupe {
-  public:
-    int zoom = 5;
-    int zoom_max = 20;
-    int zoom_x0 = 0;
-    int zoom_y0 = 0;
-    int zoom_x1 = 100;
-    int zoom_y1 = 100;
-
-    void reborner (cv::Mat &res1, cv::Mat &res2)
-    {
-        int bon_zoom = zoom >= 1 ? zoom : 1;
-
-        int h = res2.rows / bon_zoom;
-        int w = res2.cols / bon_zoom;
-
-        if (zoom_x0 < 0) zoom_x0 = 0;
-        zoom_x1 = zoom_x0 + w;
-        if (zoom_x1 > res1.cols) {
-            zoom_x1 = res1.cols;
-            zoom_x0 = zoom_x1 - w;
-            if (zoom_x0 < 0) zoom_x0 = 0;
-        }
-
-        if (zoom_y0 < 0) zoom_y0 = 0;
-        zoom_y1 = zoom_y0 + h;
-        if (zoom_y1 > res1.rows) {
-            zoom_y1 = res1.rows;
-            zoom_y0 = zoom_y1 - h;
-            if (zoom_y0 < 0) zoom_y0 = 0;
-        }
-    }
-
-    void deplacer (cv::Mat &res1, cv::Mat &res2, int dx, int dy)
-    {
-        zoom_x0 += dx; zoom_y0 += dy; 
-        zoom_x1 += dx; zoom_y1 += dy; 
-        reborner (res1, res2);
-    }
-
-    void dessiner_rect (cv::Mat &src, cv::Mat &dest)
-    {
-        dest = src.clone();
-        if (zoom == 0) return;
-        cv::Point p0 = cv::Point(zoom_x0, zoom_y0),
-                  p1 = cv::Point(zoom_x1, zoom_y1);
-        cv::rectangle(dest, p0, p1, cv::Scalar (255, 255, 255), 3, 4);
-        cv::rectangle(dest, p0, p1, cv::Scalar (  0,   0, 255), 1, 4);
-    }
-
-    void dessiner_portion (cv::Mat &src, cv::Mat &dest)
-    {
-        CHECK_MAT_TYPE(src, CV_8UC3)
-
-        int bon_zoom = zoom >= 1 ? zoom : 1;
-
-        for (int y = 0; y < dest.rows; y++)
-        for (int x = 0; x < dest.cols; x++)
-        {
-            int x0 = zoom_x0 + x / bon_zoom;
-            int y0 = zoom_y0 + y / bon_zoom;
-
-            if (x0 < 0 || x0 >= src.cols || y0 < 0 || y0 >= src.rows) {
-                dest.at<cv::Vec3b>(y,x)[0] = 64;
-                dest.at<cv::Vec3b>(y,x)[1] = 64;
-                dest.at<cv::Vec3b>(y,x)[2] = 64;
-                continue;
-            }
-            dest.at<cv::Vec3b>(y,x)[0] = src.at<cv::Vec3b>(y0,x0)[0];
-            dest.at<cv::Vec3b>(y,x)[1] = src.at<cv::Vec3b>(y0,x0)[1];
-            dest.at<cv::Vec3b>(y,x)[2] = src.at<cv::Vec3b>(y0,x0)[2];
-        }
-    }
-};
-
-
 //----------------------- C O U L E U R S   V G A -----------------------------
 
 void representer_en_couleurs_vga (cv::Mat img_niv, cv::Mat img_coul)
@@ -106,36 +39,9 @@ void representer_en_couleurs_vga (cv::Mat img_niv, cv::Mat img_coul)
     CHECK_MAT_TYPE(img_niv, CV_32SC1)
     CHECK_MAT_TYPE(img_coul, CV_8UC3)
 
-    unsigned char couls[16][3] = {  // R, G, B
-        {   0,   0,   0 },   //  0  black           ->  0 uniquement
-        {  20,  20, 190 },   //  1  blue            ->  1, 15, 29, ...
-        {  30, 200,  30 },   //  2  green           ->  2, 16, 30, ...
-        {  30, 200, 200 },   //  3  cyan            ->  3, 17, 31, ...
-        { 200,  30,  30 },   //  4  red             ->  4, 18, 32, ...
-        { 200,  30, 200 },   //  5  magenta         ->  5, 19, 33, ...
-        { 200, 130,  50 },   //  6  brown           ->  6, 20, 34, ...
-        { 200, 200, 200 },   //  7  light gray      ->  7, 21, 35, ...
-        { 110, 110, 140 },   //  8  dark gray       ->  8, 22, 36, ...
-        {  84, 130, 252 },   //  9  light blue      ->  9, 23, 37, ...
-        {  84, 252,  84 },   // 10  light green     -> 10, 24, 38, ...
-        {  84, 252, 252 },   // 11  light cyan      -> 11, 25, 39, ...
-        { 252,  84,  84 },   // 12  light red       -> 12, 26, 40, ...
-        { 252,  84, 252 },   // 13  light magenta   -> 13, 27, 41, ...
-        { 252, 252,  84 },   // 14  yellow          -> 14, 28, 42, ...
-        { 252, 252, 252 },   // 15  white           -> 255 uniquement
-    };
-
-    for (int y = 0; y < img_niv.rows; y++)
-    for (int x = 0; x < img_niv.cols; x++)
-    {
-        int g = img_niv.at<int>(y,x), c = 0;
-        if (g == 255) c = 15;                      // seul 255 est blanc
-        else if (g != 0) c = 1 + abs(g-1) % 14;    // seul 0 est noir
-        // Attention img_coul est en B, G, R -> inverser les canaux
-        img_coul.at<cv::Vec3b>(y,x)[0] = couls[c][2];
-        img_coul.at<cv::Vec3b>(y,x)[1] = couls[c][1];
-        img_coul.at<cv::Vec3b>(y,x)[2] = couls[c][0];
-    }
+    // 0 noir, 255 blanc, sinon la couleur 1 + |g-1| % 14 de la palette
+    // VGA : conversion vectorisee (AVX2 si dispo), voir commun/CouleursVGA.h
+    colorier_vga (img_niv, img_coul);
 }
 
 
@@ -144,13 +50,15 @@ void representer_en_couleurs_vga (cv::Mat img_niv, cv::Mat img_coul)
 class My {
   public:
     cv::Mat img_src, img_res1, img_res2, img_niv, img_coul;
-    Loupe loupe;
+    LoupeVue loupe;
+    RenduTuiles rendu;   //couleurs rendues par tuiles, a la demande
     int seuil = 127;
     int clic_x = 0;
     int clic_y = 0;
     int clic_n = 0;
     
     int polyg = 250;
+    bool enveloppe = false;     //approximation accelerée par enveloppes convexes
 
     enum Recalc { R_RIEN, R_LOUPE, R_TRANSFOS, R_SEUIL, R_POLYG };
     Recalc recalc = R_SEUIL;
@@ -171,13 +79,7 @@ void inverser_couleurs (cv::Mat img)
 {
     CHECK_MAT_TYPE(img, CV_8UC3)
 
-    for (int y = 0; y < img.rows; y++)
-    for (int x = 0; x < img.cols; x++)
-    {
-        img.at<cv::Vec3b>(y,x)[0] = 255 - img.at<cv::Vec3b>(y,x)[0];
-        img.at<cv::Vec3b>(y,x)[1] = 255 - img.at<cv::Vec3b>(y,x)[1];
-        img.at<cv::Vec3b>(y,x)[2] = 255 - img.at<cv::Vec3b>(y,x)[2];
-    }
+    complementer_couleurs (img);
 }
 
 
@@ -189,25 +91,9 @@ void marquer_contours_c8 (cv::Mat img_niv) // exercice a
 {
     CHECK_MAT_TYPE(img_niv, CV_32SC1)
 
-    for (int y = 0; y < img_niv.rows-1; y++)
-    {
-    for (int x = 0; x < img_niv.cols-1; x++)
-    {
-        int g = img_niv.at<int>(y,x);
-        //if (g > 0) {
-        //    img_niv.at<int>(y,x) = y;
-        if (g!=0)
-        {
-			if (x==0 || x==img_niv.cols-1 // on verifie chaque pixel du 4-voisinage si celui-ci est un point contour
-				|| y==0 || y==img_niv.rows-1 
-				|| img_niv.at<int>(y,x-1)==0 
-				|| img_niv.at<int>(y,x+1)==0
-				|| img_niv.at<int>(y-1,x)==0 
-				|| img_niv.at<int>(y+1,x)==0)
-				img_niv.at<int>(y,x) = 1; //on lui met la label 1 si c'est un point contour
-		}
-        }
-    }
+    // point contour : pixel de la forme dont un 4-voisin est du fond ou hors
+    // de l'image, voir commun/MarquageContours.h
+    marquer_contours (img_niv, 8);
 }
 
 
@@ -215,40 +101,20 @@ void marquer_contours_c4 (cv::Mat img_niv) //exercice b
 {
     CHECK_MAT_TYPE(img_niv, CV_32SC1)
 
-    for (int y = 0; y < img_niv.rows; y++)
-    for (int x = 0; x < img_niv.cols; x++)
-    {
-        int g = img_niv.at<int>(y,x);
-        //if (g > 0) {
-        //   img_niv.at<int>(y,x) = x;
-        if (g!=0)
-        {
-			if (x==0 || x==img_niv.cols-1 //on verifie chaque pixel du 8-voisinage si celui-ci est un point contour
-				|| y==0 || y==img_niv.rows-1
-				|| img_niv.at<int>(y-1,x-1)==0 
-				|| img_niv.at<int>(y,x-1)==0
-				|| img_niv.at<int>(y+1,x-1)==0 
-				|| img_niv.at<int>(y,x+1)==0
-				|| img_niv.at<int>(y-1,x)==0 
-				|| img_niv.at<int>(y-1,x+1)==0
-				|| img_niv.at<int>(y+1,x+1)==0  
-				|| img_niv.at<int>(y+1,x)==0)
-				img_niv.at<int>(y,x) = 1; //on lui met la label 1 si c'est un point contour
-		}
-    }
+    // point contour : pixel de la forme dont un 8-voisin est du fond ou hors
+    // de l'image, voir commun/MarquageContours.h
+    marquer_contours (img_niv, 4);
 }
 
 
 void numeroter_contours_c8 (cv::Mat img_niv) //exercice final
 {
     CHECK_MAT_TYPE(img_niv, CV_32SC1)
-    
-    //int label=1; //variable pour l'etape 1 seule (sans groupe d'equivalence)
-    int label_max=1;
-    std::vector<int> p8v(8,0); //liste des pixels appartenant au 8-voisinage
-    std::vector<int> label_dispo; //liste des labels disponibles pour chaque pixel
-    std::vector<std::vector<int>> tab_eq; //groupe d'equivalence
-    
+
+    //composantes 8-connexes par union-find (voir commun/Etiquetage.h) :
+    //chaque point contour prend le numero de sa composante
+    Etiquetage etiq (img_niv, 8);
+
     for (int y = 0; y < img_niv.rows; y++)
     for (int x = 0; x < img_niv.cols; x++)
     {
@@ -261,269 +127,85 @@ void numeroter_contours_c8 (cv::Mat img_niv) //exercice final
 				|| img_niv.at<int>(y,x+1)==0
 				|| img_niv.at<int>(y-1,x)==0 
 				|| img_niv.at<int>(y+1,x)==0)
-                {
-                //etape 1 seule (sans groupe d'equivalence)
-                    
-                /*if (img_niv.at<int>(y-1,x-1)!=0 && img_niv.at<int>(y-1,x-1)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y-1,x-1);
-                else if (img_niv.at<int>(y-1,x)!=0 && img_niv.at<int>(y-1,x)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y-1,x);
-                else if (img_niv.at<int>(y-1,x+1)!=0 && img_niv.at<int>(y-1,x+1)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y-1,x+1);
-                else if (img_niv.at<int>(y,x-1)!=0 && img_niv.at<int>(y,x-1)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y,x-1);
-                else if (img_niv.at<int>(y,x+1)!=0 && img_niv.at<int>(y,x+1)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y,x+1);
-                else if (img_niv.at<int>(y+1,x-1)!=0 && img_niv.at<int>(y+1,x-1)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y+1,x-1);
-                else if (img_niv.at<int>(y+1,x)!=0 && img_niv.at<int>(y+1,x)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y+1,x);
-                else if (img_niv.at<int>(y+1,x+1)!=0 && img_niv.at<int>(y+1,x+1)!=255)
-                    img_niv.at<int>(y,x)=img_niv.at<int>(y+1,x+1);
-                else {
-                    img_niv.at<int>(y,x)=label;
-                    label++;
-                    if (label==255) label++;}
-                }*/
-                
-                // etape 1 + groupe d'equivalence => exercice final
-                
-                //p8v contient la valeur des pixels appartenant au 8-voisinage du pixel ou l'on se trouve
-                p8v[0]=img_niv.at<int>(y,x-1);
-                p8v[1]=img_niv.at<int>(y-1,x-1);
-                p8v[2]=img_niv.at<int>(y-1,x);
-                p8v[3]=img_niv.at<int>(y-1,x+1);
-                p8v[4]=img_niv.at<int>(y,x+1);
-                p8v[5]=img_niv.at<int>(y+1,x-1);
-                p8v[6]=img_niv.at<int>(y+1,x);
-                p8v[7]=img_niv.at<int>(y+1,x+1);
-                for (int i=0; i<8; i++)
-                    {if ((p8v[i]!=0) && (p8v[i]!=255)) label_dispo.push_back(p8v[i]);}
-                if (label_dispo.size()==0) //si aucun label n'est disponible
-                    {
-                        img_niv.at<int>(y,x)=label_max; //le pixel prend la valeur d'un nouveau label
-                        label_max++;
-                        if (label_max==255) label_max++; //on ignore la valeur 255 qui est la valeur pour la forme dans l'image
-                    }
-                else if (label_dispo.size()==1) //si un seul label est disponible
-                    {
-                        img_niv.at<int>(y,x)=label_dispo[0]; //le pixel prend la valeur de ce label
-                        label_dispo.pop_back();
-                    }
-                else //si plusieurs labels sont disponibles 
-                    {   
-                        tab_eq.push_back(label_dispo); //on remplit notre table d'equivalence
-                        //for (int j=0; j<label_dispo.size(); j++)
-                        //    std::cout << label_dispo[j] << "  ";
-                        //std::cout << std::endl;
-                        img_niv.at<int>(y,x)=label_dispo[0]; //le pixel prend la valeur d'un des labels disponibles
-                        while (!label_dispo.empty()) label_dispo.pop_back(); //on vide notre liste de label disponible pour le prochain pixel
-                    }
-                }
+            {
+                int label = etiq.etiquette(x, y);
+                if (label >= 255) label++; //on ignore la valeur 255 qui est la valeur pour la forme dans l'image
+                img_niv.at<int>(y,x) = label;
+            }
         }
     }
 }
 
 // ****************************** TP2 ******************************
 
-//structure TP3
-struct ContourF8 {
-    int xA;
-    int yA;
-    std::vector<int> cdf;
-    unsigned int t_cdf;
-};
+//structure TP3 : les ContourF8 (point de depart + chaine de Freeman) sont
+//ranges dans un ContoursF8, 3 bits par direction, voir commun/ContoursF8.h
 
 struct ContourPol {
-    std::vector<int> cx;
-    std::vector<int> cy;
+    std::vector<cv::Point> pts;  //points du contour, de A a F = A
     std::vector<int> flag;
     unsigned int t_c;
 };
 
-void suivre_un_contour_c8 (cv::Mat img_niv, int xA, int yA, int dirA, int num_contour, std::vector<ContourF8> memo_contour)
-{
-    // 1) recherche de la direction d'arrivee sur xA,yA :
-    //    on tourne autour de xA,yA dans le sens croissant à partir de dirA
-    int nx8[]={1,1,0,-1,-1,-1,0,1};
-    int ny8[]={0,1,1,1,0,-1,-1,-1};
-    int d=0, dir_finale=0;
-    
-    // TP3
-    //int taille=0;
-    std::vector<int> cdf;
-    //ContourF8 cF8 {xA, yA, cdf, taille};
-    
-    for (int i=0; i<8; i++){
-        d = (dirA+i) % 8;
-        // si N8(A,d) est dans l'image et > 0:
-        if ((img_niv.at<int>(yA+ny8[d],xA+nx8[d])>0) && (!(xA+nx8[d] < 0 || xA+nx8[d] >= img_niv.cols || yA+ny8[d] < 0 || yA+ny8[d] >= img_niv.rows)))
-        {
-            dir_finale=(d+4)%8;
-            break;
-        }
-    }
-    // 2) suivi et marquage du contour
-    int x = xA, y = yA, dir = dir_finale;
-    do 
-    {
-        img_niv.at<int>(y,x)=num_contour;
-        // direction de départ pour chercher le point suivant
-        dir = (dir+4-1) % 8;
-        // on tourne autour de x,y dans le sens décroissant à partir de dir
-        for (int i=0; i<8; i++)
-        {
-            d = (dir+8-i) % 8;
-            //Q = N8((x,y),d)
-            if ((img_niv.at<int>(y+ny8[d],x+nx8[d])>0) && (!(x+nx8[d] < 0 || x+nx8[d] >= img_niv.cols || y+ny8[d] < 0 || y+ny8[d] >= img_niv.rows)))
-            { 
-                y = y+ny8[d];
-                x = x+nx8[d]; 
-                dir = d;
-                // emplacement pour mémoriser d dans la chaîne de Freeman
-                cdf.push_back(d);
-                break;
-            }
-        if (i==8) break; // aucun point trouvé -> point isolé
-        }
-    } while (!(x==xA && y==yA && dir==dir_finale));
-    
-    // TP3
-    memo_contour.push_back({xA, yA, cdf, cdf.size()});
-    
-    while (!cdf.empty()) cdf.pop_back(); 
-}
-
-
-void effectuer_suivi_contours_c8(cv::Mat img_niv)
+void effectuer_suivi_contours_c8(cv::Mat img_niv, ContoursF8 &memo_contour)
 {
     // TP3 - chaine de freeman a memoriser
-    std::vector<ContourF8> memo_contour;
-    
-    int num_contour = 1;
-    int dir;
-    for (int y = 0; y < img_niv.rows; y++)
-        for (int x = 0; x < img_niv.cols; x++)
-        {
-            int g = img_niv.at<int>(y,x);
-            if (g==255)
-            {
-                dir=-1; //pas trouve
-                if (x==img_niv.cols-1 || img_niv.at<int>(y,x+1)==0) dir=0;
-                else if (y==img_niv.rows-1 || img_niv.at<int>(y+1,x)==0) dir=2;
-                else if (x==0 || img_niv.at<int>(y,x-1)==0) dir=4;
-                else if (y==0 || img_niv.at<int>(y-1,x)==0) dir=6;
-                if (dir>=0) //trouve
-                {
-                    suivre_un_contour_c8 (img_niv, x, y, dir, num_contour++, memo_contour);
-                    if (num_contour==255) num_contour++;
-                }
-            }
-        }
+    //un contour par germe de Etiquetage (exterieur ou trou), suivi dans le
+    //sens des directions decroissantes, voir commun/SuiviContours.h
+    suivre_contours_c8 (img_niv, memo_contour);
 }
 
 // ********************* TP3 ********************
 
-int e_dist(int xA, int yA, int xB, int yB) {return sqrt((xB-xA)*(xB-xA) + (yB-yA)*(yB-yA));}
-
-std::vector<int> far_point(int xA, int yA, std::vector<int> cx, std::vector<int> cy, unsigned int t_cdf) //retourne B le plus eloigne de A
+//approximation de Douglas-Peucker avec une pile de morceaux sur le tableau
+//des points du contour, en distances entieres exactes (et en option par
+//enveloppes convexes), voir commun/ApproxPolygonale.h
+void approximer_contour_c8 (const ContoursF8 &contours, int c, double seuil, ApproxPolygonale &approx, ContourPol &cp)
 {
-    double dist=0;
-    int xbmax=0;
-    int ybmax=0;
-    std::vector<int> coords;
-    for (int i=0; i<t_cdf; i++)
-    {
-        int xB=cx[i];
-        int yB=cy[i];
-        if (e_dist(xA, yA, xB, yB)>dist)
-        {
-            xbmax=xB; //coord x du point B la plus eloigne de A
-            ybmax=yB; //coord y du point B la plus eloigne de A
-        }
-    }
-    coords.push_back(xbmax);
-    coords.push_back(ybmax);
+    //calcul coord point contour, decodes a la volee depuis la chaine de freeman
+    //(point initial A, ..., point final F = A) ; cp est reutilise d'un contour
+    //a l'autre pour ne pas reallouer
+    cp.t_c = contours.taille(c) + 1;
+    cp.pts.clear();
+    for (ContoursF8::Iterateur it = contours.debut(c); it != contours.fin(c); ++it)
+        cp.pts.push_back(*it);
     
-    return coords;
+    //etape 1 : B le plus eloigne de A, etape 2 : decoupage de [A..B] et [B..F]
+    approx.approximer_ferme(cp.pts.data(), cp.t_c, seuil, cp.flag);
 }
 
-void contour_dmax(int xdeb, int ydeb, int xfin, int yfin, std::vector<int> cx, std::vector<int> cy, unsigned int t_cdf)
-{   
-    int dmax, xq, yq=0;
-    if (e_dist(xdeb, ydeb, xfin, yfin) <= 2) return;
-    else 
+void colorier_morceaux(const ContourPol &cp, cv::Mat img_niv)
+{
+    //colorie les pixels : le morceau k va du sommet k-1 (exclu) au sommet k
+    //(inclus), le point A etant colorie comme point final F
+    int couleur = 1;
+    for (unsigned int i=1; i<cp.t_c; i++)
     {
-        for (int i=0; i<t_cdf; i++)
+        img_niv.at<int>(cp.pts[i].y,cp.pts[i].x) = couleur;
+        if (cp.flag[i] == 1)
         {
-        xq=cx[i];
-        yq=cy[i];
+            couleur++;
+            if (couleur==255) couleur++;
         }
-        /*if (e_dist(xA, yA, xB, yB)>dist)
-        }
-        return;*/
     }
 }
-ContourPol approximer_contour_c8 (ContourF8 cf, double seuil)
-{
-    //calcul coord point contour
-    int xA=cf.xA;
-    int yA=cf.yA;
-    std::vector<int> cx;
-    std::vector<int> cy;
-    std::vector<int> flag;
-    
-    int nx8[]={1,1,0,-1,-1,-1,0,1};
-    int ny8[]={0,1,1,1,0,-1,-1,-1};
-    
-    std::vector<int> cdf=cf.cdf;
-    cx.push_back(xA); //point initial A
-    cy.push_back(yA);
-    flag.push_back(1);
-    for (int i=1; i<cf.t_cdf; i++) //calcul coords contour depuis la chaine de freeman cdf
-    {
-        cx.push_back(cx[i-1]+nx8[cdf[i]]);
-        cy.push_back(cy[i-1]+ny8[cdf[i]]);
-        flag.push_back(1); //on met tous les flags "est sommet" a 1 au debut
-    }
-    cx.push_back(xA); //point final F
-    cy.push_back(yA);
-    flag.push_back(1);
-    
-    
-    //etape 1 
-    // coords [A..B]
-    int xbmax = far_point(xA, yA, cx, cy, cf.t_cdf)[0]; 
-    int ybmax = far_point(xA, yA, cx, cy, cf.t_cdf)[1];
-    
-    // coords [B..F]
-    int xfmax = far_point(xbmax, ybmax, cx, cy, cf.t_cdf)[0];
-    int yfmax = far_point(xbmax, ybmax, cx, cy, cf.t_cdf)[1];
-    
-    //etape 2
-    contour_dmax(xA, yA, xbmax, ybmax, cx, cy, cf.t_cdf);
-}
-
-void colorier_morceaux(ContourPol cp, cv::Mat img_niv)
-{
-    std::vector<int> cx = cp.cx;
-    std::vector<int> cy = cp.cy;
-    std::vector<int> flag = cp.flag;
-    //int t_c= cp.t_c;
-    //colorie les pixels
-}
 
-void approximer_et_colorier_contours_c8(std::vector<ContourF8> list_contour, double seuil, cv::Mat img_niv)
+void approximer_et_colorier_contours_c8(const ContoursF8 &list_contour, double seuil, cv::Mat img_niv, bool enveloppe)
 {
-    /*for (unsigned int i=0; i<list_contour.size(); i++)
+    ApproxPolygonale approx (enveloppe);
+    ContourPol cp;
+    for (int i=0; i<list_contour._nb_contours(); i++)
         {
-            colorier_morceaux(approximer_contour_c8 (list_contour[i], seuil),img_niv);
-        }*/
+            approximer_contour_c8 (list_contour, i, seuil, approx, cp);
+            colorier_morceaux(cp, img_niv);
+        }
 }
 
 // Appelez ici vos transformations selon affi
-void effectuer_transformations (My::Affi affi, cv::Mat img_niv, int polyg)
+void effectuer_transformations (My::Affi affi, cv::Mat img_niv, int polyg, bool enveloppe)
 {
+    ContoursF8 memo_contour;
+    
     switch (affi) {
         case My::A_TRANS1 :
             marquer_contours_c8 (img_niv);
@@ -535,10 +217,11 @@ void effectuer_transformations (My::Affi affi, cv::Mat img_niv, int polyg)
             numeroter_contours_c8 (img_niv);
             break;
         case My::A_TRANS4 :
-            effectuer_suivi_contours_c8 (img_niv);
+            effectuer_suivi_contours_c8 (img_niv, memo_contour);
             break;
         case My::A_TRANS5 :
-            effectuer_suivi_contours_c8 (img_niv);
+            effectuer_suivi_contours_c8 (img_niv, memo_contour);
+            approximer_et_colorier_contours_c8 (memo_contour, polyg / 100.0, img_niv, enveloppe);
             break;
         default : ;
     }
@@ -601,6 +284,7 @@ void afficher_aide() {
         "Touches du clavier:\n"
         "   a    affiche cette aide\n"
         " hHlL   change la taille de la loupe\n"
+        "   e    approximation par enveloppes convexes (oui/non)\n"
         "   i    inverse les couleurs de src\n"
         "   o    affiche l'image src originale\n"
         "   s    affiche l'image src seuillée\n"
@@ -640,6 +324,12 @@ int onKeyPressEvent (int key, void *data)
             my->loupe.reborner(my->img_res1, my->img_res2);
             my->set_recalc(My::R_LOUPE);
           } break;
+        case 'e' :
+            my->enveloppe = !my->enveloppe;
+            std::cout << "Approximation par enveloppes : "
+                      << (my->enveloppe ? "oui" : "non") << std::endl;
+            my->set_recalc(My::R_POLYG);
+            break;
         case 'i' :
             std::cout << "Couleurs inversées" << std::endl;
             inverser_couleurs(my->img_src);
@@ -690,17 +380,53 @@ int onKeyPressEvent (int key, void *data)
 }
 
 
+//--------------------------------- B A T C H ---------------------------------
+
+CatalogueBatch catalogue_batch ()
+{
+    CatalogueBatch cat;
+    cat["contours8"] = { "", "marque les contours 8-connexes",
+        [](const std::string &) { return OperationBatch(marquer_contours_c8); } };
+    cat["contours4"] = { "", "marque les contours 4-connexes",
+        [](const std::string &) { return OperationBatch(marquer_contours_c4); } };
+    cat["numeroter"] = { "", "numérote les contours 8-connexes",
+        [](const std::string &) { return OperationBatch(numeroter_contours_c8); } };
+    cat["suivi"] = { "", "suit et numérote chaque contour",
+        [](const std::string &) { return OperationBatch([](cv::Mat img_niv) {
+            ContoursF8 memo_contour;
+            effectuer_suivi_contours_c8 (img_niv, memo_contour);
+        }); } };
+    cat["polyg"] = { "seuil[,env]", "suivi puis approximation polygonale coloriée",
+        [](const std::string &p) {
+            double seuil = p.empty() ? 2.0 : std::stod(p);
+            bool enveloppe = p.find(",env") != std::string::npos;
+            return OperationBatch([seuil, enveloppe](cv::Mat img_niv) {
+                ContoursF8 memo_contour;
+                effectuer_suivi_contours_c8 (img_niv, memo_contour);
+                approximer_et_colorier_contours_c8 (memo_contour, seuil, img_niv, enveloppe);
+            });
+        } };
+    return cat;
+}
+
 //---------------------------------- M A I N ----------------------------------
 
 void afficher_usage (char *nom_prog) {
     std::cout << "Usage: " << nom_prog
               << "[-mag width height] [-thr seuil] in1 [out2]" 
+              << "\n       " << nom_prog << " --batch -h"
+              << "\n       " << nom_prog << " --flux -h"
               << std::endl;
 }
 
 
 int main (int argc, char**argv)
 {
+    if (argc > 1 && !strcmp(argv[1], "--batch"))
+        return executer_batch (argc-1, argv+1, catalogue_batch());
+    if (argc > 1 && !strcmp(argv[1], "--flux"))
+        return executer_flux (argc-1, argv+1);
+
     My my;
     char *nom_in1, *nom_out2, *nom_prog = argv[0];
     int zoom_w = 600, zoom_h = 500;
@@ -763,18 +489,30 @@ int main (int argc, char**argv)
         if (my.need_recalc(My::R_TRANSFOS))
         {
             // std::cout << "Calcul transfos" << std::endl;
-            if (my.affi != My::A_ORIG) {
-                effectuer_transformations (my.affi, my.img_niv, my.polyg);
-                representer_en_couleurs_vga (my.img_niv, my.img_coul);
-            } else my.img_coul = my.img_src.clone();
+            if (my.affi != My::A_ORIG)
+                effectuer_transformations (my.affi, my.img_niv, my.polyg, my.enveloppe);
+            // couleurs et vue generale calculees par tuiles : celles sous la
+            // loupe tout de suite, les autres a chaque tour de boucle
+            bool orig = my.affi == My::A_ORIG;
+            my.rendu.lancer (my.img_src.rows, my.img_src.cols, [&my, orig](cv::Rect r) {
+                cv::Mat coul = my.img_coul(r), res1 = my.img_res1(r);
+                if (orig) my.img_src(r).copyTo (coul);
+                else representer_en_couleurs_vga (my.img_niv(r), coul);
+                coul.copyTo (res1);
+            });
         }
 
         if (my.need_recalc(My::R_LOUPE)) {
             // std::cout << "Calcul loupe puis affichage" << std::endl;
+            my.rendu.exiger (my.loupe._portion());
             my.loupe.dessiner_rect    (my.img_coul, my.img_res1);
             my.loupe.dessiner_portion (my.img_coul, my.img_res2);
             cv::imshow ("ImageSrc", my.img_res1);
             cv::imshow ("Loupe"   , my.img_res2);
+        } else if (my.rendu.avancer (RENDU_BUDGET_MS)) {
+            // reste de l'image, rendu en tache de fond
+            my.loupe.dessiner_rect (my.img_coul, my.img_res1);
+            cv::imshow ("ImageSrc", my.img_res1);
         }
         my.reset_recalc();
 
@@ -790,6 +528,7 @@ int main (int argc, char**argv)
 
     // Enregistrement résultat
     if (nom_out2) {
+        my.rendu.terminer();
         if (! cv::imwrite (nom_out2, my.img_coul))
              std::cout << "Erreur d'enregistrement" << std::endl;
         else std::cout << "Enregistrement effectué" << std::endl;
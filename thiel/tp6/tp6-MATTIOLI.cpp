@@ -20,6 +20,18 @@
 #include <cstring>
 #include <opencv2/opencv.hpp>
 
+#include "PoolThreads.h"
+#include "Sedt.h"
+#include "NiveauxSedt.h"
+#include "DemiMasque.h"
+#include "Chanfrein.h"
+#include "GrapheCalcul.h"
+#include "Batch.h"
+#include "Flux.h"
+#include "LoupeVue.h"
+#include "RenduTuiles.h"
+#include "CouleursVGA.h"
+
 
 #define CHECK_MAT_TYPE(mat, format_type) \
     if (mat.type() != int(format_type)) \
@@ -28,84 +40,6 @@
             "' pour la matrice '" # mat "'");
 
 
-//--------------------------------- L O U P E ---------------------------------
-
-class Loupe {
-  public:
-    int zoom = 5;
-    int zoom_max = 20;
-    int zoom_x0 = 0;
-    int zoom_y0 = 0;
-    int zoom_x1 = 100;
-    int zoom_y1 = 100;
-
-    void reborner (cv::Mat &res1, cv::Mat &res2)
-    {
-        int bon_zoom = zoom >= 1 ? zoom : 1;
-
-        int h = res2.rows / bon_zoom;
-        int w = res2.cols / bon_zoom;
-
-        if (zoom_x0 < 0) zoom_x0 = 0;
-        zoom_x1 = zoom_x0 + w;
-        if (zoom_x1 > res1.cols) {
-            zoom_x1 = res1.cols;
-            zoom_x0 = zoom_x1 - w;
-            if (zoom_x0 < 0) zoom_x0 = 0;
-        }
-
-        if (zoom_y0 < 0) zoom_y0 = 0;
-        zoom_y1 = zoom_y0 + h;
-        if (zoom_y1 > res1.rows) {
-            zoom_y1 = res1.rows;
-            zoom_y0 = zoom_y1 - h;
-            if (zoom_y0 < 0) zoom_y0 = 0;
-        }
-    }
-
-    void deplacer (cv::Mat &res1, cv::Mat &res2, int dx, int dy)
-    {
-        zoom_x0 += dx; zoom_y0 += dy; 
-        zoom_x1 += dx; zoom_y1 += dy; 
-        reborner (res1, res2);
-    }
-
-    void dessiner_rect (cv::Mat &src, cv::Mat &dest)
-    {
-        dest = src.clone();
-        if (zoom == 0) return;
-        cv::Point p0 = cv::Point(zoom_x0, zoom_y0),
-                  p1 = cv::Point(zoom_x1, zoom_y1);
-        cv::rectangle(dest, p0, p1, cv::Scalar (255, 255, 255), 3, 4);
-        cv::rectangle(dest, p0, p1, cv::Scalar (  0,   0, 255), 1, 4);
-    }
-
-    void dessiner_portion (cv::Mat &src, cv::Mat &dest)
-    {
-        CHECK_MAT_TYPE(src, CV_8UC3)
-
-        int bon_zoom = zoom >= 1 ? zoom : 1;
-
-        for (int y = 0; y < dest.rows; y++)
-        for (int x = 0; x < dest.cols; x++)
-        {
-            int x0 = zoom_x0 + x / bon_zoom;
-            int y0 = zoom_y0 + y / bon_zoom;
-
-            if (x0 < 0 || x0 >= src.cols || y0 < 0 || y0 >= src.rows) {
-                dest.at<cv::Vec3b>(y,x)[0] = 64;
-                dest.at<cv::Vec3b>(y,x)[1] = 64;
-                dest.at<cv::Vec3b>(y,x)[2] = 64;
-                continue;
-            }
-            dest.at<cv::Vec3b>(y,x)[0] = src.at<cv::Vec3b>(y0,x0)[0];
-            dest.at<cv::Vec3b>(y,x)[1] = src.at<cv::Vec3b>(y0,x0)[1];
-            dest.at<cv::Vec3b>(y,x)[2] = src.at<cv::Vec3b>(y0,x0)[2];
-        }
-    }
-};
-
-
 //----------------------- C O U L E U R S   V G A -----------------------------
 
 void representer_en_couleurs_vga (cv::Mat img_niv, cv::Mat img_coul)
@@ -113,36 +47,9 @@ void representer_en_couleurs_vga (cv::Mat img_niv, cv::Mat img_coul)
     CHECK_MAT_TYPE(img_niv, CV_32SC1)
     CHECK_MAT_TYPE(img_coul, CV_8UC3)
 
-    unsigned char couls[16][3] = {  // R, G, B
-        {   0,   0,   0 },   //  0  black           ->  0 uniquement
-        {  20,  20, 190 },   //  1  blue            ->  1, 15, 29, ...
-        {  30, 200,  30 },   //  2  green           ->  2, 16, 30, ...
-        {  30, 200, 200 },   //  3  cyan            ->  3, 17, 31, ...
-        { 200,  30,  30 },   //  4  red             ->  4, 18, 32, ...
-        { 200,  30, 200 },   //  5  magenta         ->  5, 19, 33, ...
-        { 200, 130,  50 },   //  6  brown           ->  6, 20, 34, ...
-        { 200, 200, 200 },   //  7  light gray      ->  7, 21, 35, ...
-        { 110, 110, 140 },   //  8  dark gray       ->  8, 22, 36, ...
-        {  84, 130, 252 },   //  9  light blue      ->  9, 23, 37, ...
-        {  84, 252,  84 },   // 10  light green     -> 10, 24, 38, ...
-        {  84, 252, 252 },   // 11  light cyan      -> 11, 25, 39, ...
-        { 252,  84,  84 },   // 12  light red       -> 12, 26, 40, ...
-        { 252,  84, 252 },   // 13  light magenta   -> 13, 27, 41, ...
-        { 252, 252,  84 },   // 14  yellow          -> 14, 28, 42, ...
-        { 252, 252, 252 },   // 15  white           -> 255 uniquement
-    };
-
-    for (int y = 0; y < img_niv.rows; y++)
-    for (int x = 0; x < img_niv.cols; x++)
-    {
-        int g = img_niv.at<int>(y,x), c = 0;
-        if (g == 255) c = 15;                      // seul 255 est blanc
-        else if (g != 0) c = 1 + abs(g-1) % 14;    // seul 0 est noir
-        // Attention img_coul est en B, G, R -> inverser les canaux
-        img_coul.at<cv::Vec3b>(y,x)[0] = couls[c][2];
-        img_coul.at<cv::Vec3b>(y,x)[1] = couls[c][1];
-        img_coul.at<cv::Vec3b>(y,x)[2] = couls[c][0];
-    }
+    // 0 noir, 255 blanc, sinon la couleur 1 + |g-1| % 14 de la palette
+    // VGA : conversion vectorisee (AVX2 si dispo), voir commun/CouleursVGA.h
+    colorier_vga (img_niv, img_coul);
 }
 
 
@@ -150,83 +57,15 @@ void representer_en_couleurs_vga (cv::Mat img_niv, cv::Mat img_coul)
 
 // structure TP5 //
 
-enum NumeroMasque {M_D4,M_D8,M_2_3,M_3_4,M_5_7_11,M_LAST};
-
-struct Ponderation
-{
-    int y;
-    int x;
-    int w; //poids (a, b, ...)
-    Ponderation(int y, int x, int w) {this->y=y; this->x=x; this->w=w;}
-};
-
-struct DemiMasque
-{
-    std::vector<Ponderation> list_pond;
-    unsigned int t_pond = list_pond.size();
-    NumeroMasque num_masque;
-    std::string nom_masque;
-    void pond_d8_poids(int a, int b)
-    {
-    list_pond.push_back(Ponderation(1,0,a));
-    list_pond.push_back(Ponderation(1,1,b));
-    list_pond.push_back(Ponderation(0,1,a));
-    list_pond.push_back(Ponderation(-1,1,b));
-    }
-    DemiMasque(NumeroMasque num_masque)
-    {
-        this->num_masque = num_masque;
-        list_pond.clear();
-        
-        switch (num_masque)
-        {
-        case M_D4 : 
-            //std::cout << "d4" << std::endl;
-            nom_masque="M_D4";
-            list_pond.push_back(Ponderation(1,0,1));
-            list_pond.push_back(Ponderation(0,1,1));
-            break;
-        case M_D8: 
-            //std::cout << "d8" << std::endl;
-            nom_masque="M_D8";
-            pond_d8_poids(1, 1);
-            break;
-        case M_2_3 :
-            //std::cout << "d23" << std::endl;
-            nom_masque="M_2_3";
-            pond_d8_poids(2, 3);
-            break;
-        case M_3_4 : 
-            //std::cout << "d34" << std::endl;
-            nom_masque="M_3_4";
-            pond_d8_poids(3, 4);
-            break;
-        case M_5_7_11 : 
-            //std::cout << "M_5_7_11" << std::endl;
-            nom_masque="M_5_7_11";
-            pond_d8_poids(5, 7); //poids a et b
-            // poids c
-            list_pond.push_back(Ponderation(2,1,11));
-            list_pond.push_back(Ponderation(1,2,11));
-            list_pond.push_back(Ponderation(-1,2,11));
-            list_pond.push_back(Ponderation(-2,1,11));
-            break;
-        case M_LAST:
-            //std::cout << "M_LAST" << std::endl;
-            nom_masque = "M_LAST";
-            break;
-        default:
-            break;
-        }
-    }
-};
+// enum NumeroMasque, struct Ponderation et struct DemiMasque : voir DemiMasque.h
 
 // Fin structure TP5 //
 
 class My {
   public:
     cv::Mat img_src, img_res1, img_res2, img_niv, img_coul;
-    Loupe loupe;
+    LoupeVue loupe;
+    RenduTuiles rendu;   //couleurs rendues par tuiles, a la demande
     int seuil = 127;
     int clic_x = 0;
     int clic_y = 0;
@@ -240,12 +79,19 @@ class My {
     int  need_recalc  (Recalc level) { return level <= recalc; }
 
     // Rajoutez ici des codes A_TRANSx pour le calcul et l'affichage
-    enum Affi { A_ORIG, A_SEUIL, A_TRANS1, A_TRANS2, A_TRANS3, A_TRANS4, A_TRANS5, A_TRANS6, A_TRANS7};
+    enum Affi { A_ORIG, A_SEUIL, A_TRANS1, A_TRANS2, A_TRANS3, A_TRANS4, A_TRANS5, A_TRANS6, A_TRANS7, A_TRANS8};
     Affi affi = A_ORIG;
     
     NumeroMasque num_masque = M_D4;
     DemiMasque dm = DemiMasque(num_masque);
     int filtre = 0;
+    bool axe_exact = false; //axe median exact par LUT au lieu des maximums locaux
+
+    //graphe de calcul memorise (voir commun/GrapheCalcul.h) : chaque noeud
+    //n'est recalcule que si la version de son entree ou ses parametres changent
+    long version_src = 0;   //a incrementer quand img_src change
+    NoeudCalcul n_gris, n_seuil, n_dt, n_maxima, n_rdt, n_filtre;
+    NoeudCalcul n_sedt, n_niveaux, n_axe_sedt, n_filtre_sedt;
 };
 
 
@@ -254,217 +100,57 @@ class My {
 
 void calculer_Rosenfeld_DT (cv::Mat img_niv, DemiMasque dm) //algo DT Rosenfeld
 {
-    //Passage Rosenfeld DT avant (avec le symétrique du demi-masque arriere)
-    for (int y = 0; y < img_niv.rows; y++)
-        for (int x = 0; x < img_niv.cols; x++)
-        {
-            if((img_niv.at<int>(y,x)!=0) && (!(x<0||y<0||y>=img_niv.rows||x>=img_niv.cols)))
-            {
-                for(unsigned int i=0; i < dm.list_pond.size(); i++)
-                {
-                    if(img_niv.at<int>(y-dm.list_pond[i].y, x-dm.list_pond[i].x) + dm.list_pond[i].w < img_niv.at<int>(y,x))
-                    img_niv.at<int>(y,x) = img_niv.at<int>(y-dm.list_pond[i].y, x-dm.list_pond[i].x) + dm.list_pond[i].w;
-                }
-            }
-        }
-    //Passage Rosenfeld DT arriere (avec le demi-masque arriere)
-    for (int y = img_niv.rows-1; y >= 0; y--)
-        for (int x = img_niv.cols-1; x >= 0; x--)
-        {
-            if((img_niv.at<int>(y,x)!=0) && (!(x<0||y<0||y>=img_niv.rows||x>=img_niv.cols)))
-            {
-                for(unsigned int i=0; i < dm.list_pond.size(); i++)
-                {
-                    if(img_niv.at<int>(y+dm.list_pond[i].y, x+dm.list_pond[i].x) + dm.list_pond[i].w < img_niv.at<int>(y,x))
-                    img_niv.at<int>(y,x) = img_niv.at<int>(y+dm.list_pond[i].y, x+dm.list_pond[i].x) + dm.list_pond[i].w;
-                }
-            }
-        }
+    //Passages avant et arriere en front d'onde, voir Chanfrein.h
+    calculer_dt_chanfrein (img_niv, dm);
 }
 
 void calculer_Rosenfeld_RDT (cv::Mat img_niv, DemiMasque dm) //algo RDT Rosenfeld
 {
-    //Passage Rosenfeld DT avant (avec le symétrique du demi-masque arriere)
-    for (int y = 0; y < img_niv.rows; y++)
-        for (int x = 0; x < img_niv.cols; x++)
-        {
-            if((img_niv.at<int>(y,x)!=0) && (!(x<0||y<0||y>=img_niv.rows||x>=img_niv.cols)))
-            {
-                for(unsigned int i=0; i < dm.list_pond.size(); i++)
-                {
-                    if(img_niv.at<int>(y-dm.list_pond[i].y, x-dm.list_pond[i].x) - dm.list_pond[i].w > img_niv.at<int>(y,x))
-                    img_niv.at<int>(y,x) = img_niv.at<int>(y-dm.list_pond[i].y, x-dm.list_pond[i].x) - dm.list_pond[i].w;
-                }
-            }
-        }
-    //Passage Rosenfeld DT arriere (avec le demi-masque arriere)
-    for (int y = img_niv.rows-1; y >= 0; y--)
-        for (int x = img_niv.cols-1; x >= 0; x--)
-        {
-            if((img_niv.at<int>(y,x)!=0) && (!(x<0||y<0||y>=img_niv.rows||x>=img_niv.cols)))
-            {
-                for(unsigned int i=0; i < dm.list_pond.size(); i++)
-                {
-                    if(img_niv.at<int>(y+dm.list_pond[i].y, x+dm.list_pond[i].x) - dm.list_pond[i].w > img_niv.at<int>(y,x))
-                    img_niv.at<int>(y,x) = img_niv.at<int>(y+dm.list_pond[i].y, x+dm.list_pond[i].x) - dm.list_pond[i].w;
-                }
-            }
-        }
+    //Passages avant et arriere en front d'onde, voir Chanfrein.h
+    calculer_rdt_chanfrein (img_niv, dm);
 }
 
-void detecter_maximums_locaux (cv::Mat img_niv, DemiMasque dm)
+void detecter_maximums_locaux (cv::Mat img_niv, DemiMasque dm, bool axe_exact)
 {
-    //Construction du masque complet
-    DemiMasque masque_complet = DemiMasque(M_LAST);
-    for(unsigned int i=0; i < dm.list_pond.size(); i++)
-    {
-        masque_complet.list_pond.push_back(dm.list_pond[i]); //demi-masque arriere
-        masque_complet.list_pond.push_back(Ponderation(dm.list_pond[i].x*(-1), dm.list_pond[i].y*(-1), dm.list_pond[i].w*(-1))); //demi-masque avant
-    }
-
-    //Copie de img_niv dans une nouvelle image de test img_dt
-    cv::Mat img_dt = cv::Mat(img_niv.rows, img_niv.cols, CV_32SC1);
-    for (int y = 0; y < img_niv.rows; y++)
-        for (int x = 0; x < img_niv.cols; x++)
-        {
-            img_dt.at<int>(y,x) = img_niv.at<int>(y,x);
-        }
-    
-    //Calcul des maximums locaux de img_dt puis transformation sur img_niv
-    for (int y = 0; y < img_dt.rows; y++)
-        for (int x = 0; x < img_dt.cols; x++)
-        {
-            if (img_niv.at<int>(y,x)!=0)
-            for(unsigned int i=0; i < masque_complet.list_pond.size(); i++)
-            {
-                if(img_dt.at<int>(y,x) < (img_dt.at<int>(y+masque_complet.list_pond[i].y, x+masque_complet.list_pond[i].x)) - masque_complet.list_pond[i].w)
-                {
-                    img_niv.at<int>(y,x) = 0;
-                    break;
-                }
-            }
-        }
+    //Masque complet (et LUT si axe_exact) en cache pour dm, voir Chanfrein.h
+    detecter_maximums_locaux_chanfrein (img_niv, dm, axe_exact);
 }
 
-void filtrer_formes_avec_maximums_locaux (cv::Mat img_niv, DemiMasque dm, int filtre)
+void filtrer_formes_avec_maximums_locaux (cv::Mat img_niv, DemiMasque dm, int filtre, bool axe_exact)
 {
-    //copie de img_niv dans img_filtrage
-    cv::Mat img_filtrage = cv::Mat(img_niv.rows, img_niv.cols, CV_32SC1);
-    calculer_Rosenfeld_DT (img_niv, dm);
-    detecter_maximums_locaux (img_niv, dm);
-    //Couleur des points maximums locaux > filtre = cyan
-    for (int y = 0; y < img_niv.rows; y++)
-        for (int x = 0; x < img_niv.cols; x++)
-        {
-            if(img_niv.at<int>(y,x) <= filtre) 
-                img_filtrage.at<int>(y,x) = 11;
-        }
-    calculer_Rosenfeld_RDT (img_niv, dm);
-    //Couleur des points de la forme obtenue par RDT = gris
-    for (int y = 0; y < img_niv.rows; y++)
-        for (int x = 0; x < img_niv.cols; x++)
-        {
-            if(img_niv.at<int>(y,x) != 0 && img_filtrage.at<int>(y,x)!=11) 
-                img_filtrage.at<int>(y,x) = 8;
-        }
-    //Couleur des points de la forme originale, non retrouvés par RDT = rouge
-    for (int y = 0; y < img_niv.rows; y++)
-        for (int x = 0; x < img_niv.cols; x++)
-        {
-            if(img_niv.at<int>(y,x)>0) img_filtrage.at<int>(y,x) = 12;
-            else img_filtrage.at<int>(y,x) = 0;
-        }
-    //Copie des couleurs de img_filtrage dans l'image img_niv
-    for (int y = 0; y < img_niv.rows; y++)
-        for (int x = 0; x < img_niv.cols; x++)
-            img_niv.at<int>(y,x) = img_filtrage.at<int>(y,x);
+    //DT, maximums locaux > filtre et RDT en un seul tampon :
+    //0 fond, 11 maximums > filtre, 8 forme retrouvee, 12 forme perdue
+    filtrer_axe_median_chanfrein (img_niv, dm, filtre, axe_exact);
 }
 
 // *************** FIN TP5 *************** //
 
 // ********** TP6 ********** //
 
-int dE2(int ya, int xa, int yb, int xb) {return (xb-xa)*(xb-xa)+(yb-ya)*(yb-ya);}
-
+// SEDT exacte en temps linéaire (voir commun/Sedt.h)
 void calculer_sedt_saito_toriwaki (cv::Mat img_niv)
 {
-    // *** premier passage *** //
-    
-    int x0,y0;
-    for (int y = 0; y < img_niv.rows; y++)
-    {
-        for (int x = 0; x < img_niv.cols; x++) //passage gauche-droite
-        {
-            if ((x != img_niv.cols) && (img_niv.at<int>(y,x)==0) && (img_niv.at<int>(y,x+1)!=0))
-            {
-                //coord du point a 0 avant le contour
-                y0=y;
-                x0=x;
-            }
-            if (img_niv.at<int>(y,x)!=0)
-            {
-                img_niv.at<int>(y,x)=dE2(y0,x0,y,x);
-            }
-        }
-        for (int x = img_niv.cols-1; x >= 0; x--) //passage droite-gauche
-        {
-            if ((x != 0) && (img_niv.at<int>(y,x)==0) && (img_niv.at<int>(y,x-1)!=0))
-            {
-                //coord du point a 0 avant le contour
-                y0=y;
-                x0=x;
-            }
-            if (img_niv.at<int>(y,x)!=0)
-            {
-                if ((dE2(y,x,y0,x0)) < img_niv.at<int>(y,x)) img_niv.at<int>(y,x)=dE2(y,x,y0,x0); //on prend le min entre les deux valeurs
-            }
-        }
-    }
-    
-    // *** deuxieme passage *** //
-        
-    int val; //valeur des distances au pixel 0 + le pixel courant
-    int min_col; //minimum de la colonne courante
-    std::vector<int> col; //valeur des pixels de la colonne avec 0 au dessus et en dessous
-    
-    for (int x = 0; x < img_niv.cols; x++)
-    {
-        col.clear(); // R.A.Z de notre colonne
-        //col.push_back(0); //on ajoute un 0 au dessus de la colonne
-        for (int y = 0; y < img_niv.rows; y++)
-            col.push_back(img_niv.at<int>(y,x)); //on prend les valeurs des pixels de la colonne
-        //col.push_back(0); //on ajoute un 0 en dessous de la colonne
-        
-        for (unsigned int i = 0; i < col.size(); i++) //on ignore les 0 ajoute à la colonne
-        {
-            min_col=col[i]; //notre minimum est initialise a la valeur du pixel courant
-            for (int yhaut = i; yhaut >= 0; yhaut--) //passage du pixel courant vers le haut de la colonne
-            {
-                val = col[yhaut]+dE2(i,x,yhaut,x);
-                if(val < min_col) min_col = val;
-                else if(dE2(i,x,yhaut,x) >= min_col) break;
-            }
-            for (unsigned int ybas = i; ybas <= col.size()-1; ybas++) //passage du pixel courant vers le bas de la colonne
-            {
-                val = col[ybas]+dE2(i,x,ybas,x);
-                if(val < min_col) min_col = val;
-                else if(dE2(i,x,ybas,x) >= min_col) break;
-            }
-            img_niv.at<int>(i,x) = min_col; //on change la couleur du pixel courant par min_col
-        }
-    }
+    calculer_sedt_meijster (img_niv, false);
 }
 
 void calculer_sedt_courbes_niveau (cv::Mat img_niv) //calcule les courbes de niveau sur l'image SEDT
 {
-	for (int y = 0; y < img_niv.rows; y++)
-	{
-		for (int x = 0; x < img_niv.cols; x++)
-		{
-			if (img_niv.at<int>(y, x) > 0) 
-				img_niv.at<int>(y, x) = sqrt(img_niv.at<int>(y, x));
-		}
-	}
+    //rayon entier floor(sqrt(d2)) par table de racines, sans flottant
+    //(voir commun/NiveauxSedt.h)
+    NiveauxSedt niveaux;
+    calculer_niveaux_sedt (img_niv, niveaux);
+}
+
+void detecter_axe_median_euclidien (cv::Mat img_niv) //axe median exact sur l'image SEDT
+{
+    //centres des boules gagnantes de la REDT (voir commun/Sedt.h) : pas de
+    //masque de chanfrein, l'axe est exact pour la distance euclidienne
+    axe_median_sedt (img_niv);
+}
+
+void calculer_redt (cv::Mat img_niv) //reconstruction exacte depuis l'axe SEDT
+{
+    calculer_redt_meijster (img_niv);
 }
 
 // ********** FIN TP6 ********** //
@@ -475,13 +161,7 @@ void inverser_couleurs (cv::Mat img)
 {
     CHECK_MAT_TYPE(img, CV_8UC3)
 
-    for (int y = 0; y < img.rows; y++)
-    for (int x = 0; x < img.cols; x++)
-    {
-        img.at<cv::Vec3b>(y,x)[0] = 255 - img.at<cv::Vec3b>(y,x)[0];
-        img.at<cv::Vec3b>(y,x)[1] = 255 - img.at<cv::Vec3b>(y,x)[1];
-        img.at<cv::Vec3b>(y,x)[2] = 255 - img.at<cv::Vec3b>(y,x)[2];
-    }
+    complementer_couleurs (img);
 }
 
 
@@ -532,36 +212,81 @@ void transformer_bandes_diagonales (cv::Mat img_niv)
 }
 
 
-// Appelez ici vos transformations selon affi
-void effectuer_transformations (My::Affi affi, cv::Mat img_niv, DemiMasque dm, int filtre)
+// Appelez ici vos transformations selon affi : le resultat est calcule par
+// le graphe memorise de my, en ne refaisant que les noeuds dont la cle a
+// change, puis recopie dans my.img_niv
+void effectuer_transformations (My &my)
 {
-    switch (affi) {
+    cv::Mat gris = my.n_gris.obtenir ({my.version_src}, [&](cv::Mat &r) {
+        cv::cvtColor (my.img_src, r, cv::COLOR_BGR2GRAY);
+    });
+    cv::Mat niv = my.n_seuil.obtenir ({my.n_gris._version(), my.seuil}, [&](cv::Mat &r) {
+        cv::Mat img_gry;
+        cv::threshold (gris, img_gry, my.seuil, 255, cv::THRESH_BINARY);
+        img_gry.convertTo (r, CV_32SC1,1., 0.);
+    });
+    if (my.affi == My::A_SEUIL) { niv.copyTo (my.img_niv); return; }
+
+    if (my.affi == My::A_TRANS5 || my.affi == My::A_TRANS6 || my.affi == My::A_TRANS7
+        || my.affi == My::A_TRANS8)
+    {
+        cv::Mat sedt = my.n_sedt.obtenir ({my.n_seuil._version()}, [&](cv::Mat &r) {
+            r = niv.clone();
+            calculer_sedt_saito_toriwaki (r);
+        });
+        if (my.affi == My::A_TRANS5) { sedt.copyTo (my.img_niv); return; }
+
+        if (my.affi == My::A_TRANS6) {
+            my.n_niveaux.obtenir ({my.n_sedt._version()}, [&](cv::Mat &r) {
+                r = sedt.clone();
+                calculer_sedt_courbes_niveau (r);
+            }).copyTo (my.img_niv);
+            return;
+        }
+
+        if (my.affi == My::A_TRANS7) {
+            my.n_axe_sedt.obtenir ({my.n_sedt._version()}, [&](cv::Mat &r) {
+                r = sedt.clone();
+                detecter_axe_median_euclidien (r);
+            }).copyTo (my.img_niv);
+            return;
+        }
+
+        //comme A_TRANS4, en euclidien : axe, boules de rayon > filtre, REDT
+        my.n_filtre_sedt.obtenir ({my.n_sedt._version(), my.filtre}, [&](cv::Mat &r) {
+            r = cv::Mat (sedt.rows, sedt.cols, CV_32SC1);
+            filtrer_axe_median_sedt (r, sedt, my.filtre);
+        }).copyTo (my.img_niv);
+        return;
+    }
+
+    cv::Mat dt = my.n_dt.obtenir ({my.n_seuil._version(), my.num_masque}, [&](cv::Mat &r) {
+        r = niv.clone();
+        calculer_Rosenfeld_DT (r, my.dm);
+    });
+
+    switch (my.affi) {
         case My::A_TRANS1 :
-            calculer_Rosenfeld_DT (img_niv, dm);
+            dt.copyTo (my.img_niv);
             break;
         case My::A_TRANS2 :
-            calculer_Rosenfeld_DT (img_niv, dm);
-            detecter_maximums_locaux (img_niv, dm);
-            break;
-        case My::A_TRANS3 :
-            calculer_Rosenfeld_DT (img_niv, dm);
-            detecter_maximums_locaux (img_niv, dm);
-            calculer_Rosenfeld_RDT (img_niv, dm);
-            break;
+        case My::A_TRANS3 : {
+            cv::Mat maxima = my.n_maxima.obtenir ({my.n_dt._version(), my.axe_exact}, [&](cv::Mat &r) {
+                r = dt.clone();
+                detecter_maximums_locaux (r, my.dm, my.axe_exact);
+            });
+            if (my.affi == My::A_TRANS2) { maxima.copyTo (my.img_niv); break; }
+            my.n_rdt.obtenir ({my.n_maxima._version()}, [&](cv::Mat &r) {
+                r = maxima.clone();
+                calculer_Rosenfeld_RDT (r, my.dm);
+            }).copyTo (my.img_niv);
+          } break;
         case My::A_TRANS4 :
-            filtrer_formes_avec_maximums_locaux (img_niv, dm, filtre);
-            break;
-        case My::A_TRANS5 :
-            calculer_sedt_saito_toriwaki (img_niv);
-            break;
-        case My::A_TRANS6 :
-            calculer_sedt_saito_toriwaki(img_niv);
-            calculer_sedt_courbes_niveau(img_niv);
-            break;
-        case My::A_TRANS7 :
-            calculer_sedt_saito_toriwaki(img_niv);
-            calculer_sedt_courbes_niveau(img_niv);
-            detecter_maximums_locaux (img_niv, dm);
+            //meme resultat que filtrer_formes_avec_maximums_locaux, sans refaire la DT
+            my.n_filtre.obtenir ({my.n_dt._version(), my.filtre, my.axe_exact}, [&](cv::Mat &r) {
+                r = cv::Mat (dt.rows, dt.cols, CV_32SC1);
+                filtrer_axe_median_depuis_dt (r, dt, my.dm, my.filtre, my.axe_exact);
+            }).copyTo (my.img_niv);
             break;
         default : ;
     }
@@ -632,9 +357,11 @@ void afficher_aide() {
         "   2    transformation Maximums locaux\n"
         "   3    transformation RDT Rosenfeld\n"
         "   4    transformation Filtrage des maximum locaux\n"
+        "   m    bascule maximums locaux / axe median exact (LUT)\n"
         "   5    transformation SEDT_saito_toriwaki\n"
         "   6    transformation courbes de niveau sur l'image SEDT\n"
-        "   7    transformation Maximums locaux SEDT\n"
+        "   7    transformation Axe median euclidien exact (SEDT)\n"
+        "   8    transformation Filtrage de l'axe euclidien et REDT\n"
         "  esc   quitte\n"
     << std::endl;
 }
@@ -669,6 +396,7 @@ int onKeyPressEvent (int key, void *data)
         case 'i' :
             std::cout << "Couleurs inversées" << std::endl;
             inverser_couleurs(my->img_src);
+            my->version_src++;
             my->set_recalc(My::R_SEUIL);
             break;
         case 'o' :
@@ -717,8 +445,18 @@ int onKeyPressEvent (int key, void *data)
             my->set_recalc(My::R_SEUIL);
             break;
         case '7' :
-            std::cout << "Maximums locaux SEDT" << std::endl;
-            my->affi = My::A_TRANS6;
+            std::cout << "Axe median euclidien" << std::endl;
+            my->affi = My::A_TRANS7;
+            my->set_recalc(My::R_SEUIL);
+            break;
+        case '8' :
+            std::cout << "Filtrage de l'axe euclidien et REDT" << std::endl;
+            my->affi = My::A_TRANS8;
+            my->set_recalc(My::R_SEUIL);
+            break;
+        case 'm' :
+            my->axe_exact = !my->axe_exact;
+            std::cout << (my->axe_exact ? "Axe median exact (LUT)" : "Maximums locaux") << std::endl;
             my->set_recalc(My::R_SEUIL);
             break;
         case 'd' :
@@ -736,16 +474,74 @@ int onKeyPressEvent (int key, void *data)
 }
 
 
+//--------------------------------- B A T C H ---------------------------------
+
+//parametre "masque[,...]" : d4, d8, 2-3, 3-4 ou 5-7-11 (d4 par defaut)
+DemiMasque lire_masque_batch (const std::string &p)
+{
+    std::string nom = p.substr(0, p.find(','));
+    if (nom.empty()) return DemiMasque(M_D4);
+    NumeroMasque num = numero_masque(nom);
+    if (num == M_LAST) throw std::runtime_error("masque inconnu '" + nom + "'");
+    return DemiMasque(num);
+}
+
+CatalogueBatch catalogue_batch ()
+{
+    CatalogueBatch cat;
+    cat["dt"] = { "masque", "DT de Rosenfeld",
+        [](const std::string &p) { DemiMasque dm = lire_masque_batch(p);
+            return OperationBatch([dm](cv::Mat img_niv) { calculer_Rosenfeld_DT (img_niv, dm); }); } };
+    cat["rdt"] = { "masque", "RDT de Rosenfeld",
+        [](const std::string &p) { DemiMasque dm = lire_masque_batch(p);
+            return OperationBatch([dm](cv::Mat img_niv) { calculer_Rosenfeld_RDT (img_niv, dm); }); } };
+    cat["maxima"] = { "masque[,exact]", "maximums locaux d'une DT (axe médian exact avec exact)",
+        [](const std::string &p) { DemiMasque dm = lire_masque_batch(p);
+            bool axe_exact = p.find(",exact") != std::string::npos;
+            return OperationBatch([dm, axe_exact](cv::Mat img_niv) {
+                detecter_maximums_locaux (img_niv, dm, axe_exact); }); } };
+    cat["filtre"] = { "masque,filtre[,exact]", "DT, maximums > filtre puis RDT",
+        [](const std::string &p) { DemiMasque dm = lire_masque_batch(p);
+            size_t v = p.find(',');
+            int filtre = (v == std::string::npos) ? 0 : std::stoi(p.substr(v+1));
+            bool axe_exact = p.find(",exact") != std::string::npos;
+            return OperationBatch([dm, filtre, axe_exact](cv::Mat img_niv) {
+                filtrer_formes_avec_maximums_locaux (img_niv, dm, filtre, axe_exact); }); } };
+    cat["sedt"] = { "", "SEDT de Saito et Toriwaki",
+        [](const std::string &) { return OperationBatch(calculer_sedt_saito_toriwaki); } };
+    cat["niveaux"] = { "", "courbes de niveau d'une SEDT",
+        [](const std::string &) { return OperationBatch(calculer_sedt_courbes_niveau); } };
+    cat["axe_sedt"] = { "", "axe median euclidien exact d'une SEDT",
+        [](const std::string &) { return OperationBatch(detecter_axe_median_euclidien); } };
+    cat["redt"] = { "", "REDT exacte (rayons au carre aux centres)",
+        [](const std::string &) { return OperationBatch(calculer_redt); } };
+    cat["filtre_sedt"] = { "filtre", "SEDT, axe euclidien de rayon > filtre puis REDT",
+        [](const std::string &p) {
+            int filtre = p.empty() ? 0 : std::stoi(p);
+            return OperationBatch([filtre](cv::Mat img_niv) {
+                cv::Mat sedt = img_niv.clone();
+                calculer_sedt_saito_toriwaki (sedt);
+                filtrer_axe_median_sedt (img_niv, sedt, filtre); }); } };
+    return cat;
+}
+
 //---------------------------------- M A I N ----------------------------------
 
 void afficher_usage (char *nom_prog) {
     std::cout << "Usage: " << nom_prog
-              << "[-mag width height] [-thr seuil] in1 [out2]" 
+              << "[-mag width height] [-thr seuil] [--threads N] in1 [out2]" 
+              << "\n       " << nom_prog << " --batch -h"
+              << "\n       " << nom_prog << " --flux -h"
               << std::endl;
 }
 
 int main (int argc, char**argv)
 {
+    if (argc > 1 && !strcmp(argv[1], "--batch"))
+        return executer_batch (argc-1, argv+1, catalogue_batch());
+    if (argc > 1 && !strcmp(argv[1], "--flux"))
+        return executer_flux (argc-1, argv+1);
+
     My my;
     char *nom_in1, *nom_out2, *nom_prog = argv[0];
     int zoom_w = 600, zoom_h = 500;
@@ -760,6 +556,10 @@ int main (int argc, char**argv)
             if (argc-1 < 2) { afficher_usage(nom_prog); return 1; }
             my.seuil = atoi(argv[2]);
             argc -= 2; argv += 2;
+        } else if (!strcmp(argv[1], "--threads")) {
+            if (argc-1 < 2) { afficher_usage(nom_prog); return 1; }
+            definir_nb_threads (atoi(argv[2]));
+            argc -= 2; argv += 2;
         } else break;
     }
     if (argc-1 < 1 or argc-1 > 2) { afficher_usage(nom_prog); return 1; }
@@ -796,30 +596,35 @@ int main (int argc, char**argv)
     // Boucle d'événements
     for (;;) {
 
-        if (my.need_recalc(My::R_SEUIL)) 
-        {
-            // std::cout << "Calcul seuil" << std::endl;
-            cv::Mat img_gry;
-            cv::cvtColor (my.img_src, img_gry, cv::COLOR_BGR2GRAY);
-            cv::threshold (img_gry, img_gry, my.seuil, 255, cv::THRESH_BINARY);
-            img_gry.convertTo (my.img_niv, CV_32SC1,1., 0.);
-        }
-
+        // le seuil fait partie du graphe de calcul : R_SEUIL et R_TRANSFOS
+        // passent tous les deux par effectuer_transformations
         if (my.need_recalc(My::R_TRANSFOS))
         {
             // std::cout << "Calcul transfos" << std::endl;
-            if (my.affi != My::A_ORIG) {
-                effectuer_transformations (my.affi, my.img_niv, my.dm, my.filtre);
-                representer_en_couleurs_vga (my.img_niv, my.img_coul);
-            } else my.img_coul = my.img_src.clone();
+            if (my.affi != My::A_ORIG)
+                effectuer_transformations (my);
+            // couleurs et vue generale calculees par tuiles : celles sous la
+            // loupe tout de suite, les autres a chaque tour de boucle
+            bool orig = my.affi == My::A_ORIG;
+            my.rendu.lancer (my.img_src.rows, my.img_src.cols, [&my, orig](cv::Rect r) {
+                cv::Mat coul = my.img_coul(r), res1 = my.img_res1(r);
+                if (orig) my.img_src(r).copyTo (coul);
+                else representer_en_couleurs_vga (my.img_niv(r), coul);
+                coul.copyTo (res1);
+            });
         }
 
         if (my.need_recalc(My::R_LOUPE)) {
             // std::cout << "Calcul loupe puis affichage" << std::endl;
+            my.rendu.exiger (my.loupe._portion());
             my.loupe.dessiner_rect    (my.img_coul, my.img_res1);
             my.loupe.dessiner_portion (my.img_coul, my.img_res2);
             cv::imshow ("ImageSrc", my.img_res1);
             cv::imshow ("Loupe"   , my.img_res2);
+        } else if (my.rendu.avancer (RENDU_BUDGET_MS)) {
+            // reste de l'image, rendu en tache de fond
+            my.loupe.dessiner_rect (my.img_coul, my.img_res1);
+            cv::imshow ("ImageSrc", my.img_res1);
         }
         my.reset_recalc();
 
@@ -835,6 +640,7 @@ int main (int argc, char**argv)
 
     // Enregistrement résultat
     if (nom_out2) {
+        my.rendu.terminer();
         if (! cv::imwrite (nom_out2, my.img_coul))
              std::cout << "Erreur d'enregistrement" << std::endl;
         else std::cout << "Enregistrement effectué" << std::endl;
@@ -45,6 +45,7 @@
 // Inclusions
 #include <iostream>
 #include <vector>
+#include <limits>
 #include "DGtal/base/Common.h"
 #include "DGtal/kernel/NumberTraits.h"
 #include "DGtal/kernel/CPointPredicate.h"
@@ -83,8 +84,13 @@ namespace DGtal
    * @tparam TImageContainer any model of concepts::CImage to store the
    * VoronoiMap (default: ImageContainerBySTLVector). The space of the
    * image container and the TSpace should match. Furthermore the
-   * container value type must be TSpace::Vector.
-    *
+   * container value type must be TSpace::Vector, or an unsigned
+   * integer type for compact site storage (see VoronoiMap).
+   *
+   * To get the raw distances only (e.g. squared Euclidean distances
+   * for the @f$ l_2@f$ metric) with one integer per point, see
+   * computeRawDistanceTransformation.
+   *
    * @see distancetransform2D.cpp
    * @see distancetransform3D.cpp
    */
@@ -125,9 +131,9 @@ namespace DGtal
                          typename SeparableMetric::Point>::value));
 
     ///Definition of the image.
-    typedef  DistanceTransformation<TSpace,TPointPredicate,TSeparableMetric> Self;
+    typedef  DistanceTransformation<TSpace,TPointPredicate,TSeparableMetric,TImageContainer> Self;
 
-    typedef VoronoiMap<TSpace,TPointPredicate,TSeparableMetric> Parent;
+    typedef VoronoiMap<TSpace,TPointPredicate,TSeparableMetric,TImageContainer> Parent;
 
     ///Definition of the image constRange
     typedef  DefaultConstImageRange<Self> ConstRange;
@@ -199,8 +205,7 @@ namespace DGtal
      */
     Value operator()(const Point &aPoint) const
     {
-      return this->myMetricPtr->operator()(aPoint,
-                                           this->myImagePtr->operator()(aPoint));
+      return this->myMetricPtr->operator()(aPoint, Parent::operator()(aPoint));
     }
 
     /**
@@ -211,7 +216,7 @@ namespace DGtal
      */
     Vector getVoronoiVector(const Point &aPoint) const
     {
-      return this->myImagePtr->operator()(aPoint);
+      return Parent::operator()(aPoint);
     }
 
     /**
@@ -253,16 +258,134 @@ namespace DGtal
 // //                                                                           //
 // ///////////////////////////////////////////////////////////////////////////////
 
-  template <typename S,typename P,typename TSep>
+  template <typename S,typename P,typename TSep,typename TI>
   inline
   std::ostream&
   operator<< ( std::ostream & out,
-               const DistanceTransformation<S,P,TSep> & object )
+               const DistanceTransformation<S,P,TSep,TI> & object )
   {
     object.selfDisplay( out );
     return out;
   }
 
+  /**
+   * Computes the raw distance transformation (see
+   * CMetricSpace::rawDistance: the squared Euclidean distance for
+   * the @f$ l_2@f$ metric) into an image of unsigned integers.
+   *
+   * The Voronoi map is computed with compact site storage directly
+   * in @a anImage (see VoronoiMap), then each site index is replaced
+   * in place by the raw distance to that site: the peak memory is
+   * one @a TValue per point, instead of one Vector per point plus
+   * the distances. For instance, a 1024^3 volume needs 4 GB with
+   * DGtal::uint32_t, instead of 12 GB for the Voronoi map alone.
+   *
+   * Raw distances larger than the maximum of @a TValue are saturated
+   * to this maximum, which also marks the points without any site.
+   * With periodic dimensions, the site indices need three times the
+   * extent along each periodic dimension.
+   *
+   * @tparam TSpace type of Digital Space (model of concepts::CSpace).
+   * @tparam TPointPredicate point predicate returning false for the
+   * sites (model of concepts::CPointPredicate).
+   * @tparam TSeparableMetric a model of concepts::CSeparableMetric.
+   * @tparam TValue unsigned integer type of the distances.
+   *
+   * @param [in] aDomain the (hyper-rectangular) domain.
+   * @param [in] predicate the point predicate.
+   * @param [in] aMetric the separable metric.
+   * @param [in,out] anImage the image, of domain @a aDomain, receiving
+   * the raw distances.
+   * @param [in] aPeriodicitySpec the periodicity specification (non
+   * periodic by default).
+   *
+   * @throw std::overflow_error if the site indices do not fit in @a
+   * TValue.
+   */
+  template < typename TSpace, typename TPointPredicate,
+             typename TSeparableMetric, typename TValue >
+  void
+  computeRawDistanceTransformation( const HyperRectDomain<TSpace> & aDomain,
+                                    const TPointPredicate & predicate,
+                                    const TSeparableMetric & aMetric,
+                                    ImageContainerBySTLVector< HyperRectDomain<TSpace>, TValue > & anImage,
+                                    std::array< bool, TSpace::dimension > const & aPeriodicitySpec
+                                      = std::array< bool, TSpace::dimension >() )
+  {
+    typedef ImageContainerBySTLVector< HyperRectDomain<TSpace>, TValue > Image;
+    typedef VoronoiMap< TSpace, TPointPredicate, TSeparableMetric, Image > Voronoi;
+
+    const Voronoi voronoi( aDomain, predicate, aMetric, aPeriodicitySpec, anImage );
+
+    // The domain iterates the points in the order of the image values.
+    const TValue infinity = std::numeric_limits< TValue >::max();
+    typename Image::iterator value = anImage.begin();
+    for ( auto const & pt : aDomain )
+      {
+        if ( *value != infinity )
+          {
+            const auto raw = aMetric.rawDistance( pt, voronoi.decode( *value ) );
+            *value = static_cast< long double >( raw ) < static_cast< long double >( infinity )
+              ? static_cast< TValue >( raw ) : infinity;
+          }
+        ++value;
+      }
+  }
+
+  /**
+   * Computes the raw distance transformation into any image of
+   * unsigned integers with a HyperRectDomain, for instance a
+   * TiledImage (see VoronoiMap for the out-of-core computation): same
+   * as above, the image values being read and written tile by tile
+   * with operator() and setValue.
+   *
+   * @tparam TSpace type of Digital Space (model of concepts::CSpace).
+   * @tparam TPointPredicate point predicate returning false for the
+   * sites (model of concepts::CPointPredicate).
+   * @tparam TSeparableMetric a model of concepts::CSeparableMetric.
+   * @tparam TImage a model of concepts::CImage, of unsigned integer
+   * values.
+   *
+   * @param [in] aDomain the (hyper-rectangular) domain.
+   * @param [in] predicate the point predicate.
+   * @param [in] aMetric the separable metric.
+   * @param [in,out] anImage the image, of domain @a aDomain, receiving
+   * the raw distances.
+   * @param [in] aPeriodicitySpec the periodicity specification (non
+   * periodic by default).
+   *
+   * @throw std::overflow_error if the site indices do not fit in the
+   * image values.
+   */
+  template < typename TSpace, typename TPointPredicate,
+             typename TSeparableMetric, typename TImage >
+  void
+  computeRawDistanceTransformation( const HyperRectDomain<TSpace> & aDomain,
+                                    const TPointPredicate & predicate,
+                                    const TSeparableMetric & aMetric,
+                                    TImage & anImage,
+                                    std::array< bool, TSpace::dimension > const & aPeriodicitySpec
+                                      = std::array< bool, TSpace::dimension >() )
+  {
+    typedef typename TImage::Value Value;
+    typedef VoronoiMap< TSpace, TPointPredicate, TSeparableMetric, TImage > Voronoi;
+
+    const Voronoi voronoi( aDomain, predicate, aMetric, aPeriodicitySpec, anImage );
+
+    const Value infinity = std::numeric_limits< Value >::max();
+    for ( auto const & tile : detail::VoronoiMapImageTiling< TImage >::tileDomains( anImage ) )
+      for ( auto const & pt : tile )
+        {
+          const Value code = anImage( pt );
+          if ( code != infinity )
+            {
+              const auto raw = aMetric.rawDistance( pt, voronoi.decode( code ) );
+              anImage.setValue( pt, static_cast< long double >( raw ) < static_cast< long double >( infinity )
+                                ? static_cast< Value >( raw ) : infinity );
+            }
+        }
+  }
+
 
 
 } // namespace DGtal
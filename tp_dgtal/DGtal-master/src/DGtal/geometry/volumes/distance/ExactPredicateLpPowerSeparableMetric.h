@@ -182,8 +182,8 @@ namespace DGtal
      * straight line.
      *
      * This method is in @f$ O(log(n))@f$ if @a n is the size of the
-     * straight segment. For @f$ l_2@f$ metric (p=2), the method is in
-     * @f$ O(1)@f$.
+     * straight segment. For @f$ l_1@f$ and @f$ l_2@f$ metrics (p=1,
+     * p=2), the method is in @f$ O(1)@f$.
      *
      * @pre u,v and w must be such that u[dim] < v[dim] < w[dim]
      *
@@ -197,7 +197,8 @@ namespace DGtal
      * @param endPoint end point of the segment
      * @param dim direction of the straight line
      *
-     * @return true if (u,w) hides v.
+     * @return true if (u,w) hides v, i.e. if v is strictly the
+     * closest site of no point of the segment.
      */
     bool hiddenByPower(const Point &u,
                           const Weight &wu,
@@ -209,6 +210,66 @@ namespace DGtal
                           const Point &endPoint,
                           const typename Point::UnsignedComponent dim) const;
 
+    // ----------------------- Line kernel (see SeparableMetricTraits) ---------
+    /**
+     * Partial power distance of a weighted site to the points of a
+     * straight line along dimension @a dim, i.e. the sum of @f$
+     * |s_i-x_i|^p@f$ over the dimensions @a i other than @a dim,
+     * minus the weight (the same for all the points @a x of the line).
+     *
+     * @param aSite a site
+     * @param aWeight the weight of the site
+     * @param aLinePoint a point of the line
+     * @param dim direction of the straight line
+     *
+     * @return the partial power distance.
+     */
+    Promoted partialPowerDistance(const Point &aSite,
+                                  const Weight &aWeight,
+                                  const Point &aLinePoint,
+                                  const typename Point::UnsignedComponent dim) const;
+
+    /**
+     * Same as hiddenByPower, from the coordinates of the sites along
+     * the line and their partial power distances to the line.
+     *
+     * @pre ud < vd < wd
+     *
+     * @param ud coordinate of u along the line
+     * @param nu partial power distance of u
+     * @param vd coordinate of v along the line
+     * @param nv partial power distance of v
+     * @param wd coordinate of w along the line
+     * @param nw partial power distance of w
+     * @param lower coordinate of the starting point of the segment
+     * @param upper coordinate of the end point of the segment
+     *
+     * @return true if (u,w) hides v, i.e. if v is strictly the
+     * closest site of no point of the segment.
+     */
+    bool hiddenBy1D(const Abscissa &ud, const Promoted &nu,
+                    const Abscissa &vd, const Promoted &nv,
+                    const Abscissa &wd, const Promoted &nw,
+                    const Abscissa &lower,
+                    const Abscissa &upper) const;
+
+    /**
+     * Same as closestPower, for a point of the line, from the
+     * coordinates of the sites along the line and their partial power
+     * distances to the line.
+     *
+     * @param x coordinate of the origin along the line
+     * @param fd coordinate of the first site along the line
+     * @param nf partial power distance of the first site
+     * @param sd coordinate of the second site along the line
+     * @param ns partial power distance of the second site
+     *
+     * @return a Closest enum: FIRST, SECOND or BOTH.
+     */
+    DGtal::Closest closest1D(const Abscissa &x,
+                             const Abscissa &fd, const Promoted &nf,
+                             const Abscissa &sd, const Promoted &ns) const;
+
 
     /**
      * Writes/Displays the object on an output stream.
@@ -406,6 +467,66 @@ namespace DGtal
                           const Point &endPoint,
                           const typename Point::UnsignedComponent dim) const;
 
+    // ----------------------- Line kernel (see SeparableMetricTraits) ---------
+    /**
+     * Partial power distance of a weighted site to the points of a
+     * straight line along dimension @a dim, i.e. the sum of @f$
+     * |s_i-x_i|^p@f$ over the dimensions @a i other than @a dim,
+     * minus the weight (the same for all the points @a x of the line).
+     *
+     * @param aSite a site
+     * @param aWeight the weight of the site
+     * @param aLinePoint a point of the line
+     * @param dim direction of the straight line
+     *
+     * @return the partial power distance.
+     */
+    Promoted partialPowerDistance(const Point &aSite,
+                                  const Weight &aWeight,
+                                  const Point &aLinePoint,
+                                  const typename Point::UnsignedComponent dim) const;
+
+    /**
+     * Same as hiddenByPower, from the coordinates of the sites along
+     * the line and their partial power distances to the line.
+     *
+     * @pre ud < vd < wd
+     *
+     * @param ud coordinate of u along the line
+     * @param nu partial power distance of u
+     * @param vd coordinate of v along the line
+     * @param nv partial power distance of v
+     * @param wd coordinate of w along the line
+     * @param nw partial power distance of w
+     * @param lower coordinate of the starting point of the segment
+     * @param upper coordinate of the end point of the segment
+     *
+     * @return true if (u,w) hides v, i.e. if v is strictly the
+     * closest site of no point of the segment.
+     */
+    bool hiddenBy1D(const Abscissa &ud, const Promoted &nu,
+                    const Abscissa &vd, const Promoted &nv,
+                    const Abscissa &wd, const Promoted &nw,
+                    const Abscissa &lower,
+                    const Abscissa &upper) const;
+
+    /**
+     * Same as closestPower, for a point of the line, from the
+     * coordinates of the sites along the line and their partial power
+     * distances to the line.
+     *
+     * @param x coordinate of the origin along the line
+     * @param fd coordinate of the first site along the line
+     * @param nf partial power distance of the first site
+     * @param sd coordinate of the second site along the line
+     * @param ns partial power distance of the second site
+     *
+     * @return a Closest enum: FIRST, SECOND or BOTH.
+     */
+    DGtal::Closest closest1D(const Abscissa &x,
+                             const Abscissa &fd, const Promoted &nf,
+                             const Abscissa &sd, const Promoted &ns) const;
+
    // ----------------------- Other services --------------------------------------
     /**
      * Writes/Displays the object on an output stream.
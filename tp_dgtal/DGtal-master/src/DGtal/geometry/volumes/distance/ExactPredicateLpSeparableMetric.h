@@ -187,8 +187,8 @@ namespace DGtal
      * straight line.
      *
      * This method is in @f$ O(log(n))@f$ if @a n is the size of the
-     * straight segment. For @f$ l_2@f$ metric (p=2), the method is in
-     * @f$ O(1)@f$.
+     * straight segment. For @f$ l_1@f$ and @f$ l_2@f$ metrics (p=1,
+     * p=2), the method is in @f$ O(1)@f$.
      *
      * @pre u,v and w must be such that u[dim] < v[dim] < w[dim]
      *
@@ -199,7 +199,8 @@ namespace DGtal
      * @param endPoint end point of the segment
      * @param dim direction of the straight line
      *
-     * @return true if (u,w) hides v (strictly).
+     * @return true if (u,w) hides v, i.e. if v is strictly the
+     * closest site of no point of the segment.
      */
     bool hiddenBy(const Point &u,
                   const Point &v,
@@ -208,6 +209,64 @@ namespace DGtal
                   const Point &endPoint,
                   const typename Point::UnsignedComponent dim) const;
 
+    // ----------------------- Line kernel (see SeparableMetricTraits) ---------
+    /**
+     * Partial raw distance of a site to the points of a straight line
+     * along dimension @a dim, i.e. the sum of @f$ |s_i-x_i|^p@f$ over
+     * the dimensions @a i other than @a dim (the same for all the
+     * points @a x of the line).
+     *
+     * @param aSite a site
+     * @param aLinePoint a point of the line
+     * @param dim direction of the straight line
+     *
+     * @return the partial raw distance.
+     */
+    RawValue partialRawDistance(const Point &aSite,
+                                const Point &aLinePoint,
+                                const typename Point::UnsignedComponent dim) const;
+
+    /**
+     * Same as hiddenBy, from the coordinates of the sites along the
+     * line and their partial raw distances to the line.
+     *
+     * @pre ud < vd < wd
+     *
+     * @param ud coordinate of u along the line
+     * @param nu partial raw distance of u
+     * @param vd coordinate of v along the line
+     * @param nv partial raw distance of v
+     * @param wd coordinate of w along the line
+     * @param nw partial raw distance of w
+     * @param lower coordinate of the starting point of the segment
+     * @param upper coordinate of the end point of the segment
+     *
+     * @return true if (u,w) hides v, i.e. if v is strictly the
+     * closest site of no point of the segment.
+     */
+    bool hiddenBy1D(const Abscissa &ud, const RawValue &nu,
+                    const Abscissa &vd, const RawValue &nv,
+                    const Abscissa &wd, const RawValue &nw,
+                    const Abscissa &lower,
+                    const Abscissa &upper) const;
+
+    /**
+     * Same as closest, for a point of the line, from the coordinates
+     * of the sites along the line and their partial raw distances to
+     * the line.
+     *
+     * @param x coordinate of the origin along the line
+     * @param fd coordinate of the first site along the line
+     * @param nf partial raw distance of the first site
+     * @param sd coordinate of the second site along the line
+     * @param ns partial raw distance of the second site
+     *
+     * @return a Closest enum: FIRST, SECOND or BOTH.
+     */
+    Closest closest1D(const Abscissa &x,
+                      const Abscissa &fd, const RawValue &nf,
+                      const Abscissa &sd, const RawValue &ns) const;
+
 
     /**
      * Writes/Displays the object on an output stream.
@@ -395,6 +454,64 @@ namespace DGtal
                   const Point &endPoint,
                   const typename Point::UnsignedComponent dim) const;
 
+    // ----------------------- Line kernel (see SeparableMetricTraits) ---------
+    /**
+     * Partial raw distance of a site to the points of a straight line
+     * along dimension @a dim, i.e. the sum of @f$ |s_i-x_i|^p@f$ over
+     * the dimensions @a i other than @a dim (the same for all the
+     * points @a x of the line).
+     *
+     * @param aSite a site
+     * @param aLinePoint a point of the line
+     * @param dim direction of the straight line
+     *
+     * @return the partial raw distance.
+     */
+    RawValue partialRawDistance(const Point &aSite,
+                                const Point &aLinePoint,
+                                const typename Point::UnsignedComponent dim) const;
+
+    /**
+     * Same as hiddenBy, from the coordinates of the sites along the
+     * line and their partial raw distances to the line.
+     *
+     * @pre ud < vd < wd
+     *
+     * @param ud coordinate of u along the line
+     * @param nu partial raw distance of u
+     * @param vd coordinate of v along the line
+     * @param nv partial raw distance of v
+     * @param wd coordinate of w along the line
+     * @param nw partial raw distance of w
+     * @param lower coordinate of the starting point of the segment
+     * @param upper coordinate of the end point of the segment
+     *
+     * @return true if (u,w) hides v, i.e. if v is strictly the
+     * closest site of no point of the segment.
+     */
+    bool hiddenBy1D(const Abscissa &ud, const RawValue &nu,
+                    const Abscissa &vd, const RawValue &nv,
+                    const Abscissa &wd, const RawValue &nw,
+                    const Abscissa &lower,
+                    const Abscissa &upper) const;
+
+    /**
+     * Same as closest, for a point of the line, from the coordinates
+     * of the sites along the line and their partial raw distances to
+     * the line.
+     *
+     * @param x coordinate of the origin along the line
+     * @param fd coordinate of the first site along the line
+     * @param nf partial raw distance of the first site
+     * @param sd coordinate of the second site along the line
+     * @param ns partial raw distance of the second site
+     *
+     * @return a Closest enum: FIRST, SECOND or BOTH.
+     */
+    Closest closest1D(const Abscissa &x,
+                      const Abscissa &fd, const RawValue &nf,
+                      const Abscissa &sd, const RawValue &ns) const;
+
    // ----------------------- Other services --------------------------------------
     /**
      * Writes/Displays the object on an output stream.
@@ -53,6 +53,7 @@
 #include "DGtal/images/CConstImage.h"
 #include "DGtal/images/CImage.h"
 #include "DGtal/geometry/volumes/distance/CPowerSeparableMetric.h"
+#include "DGtal/geometry/volumes/distance/SeparableMetricTraits.h"
 #include "DGtal/kernel/domains/HyperRectDomain.h"
 //////////////////////////////////////////////////////////////////////////////
 
@@ -90,6 +91,12 @@ namespace DGtal
    * class constructor). For Euclidean the @f$ l_2@f$ metric, the
    * overall computation is in @f$ O(d.n^d)@f$, which is optimal.
    *
+   * If the metric provides the line kernel (see
+   * SeparableMetricTraits, e.g. ExactPredicateLpPowerSeparableMetric),
+   * the partial power distance of each site to the current line is
+   * computed once, and the 1D process only compares coordinates along
+   * the line and these partial distances.
+   *
    * This class is a model of concepts::CConstImage.
    *
    * @see &nbsp; \ref toricVol
@@ -144,6 +151,12 @@ namespace DGtal
     ///We construct the type associated to the separable metric
     typedef TPowerSeparableMetric PowerSeparableMetric;
 
+    ///Type of the weights and power distances of the metric.
+    typedef typename PowerSeparableMetric::Weight PowerValue;
+
+    ///True if the metric has a line kernel (see SeparableMetricTraits).
+    typedef typename SeparableMetricTraits<PowerSeparableMetric>::HasLineKernel LineKernel;
+
     ///Type of resulting image
     typedef TImageContainer OutputImage;
 
@@ -343,6 +356,72 @@ namespace DGtal
     void computeOtherStep1D (const Point &row,
                              const Dimension dim) const;
 
+    /// @return the partial power distance of a weighted site to the
+    /// line of @a row along @a dim (line kernel).
+    PowerValue siteKey( const Point & aSite, const PowerValue & aWeight,
+                        const Point & row, const Dimension dim, std::true_type ) const
+    {
+      return myMetricPtr->partialPowerDistance( aSite, aWeight, row, dim );
+    }
+
+    /// @return the weight of the site (no line kernel).
+    PowerValue siteKey( const Point &, const PowerValue & aWeight,
+                        const Point &, const Dimension, std::false_type ) const
+    {
+      return aWeight;
+    }
+
+    /// @return true if the two last sites of @a sites and @a aSite
+    /// hide the last one (line kernel: @a keys are partial distances).
+    bool hiddenBy( const std::vector<Point> & sites,
+                   const std::vector<PowerValue> & keys,
+                   const Point & aSite, const PowerValue & aKey,
+                   const Point & row, const Point & endPoint,
+                   const Dimension dim, std::true_type ) const
+    {
+      const std::size_t n = sites.size();
+      return myMetricPtr->hiddenBy1D( sites[n-2][dim], keys[n-2],
+                                      sites[n-1][dim], keys[n-1],
+                                      aSite[dim], aKey,
+                                      row[dim], endPoint[dim] );
+    }
+
+    /// @return true if the two last sites of @a sites and @a aSite
+    /// hide the last one (hiddenByPower: @a keys are weights).
+    bool hiddenBy( const std::vector<Point> & sites,
+                   const std::vector<PowerValue> & keys,
+                   const Point & aSite, const PowerValue & aKey,
+                   const Point & row, const Point & endPoint,
+                   const Dimension dim, std::false_type ) const
+    {
+      const std::size_t n = sites.size();
+      return myMetricPtr->hiddenByPower( sites[n-2], keys[n-2], sites[n-1], keys[n-1],
+                                         aSite, aKey, row, endPoint, dim );
+    }
+
+    /// @return the closest of the sites @a i and @a i+1 to a point of
+    /// the line (line kernel).
+    Closest closest( const Point & aPoint,
+                     const std::vector<Point> & sites,
+                     const std::vector<PowerValue> & keys,
+                     const std::size_t i, const Dimension dim,
+                     std::true_type ) const
+    {
+      return myMetricPtr->closest1D( aPoint[dim], sites[i][dim], keys[i],
+                                     sites[i+1][dim], keys[i+1] );
+    }
+
+    /// @return the closest of the sites @a i and @a i+1 to a point of
+    /// the line (closestPower).
+    Closest closest( const Point & aPoint,
+                     const std::vector<Point> & sites,
+                     const std::vector<PowerValue> & keys,
+                     const std::size_t i, const Dimension,
+                     std::false_type ) const
+    {
+      return myMetricPtr->closestPower( aPoint, sites[i], keys[i], sites[i+1], keys[i+1] );
+    }
+
     /**
      * Project point coordinates into the domain, taking into account
      * the periodicity up to a fixed dimension.
@@ -0,0 +1,98 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **/
+
+#pragma once
+
+/**
+ * @file SeparableMetricTraits.h
+ *
+ * Traits on separable metrics, used by VoronoiMap and PowerMap.
+ *
+ * This file is part of the DGtal library.
+ */
+
+#if defined(SeparableMetricTraits_RECURSES)
+#error Recursive header files inclusion detected in SeparableMetricTraits.h
+#else // defined(SeparableMetricTraits_RECURSES)
+/** Prevents recursive inclusion of headers. */
+#define SeparableMetricTraits_RECURSES
+
+#if !defined SeparableMetricTraits_h
+/** Prevents repeated inclusion of headers. */
+#define SeparableMetricTraits_h
+
+//////////////////////////////////////////////////////////////////////////////
+// Inclusions
+#include <type_traits>
+#include "DGtal/base/Common.h"
+//////////////////////////////////////////////////////////////////////////////
+
+namespace DGtal
+{
+  /////////////////////////////////////////////////////////////////////////////
+  // template class SeparableMetricTraits
+  /**
+   * Description of template class 'SeparableMetricTraits' <p>
+   * \brief Aim: Tells whether a separable metric (model of
+   * concepts::CSeparableMetric or concepts::CPowerSeparableMetric)
+   * provides the line kernel.
+   *
+   * Along a 1D line of the separable process, the part of the
+   * distance of a site that does not depend on the position on the
+   * line (its "partial distance": the sum over the other dimensions,
+   * minus the weight for power metrics) is the same for every point
+   * of the line. A metric providing the line kernel computes it once
+   * per site, and then decides hiddenBy and closest from the site
+   * coordinates along the line and these partial distances only:
+   *
+   * - partialRawDistance(site, linePoint, dim) (or
+   *   partialPowerDistance(site, weight, linePoint, dim) for power
+   *   metrics);
+   * - hiddenBy1D(ud, nu, vd, nv, wd, nw, lower, upper);
+   * - closest1D(x, ud, nu, vd, nv).
+   *
+   * VoronoiMap and PowerMap use the line kernel when it is available
+   * (see ExactPredicateLpSeparableMetric and
+   * ExactPredicateLpPowerSeparableMetric), and the generic hiddenBy
+   * and closest otherwise.
+   *
+   * @tparam TMetric the separable metric type.
+   */
+  template <typename TMetric, typename Enable = void>
+  struct SeparableMetricTraits
+  {
+    /// True if the metric provides the line kernel.
+    typedef std::false_type HasLineKernel;
+  };
+
+  /// Specialization for metrics with a hiddenBy1D method.
+  template <typename TMetric>
+  struct SeparableMetricTraits< TMetric,
+                                decltype( void( &TMetric::hiddenBy1D ) ) >
+  {
+    /// True if the metric provides the line kernel.
+    typedef std::true_type HasLineKernel;
+  };
+
+} // namespace DGtal
+
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // !defined SeparableMetricTraits_h
+
+#undef SeparableMetricTraits_RECURSES
+#endif // else defined(SeparableMetricTraits_RECURSES)
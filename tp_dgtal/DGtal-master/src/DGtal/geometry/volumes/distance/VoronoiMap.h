@@ -46,20 +46,111 @@
 #include <iostream>
 #include <vector>
 #include <array>
+#include <type_traits>
 #include "DGtal/base/Common.h"
 #include "DGtal/base/CountedPtr.h"
+#include "DGtal/base/CountedPtrOrPtr.h"
+#include "DGtal/base/Alias.h"
 #include "DGtal/images/ImageContainerBySTLVector.h"
 #include "DGtal/images/CImage.h"
 #include "DGtal/kernel/CPointPredicate.h"
 #include "DGtal/kernel/domains/HyperRectDomain.h"
 #include "DGtal/geometry/volumes/distance/CSeparableMetric.h"
+#include "DGtal/geometry/volumes/distance/SeparableMetricTraits.h"
+#include "DGtal/kernel/NumberTraits.h"
 #include "DGtal/kernel/domains/HyperRectDomain.h"
+#include "DGtal/images/DefaultConstImageRange.h"
 #include "DGtal/base/ConstAlias.h"
 //////////////////////////////////////////////////////////////////////////////
 
 namespace DGtal
 {
 
+  template <typename TImageContainer, typename TImageFactory,
+            typename TImageCacheReadPolicy, typename TImageCacheWritePolicy>
+  class TiledImage;
+
+  namespace detail
+  {
+  /////////////////////////////////////////////////////////////////////////////
+  // template class VoronoiMapImageTiling
+  /**
+   * Description of template class 'VoronoiMapImageTiling' <p>
+   * \brief Aim: Small traits class telling how the image of a
+   * VoronoiMap is tiled: by default, in one tile, which may be
+   * accessed concurrently at distinct points.
+   *
+   * @tparam TImage the image container type.
+   */
+    template <typename TImage>
+    struct VoronoiMapImageTiling
+    {
+      /// True if the image is made of several tiles.
+      typedef std::false_type IsTiled;
+
+      /**
+       * @param anImage an image.
+       * @return the extent of the tiles of @a anImage.
+       */
+      static typename TImage::Point tileExtent( const TImage & anImage )
+      {
+        return anImage.domain().upperBound() - anImage.domain().lowerBound()
+          + TImage::Point::diagonal( 1 );
+      }
+
+      /**
+       * @param anImage an image.
+       * @return the domains of the tiles of @a anImage, in the order
+       * in which they should be visited.
+       */
+      static std::vector< typename TImage::Domain > tileDomains( const TImage & anImage )
+      {
+        return std::vector< typename TImage::Domain >( 1, anImage.domain() );
+      }
+    };
+
+    /// Specialization for TiledImage: tiles are loaded and flushed by
+    /// a cache, which is not thread-safe.
+    template <typename TImageContainer, typename TImageFactory,
+              typename TImageCacheReadPolicy, typename TImageCacheWritePolicy>
+    struct VoronoiMapImageTiling< TiledImage< TImageContainer, TImageFactory,
+                                              TImageCacheReadPolicy,
+                                              TImageCacheWritePolicy > >
+    {
+      typedef TiledImage< TImageContainer, TImageFactory,
+                          TImageCacheReadPolicy, TImageCacheWritePolicy > Image;
+
+      /// True if the image is made of several tiles.
+      typedef std::true_type IsTiled;
+
+      /**
+       * @param anImage a tiled image.
+       * @return the extent of the tiles of @a anImage (the first one,
+       * the last tiles along each dimension may be smaller).
+       */
+      static typename Image::Point tileExtent( const Image & anImage )
+      {
+        const typename Image::Domain tile =
+          anImage.findSubDomain( anImage.domain().lowerBound() );
+        return tile.upperBound() - tile.lowerBound()
+          + Image::Point::diagonal( 1 );
+      }
+
+      /**
+       * @param anImage a tiled image.
+       * @return the domains of the tiles of @a anImage, in the order
+       * of their block coordinates.
+       */
+      static std::vector< typename Image::Domain > tileDomains( const Image & anImage )
+      {
+        std::vector< typename Image::Domain > tiles;
+        for ( auto const & coords : anImage.domainBlockCoords() )
+          tiles.push_back( anImage.findSubDomainFromBlockCoords( coords ) );
+        return tiles;
+      }
+    };
+  }
+
   /////////////////////////////////////////////////////////////////////////////
   // template class VoronoiMap
   /**
@@ -102,8 +193,92 @@ namespace DGtal
    * in an optimal way: on @a p processors, expected runtime is in
    * @f$ O(h.d.n^d / p)@f$.
    *
+   * Along a dimension other than 0, the 1D lines are strided in
+   * memory. They are thus processed by blocks of up to @a blockSize
+   * lines, adjacent along dimension 0: the block is copied into a
+   * contiguous (transposed) scratch buffer, one contiguous run of
+   * points at a time, each line is solved in the buffer, then the
+   * block is copied back. Scratch buffers are reused by each thread.
+   *
+   * If the metric provides the line kernel (see
+   * SeparableMetricTraits, e.g. ExactPredicateLpSeparableMetric), the
+   * partial distance of each site to the current line is computed
+   * once, and the 1D process only compares coordinates along the line
+   * and these partial distances.
+   *
    * This class is a model of concepts::CConstImage.
    *
+   * <b>Compact site storage.</b> By default, the closest site of each
+   * point is stored as a full @a Vector (e.g. 12 bytes per voxel in
+   * 3D with 32-bit coordinates). If the value type of @a
+   * TImageContainer is an unsigned integer type (for instance
+   * DGtal::uint32_t, or DGtal::uint16_t on small domains), sites are
+   * instead stored as linear indices in the domain (enlarged by one
+   * extent on both sides along periodic dimensions, where sites may
+   * lie outside the domain). The largest value of the integer type
+   * stands for "no site". The construction throws
+   * std::overflow_error if the indices do not fit. The algorithm and
+   * the result of operator() are the same: sites are decoded on the
+   * fly, at the price of a few integer divisions per access.
+   *
+   * @code
+   * typedef ImageContainerBySTLVector<Z3i::Domain, DGtal::uint32_t> CompactImage;
+   * VoronoiMap<Z3i::Space, Predicate, Z3i::L2Metric, CompactImage> voro(domain, predicate, l2);
+   * @endcode
+   *
+   * <b>Local updates.</b> When a few points of the predicate change
+   * (sites inserted or removed), update() repairs the map instead of
+   * recomputing it: each 1D line is solved again only if its input
+   * (the result of the previous dimension) has changed, so the
+   * result is exactly the one of a full computation, sites included.
+   * To do so, the map keeps the results of the first (dimension - 1)
+   * steps, i.e. (dimension - 1) more maps of sites: they are
+   * computed by the first call to update(), which is thus a full
+   * computation.
+   *
+   * @code
+   * // ... sites of aSet inserted or removed at the points of edited
+   * voro.update( edited.begin(), edited.end() );
+   * @endcode
+   *
+   * <b>Out-of-core computation.</b> The Voronoi map may be computed
+   * into a TiledImage (e.g. over an ImageFactoryFromHDF5), for
+   * volumes that do not fit in memory, with the constructor taking
+   * the output image. Only the tiles in the cache are in memory. The
+   * points are initialized tile by tile, then along each dimension,
+   * the blocks of lines are solved one slab at a time, i.e. the
+   * tiles along this dimension sharing the same other tile
+   * coordinates, slabs being visited in the domain order. With a
+   * write-back cache (ImageCacheWritePolicyWB) of one slab (N tiles
+   * if the image has N tiles per dimension), each tile is thus read
+   * and written once by the initialization and once per dimension.
+   * The tile extent along dimension 0 should be a multiple of @a
+   * blockSize, otherwise blocks across two slabs need a cache of two
+   * slabs. The cache is not thread-safe: the computation is then
+   * sequential. The predicate is only evaluated by the
+   * initialization, so that it may read the input volume from
+   * another TiledImage (e.g. with a
+   * functors::SimpleThresholdForegroundPredicate). Compact site
+   * storage (DGtal::uint64_t for a 4096^3 volume) needs 8 bytes per
+   * point instead of 12 for full vectors, and
+   * computeRawDistanceTransformation replaces the sites by the raw
+   * distances in the same tiles. update() keeps whole maps in memory
+   * and is not meant for such volumes.
+   *
+   * @code
+   * typedef ImageContainerBySTLVector<Z3i::Domain, DGtal::uint64_t> Tile;
+   * typedef ImageFactoryFromHDF5<Tile> Factory;
+   * typedef ImageCacheReadPolicyFIFO<Tile, Factory> ReadPolicy;
+   * typedef ImageCacheWritePolicyWB<Tile, Factory> WritePolicy;
+   * typedef TiledImage<Tile, Factory, ReadPolicy, WritePolicy> Tiled;
+   * Factory factory( "edt.h5", "/UInt64Array3D" );
+   * ReadPolicy read( factory, N ); // one slab of N tiles
+   * WritePolicy write( factory );
+   * Tiled tiled( factory, read, write, N );
+   * computeRawDistanceTransformation( domain, predicate, l2, tiled );
+   * tiled.flushCache();
+   * @endcode
+   *
    * @see &nbsp; \ref toricVol
    *
    * @tparam TSpace type of Digital Space (model of concepts::CSpace).
@@ -113,7 +288,8 @@ namespace DGtal
    * @tparam TImageContainer any model of concepts::CImage to store the
    * VoronoiMap (default: ImageContainerBySTLVector). The space of the
    * image container and the TSpace should match. Furthermore the
-   * container value type must be TSpace::Vector. Lastly, the domain
+   * container value type must be TSpace::Vector, or an unsigned
+   * integer type for compact site storage. Lastly, the domain
    * of the container must be HyperRectDomain.
    */
   template < typename TSpace,
@@ -140,9 +316,12 @@ namespace DGtal
     BOOST_STATIC_ASSERT ((boost::is_same< TSpace,
                           typename TImageContainer::Domain::Space >::value ));
 
-    //ImageContainer value type must be  TSpace::Vector
+    //ImageContainer value type must be TSpace::Vector (or an unsigned
+    //integer type for compact site storage)
     BOOST_STATIC_ASSERT ((boost::is_same< typename TSpace::Vector,
-                          typename TImageContainer::Value >::value ));
+                          typename TImageContainer::Value >::value
+                          || ( std::is_integral< typename TImageContainer::Value >::value
+                               && std::is_unsigned< typename TImageContainer::Value >::value ) ));
 
     //ImageContainer domain type must be  HyperRectangular
     BOOST_STATIC_ASSERT ((boost::is_same< HyperRectDomain<TSpace>,
@@ -163,6 +342,12 @@ namespace DGtal
     ///Large integer type for SeparableMetricHelper construction.
     typedef DGtal::int64_t IntegerLong;
 
+    ///Type of the raw distances of the metric.
+    typedef typename SeparableMetric::RawValue RawValue;
+
+    ///True if the metric has a line kernel (see SeparableMetricTraits).
+    typedef typename SeparableMetricTraits<SeparableMetric>::HasLineKernel LineKernel;
+
     typedef typename Space::Vector Vector;
     typedef typename Space::Point Point;
     typedef typename Space::Dimension Dimension;
@@ -175,17 +360,29 @@ namespace DGtal
     ///Definition of the image value type.
     typedef Vector Value;
 
-    ///Definition of the image value type.
-    typedef typename OutputImage::ConstRange  ConstRange;
+    ///Type of the values stored in the image (Vector, or site index).
+    typedef typename OutputImage::Value SiteCode;
+
+    ///True if the sites are stored as linear indices (compact storage).
+    typedef std::integral_constant< bool,
+      ! boost::is_same< SiteCode, Vector >::value > CompactSites;
 
     ///Self type
     typedef VoronoiMap< TSpace, TPointPredicate,
                         TSeparableMetric,TImageContainer > Self;
 
+    ///Definition of the image const range (decoding the sites if compact).
+    typedef typename std::conditional< CompactSites::value,
+      DefaultConstImageRange<Self>,
+      typename OutputImage::ConstRange >::type ConstRange;
+
 
     /// Periodicity specification type.
     typedef std::array< bool, Space::dimension > PeriodicitySpec;
 
+    /// Number of adjacent lines processed together along dimensions > 0.
+    static const Size blockSize = 16;
+
     /**
      * Constructor in the non-periodic case.
      *
@@ -237,6 +434,35 @@ namespace DGtal
                ConstAlias<PointPredicate> predicate,
                ConstAlias<SeparableMetric> aMetric,
                PeriodicitySpec const & aPeriodicitySpec);
+
+    /**
+     * Constructor computing the Voronoi map into a given image.
+     *
+     * Same as above, but the sites are written in @a anImage (whose
+     * domain must be @a aDomain) instead of a new image: with compact
+     * site storage, the caller may then reuse this memory, for
+     * instance to store distances (see
+     * computeRawDistanceTransformation).
+     *
+     * @param aDomain a pointer to the (hyper-rectangular) domain on
+     * which the computation is performed.
+     *
+     * @param predicate a pointer to the point predicate to define the
+     * Voronoi sites (false points).
+     *
+     * @param aMetric a pointer to the separable metric instance.
+     *
+     * @param aPeriodicitySpec the periodicity specification (see
+     * above).
+     *
+     * @param anImage the image receiving the (encoded) sites.
+     */
+    VoronoiMap(ConstAlias<Domain> aDomain,
+               ConstAlias<PointPredicate> predicate,
+               ConstAlias<SeparableMetric> aMetric,
+               PeriodicitySpec const & aPeriodicitySpec,
+               Alias<OutputImage> anImage);
+
     /**
      * Default destructor
      */
@@ -273,7 +499,7 @@ namespace DGtal
      */
     ConstRange constRange() const
     {
-      return myImagePtr->constRange();
+      return constRange( CompactSites() );
     }
 
     /**
@@ -284,7 +510,27 @@ namespace DGtal
      */
     Value operator()(const Point &aPoint) const
     {
-      return myImagePtr->operator()(aPoint);
+      return decodeSite( myImagePtr->operator()(aPoint), CompactSites() );
+    }
+
+    /**
+     * Decodes a value of the underlying image (the value itself, or
+     * the site of a site index with compact storage).
+     *
+     * @param aCode a value of the image returned by image().
+     * @return the corresponding site.
+     */
+    Value decode( const SiteCode & aCode ) const
+    {
+      return decodeSite( aCode, CompactSites() );
+    }
+
+    /**
+     * @return the underlying image of (possibly encoded) sites.
+     */
+    const OutputImage & image() const
+    {
+      return *myImagePtr;
     }
 
     /**
@@ -326,6 +572,23 @@ namespace DGtal
      */
     Point projectPoint( Point aPoint ) const;
 
+    /**
+     * Updates the map after a change of the point predicate at some
+     * points (see <b>Local updates</b> above). The result is the same
+     * as a new computation with the current predicate.
+     *
+     * The first call recomputes the whole map and keeps the results
+     * of the intermediate steps; the next ones only solve again the
+     * lines whose input has changed.
+     *
+     * @param itBegin an iterator on the first point whose predicate
+     * value may have changed (points must be in the domain).
+     * @param itEnd an iterator past the last point.
+     * @tparam PointIterator a model of forward iterator on Point.
+     */
+    template <typename PointIterator>
+    void update( PointIterator itBegin, PointIterator itEnd );
+
     /**
      * Self Display method.
      *
@@ -341,8 +604,21 @@ namespace DGtal
      * SeparableMetric metric.  The method associates to each point
      * satisfying the foreground predicate, the closest site for which
      * the predicate is false. This algorithm is O(h.d.|domain size|).
+     *
+     * @param keepSteps if true, the result of each step but the last
+     * one is stored in myStepSites (for update()).
      */
-    void compute ( ) ;
+    void compute ( bool keepSteps = false ) ;
+
+    /// @return the index of a point in the domain (dimension 0 first).
+    std::size_t linearIndex( const Point & aPoint ) const
+    {
+      std::size_t index = 0;
+      for ( Dimension i = Space::dimension; i-- > 0; )
+        index = index * static_cast<std::size_t>( myDomainExtent[i] )
+          + static_cast<std::size_t>( aPoint[i] - myLowerBoundCopy[i] );
+      return index;
+    }
 
 
     /**
@@ -351,6 +627,27 @@ namespace DGtal
      * @param [in] dim the dimension to process
      */
     void computeOtherSteps(const Dimension dim) const;
+
+    /**
+     * Given a voronoi map valid at dimension @a dim-1, this method
+     * updates the map to make it consistent at dimension @a dim
+     * along the @a width lines starting at @a row, @a row + (1,0,...),
+     * ... (one line if @a dim is 0).
+     *
+     * @param [in] row starting point of the first line.
+     * @param [in] width number of lines, adjacent along dimension 0.
+     * @param [in] dim dimension of the update.
+     * @param [in,out] lines scratch buffer for the sites of the lines.
+     * @param [in,out] sites scratch buffer for the 1D process.
+     * @param [in,out] partials scratch buffer for the 1D process.
+     */
+    void computeOtherStepBlock (const Point &row,
+                                const Size width,
+                                const Dimension dim,
+                                std::vector<Point> & lines,
+                                std::vector<Point> & sites,
+                                std::vector<RawValue> & partials) const;
+
     /**
      * Given  a voronoi map valid at dimension @a dim-1, this method
      * updates the map to make it consistent at dimension @a dim along
@@ -359,9 +656,82 @@ namespace DGtal
      *
      * @param [in] row starting point of the 1D process.
      * @param [in] dim dimension of the update.
+     * @param [in,out] line sites of the span, indexed by the
+     * coordinate along @a dim minus its lower bound.
+     * @param [in,out] Sites scratch buffer for the site list.
+     * @param [in,out] Partials scratch buffer for the partial
+     * distances of the sites to the line.
      */
     void computeOtherStep1D (const Point &row,
-                             const Dimension dim) const;
+                             const Dimension dim,
+                             Point * line,
+                             std::vector<Point> & Sites,
+                             std::vector<RawValue> & Partials) const;
+
+    /// @return the partial distance of a site to the line of @a row
+    /// along @a dim (line kernel).
+    RawValue partialDistance( const Point & aSite, const Point & row,
+                              const Dimension dim, std::true_type ) const
+    {
+      return myMetricPtr->partialRawDistance( aSite, row, dim );
+    }
+
+    /// @return zero (no line kernel: partial distances are not used).
+    RawValue partialDistance( const Point &, const Point &,
+                              const Dimension, std::false_type ) const
+    {
+      return NumberTraits<RawValue>::ZERO;
+    }
+
+    /// @return true if the two last sites of @a sites and @a aSite
+    /// hide the last one (line kernel).
+    bool hiddenBy( const std::vector<Point> & sites,
+                   const std::vector<RawValue> & partials,
+                   const Point & aSite, const RawValue & aPartial,
+                   const Point & row, const Point & endPoint,
+                   const Dimension dim, std::true_type ) const
+    {
+      const std::size_t n = sites.size();
+      return myMetricPtr->hiddenBy1D( sites[n-2][dim], partials[n-2],
+                                      sites[n-1][dim], partials[n-1],
+                                      aSite[dim], aPartial,
+                                      row[dim], endPoint[dim] );
+    }
+
+    /// @return true if the two last sites of @a sites and @a aSite
+    /// hide the last one (generic hiddenBy).
+    bool hiddenBy( const std::vector<Point> & sites,
+                   const std::vector<RawValue> &,
+                   const Point & aSite, const RawValue &,
+                   const Point & row, const Point & endPoint,
+                   const Dimension dim, std::false_type ) const
+    {
+      const std::size_t n = sites.size();
+      return myMetricPtr->hiddenBy( sites[n-2], sites[n-1], aSite, row, endPoint, dim );
+    }
+
+    /// @return the closest of the sites @a i and @a i+1 to a point of
+    /// the line (line kernel).
+    Closest closest( const Point & aPoint,
+                     const std::vector<Point> & sites,
+                     const std::vector<RawValue> & partials,
+                     const std::size_t i, const Dimension dim,
+                     std::true_type ) const
+    {
+      return myMetricPtr->closest1D( aPoint[dim], sites[i][dim], partials[i],
+                                     sites[i+1][dim], partials[i+1] );
+    }
+
+    /// @return the closest of the sites @a i and @a i+1 to a point of
+    /// the line (generic closest).
+    Closest closest( const Point & aPoint,
+                     const std::vector<Point> & sites,
+                     const std::vector<RawValue> &,
+                     const std::size_t i, const Dimension,
+                     std::false_type ) const
+    {
+      return myMetricPtr->closest( aPoint, sites[i], sites[i+1] );
+    }
 
     /**
      * Project a coordinate into the domain, taking into account
@@ -376,6 +746,83 @@ namespace DGtal
      */
     typename Point::Coordinate projectCoordinate( typename Point::Coordinate aCoordinate, const Dimension aDim ) const;
 
+    /**
+     * Sets the box of the site indices (compact storage only): the
+     * domain, enlarged by one extent on both sides along periodic
+     * dimensions.
+     *
+     * @throw std::overflow_error if the indices of this box do not
+     * fit in SiteCode.
+     */
+    void initSiteCoding( std::true_type );
+
+    /// Nothing to do without compact storage.
+    void initSiteCoding( std::false_type ) {}
+
+    /**
+     * Writes a site at a point of the image, encoded if needed.
+     *
+     * @param [in] aPoint the point of the image.
+     * @param [in] aSite the site (or myInfinity).
+     */
+    void setSite( const Point & aPoint, const Point & aSite ) const
+    {
+      myImagePtr->setValue( aPoint, encodeSite( aSite, CompactSites() ) );
+    }
+
+    /// @return the site itself (non-compact storage).
+    const Point & encodeSite( const Point & aSite, std::false_type ) const
+    {
+      return aSite;
+    }
+
+    /// @return the linear index of the site, or the largest SiteCode
+    /// for myInfinity (compact storage).
+    SiteCode encodeSite( const Point & aSite, std::true_type ) const
+    {
+      if ( aSite == myInfinity )
+        return myInfinityCode;
+      SiteCode code = 0;
+      for ( Dimension i = Space::dimension; i-- > 0; )
+        code = code * static_cast<SiteCode>( myCodeExtent[i] )
+          + static_cast<SiteCode>( aSite[i] - myCodeLowerBound[i] );
+      return code;
+    }
+
+    /// @return the value itself (non-compact storage).
+    const Point & decodeSite( const Point & aCode, std::false_type ) const
+    {
+      return aCode;
+    }
+
+    /// @return the site of a linear index, or myInfinity (compact
+    /// storage).
+    Point decodeSite( SiteCode aCode, std::true_type ) const
+    {
+      if ( aCode == myInfinityCode )
+        return myInfinity;
+      Point site;
+      for ( Dimension i = 0; i < Space::dimension; ++i )
+        {
+          site[i] = myCodeLowerBound[i]
+            + static_cast<Abscissa>( aCode % static_cast<SiteCode>( myCodeExtent[i] ) );
+          aCode /= static_cast<SiteCode>( myCodeExtent[i] );
+        }
+      return site;
+    }
+
+    /// @return the range of the image itself (non-compact storage).
+    ConstRange constRange( std::false_type ) const
+    {
+      return myImagePtr->constRange();
+    }
+
+    /// @return a range decoding the sites (compact storage).
+    ConstRange constRange( std::true_type ) const
+    {
+      return ConstRange( *this );
+    }
+
     // ------------------- Private members ------------------------
   private:
 
@@ -400,13 +847,26 @@ namespace DGtal
     /// Domain extent.
     Point myDomainExtent;
 
+    /// Lower bound of the box of the site indices (compact storage).
+    Point myCodeLowerBound;
+
+    /// Extent of the box of the site indices (compact storage).
+    Point myCodeExtent;
+
+    /// Site index standing for myInfinity (compact storage).
+    SiteCode myInfinityCode;
+
+    /// Results of the steps along dimensions 0 to (dimension - 2),
+    /// by linear index (kept for update()).
+    std::vector< std::vector<SiteCode> > myStepSites;
+
   protected:
 
     ///Pointer to the separable metric instance
     const SeparableMetric * myMetricPtr;
 
-    ///Voronoi map image
-    CountedPtr<OutputImage> myImagePtr;
+    ///Voronoi map image (owned, or given to the constructor)
+    CountedPtrOrPtr<OutputImage> myImagePtr;
 
     /// Periodicity along each dimension.
     PeriodicitySpec myPeriodicitySpec;
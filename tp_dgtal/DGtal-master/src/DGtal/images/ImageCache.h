@@ -41,6 +41,7 @@
 //////////////////////////////////////////////////////////////////////////////
 // Inclusions
 #include <iostream>
+#include <vector>
 #include "DGtal/base/Common.h"
 #include "DGtal/base/ConceptUtils.h"
 #include "DGtal/images/CImage.h"
@@ -197,6 +198,13 @@ public:
      */
     void update(const Domain &aDomain);
     
+    /**
+     * Flush all the images of the cache according to the write cache
+     * policy (e.g. write back the images with a write-back policy).
+     * The images stay in the cache.
+     */
+    void flushCache();
+    
     /**
      * Get the cacheMissRead value.
      */
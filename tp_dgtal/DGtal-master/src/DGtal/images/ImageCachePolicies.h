@@ -41,6 +41,7 @@
 //////////////////////////////////////////////////////////////////////////////
 // Inclusions
 #include <iostream>
+#include <vector>
 #include "DGtal/base/Common.h"
 #include "DGtal/base/ConceptUtils.h"
 #include "DGtal/images/CImage.h"
@@ -136,6 +137,13 @@ public:
      */
     ImageContainer * getPageToDetach();
     
+    /**
+     * Get the aliases on all the images of the cache.
+     *
+     * @return the vector of image container aliases.
+     */
+    std::vector<ImageContainer *> getPages();
+    
     /**
      * Update the cache according to the cache policy.
      *
@@ -241,6 +249,13 @@ public:
      */
     ImageContainer * getPageToDetach();
     
+    /**
+     * Get the aliases on all the images of the cache.
+     *
+     * @return the vector of image container aliases.
+     */
+    std::vector<ImageContainer *> getPages();
+    
     /**
      * Update the cache according to the cache policy.
      *
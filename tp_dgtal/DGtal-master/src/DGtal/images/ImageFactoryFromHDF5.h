@@ -153,6 +153,58 @@ namespace DGtal
 
   }; // end of class H5DSpecializations
 
+  /////////////////////////////////////////////////////////////////////////////
+  // template class H5DSpecializations
+  /**
+   * Description of template class 'H5DSpecializations' <p>
+   * \brief Aim: implements HDF5 reading and writing for specialized type DGtal::uint32_t.
+   */
+  template <typename TImageFactory>
+  struct H5DSpecializations<TImageFactory, DGtal::uint32_t>
+  {
+    // ----------------------- Standard services ------------------------------
+
+    typedef TImageFactory ImageFactory;
+    typedef typename ImageFactory::OutputImage::Value Value;
+
+    static int H5DreadS(ImageFactory &anImageFactory, hid_t memspace, Value *data_out)
+    {
+      return H5Dread(anImageFactory.dataset, H5T_NATIVE_UINT32, memspace, anImageFactory.dataspace, H5P_DEFAULT, data_out);
+    }
+
+    static int H5DwriteS(ImageFactory &anImageFactory, hid_t memspace, Value *data_in)
+    {
+      return H5Dwrite(anImageFactory.dataset, H5T_NATIVE_UINT32, memspace, anImageFactory.dataspace, H5P_DEFAULT, data_in);
+    }
+
+  }; // end of class H5DSpecializations
+
+  /////////////////////////////////////////////////////////////////////////////
+  // template class H5DSpecializations
+  /**
+   * Description of template class 'H5DSpecializations' <p>
+   * \brief Aim: implements HDF5 reading and writing for specialized type DGtal::uint64_t.
+   */
+  template <typename TImageFactory>
+  struct H5DSpecializations<TImageFactory, DGtal::uint64_t>
+  {
+    // ----------------------- Standard services ------------------------------
+
+    typedef TImageFactory ImageFactory;
+    typedef typename ImageFactory::OutputImage::Value Value;
+
+    static int H5DreadS(ImageFactory &anImageFactory, hid_t memspace, Value *data_out)
+    {
+      return H5Dread(anImageFactory.dataset, H5T_NATIVE_UINT64, memspace, anImageFactory.dataspace, H5P_DEFAULT, data_out);
+    }
+
+    static int H5DwriteS(ImageFactory &anImageFactory, hid_t memspace, Value *data_in)
+    {
+      return H5Dwrite(anImageFactory.dataset, H5T_NATIVE_UINT64, memspace, anImageFactory.dataspace, H5P_DEFAULT, data_in);
+    }
+
+  }; // end of class H5DSpecializations
+
   /////////////////////////////////////////////////////////////////////////////
   // template class H5DSpecializations
   /**
@@ -770,6 +770,15 @@ namespace DGtal
       return myImageCache->getCacheMissWrite();
     }
 
+    /**
+     * Flush the tiles of the cache to the image factory (needed at
+     * the end with a write-back policy, e.g. to save the image)
+     */
+    void flushCache()
+    {
+      myImageCache->flushCache();
+    }
+
     /**
      * Clear the cache and reset the cache misses
      */
@@ -37,6 +37,7 @@
 #include "DGtal/geometry/volumes/distance/ExactPredicateLpSeparableMetric.h"
 #include "DGtal/geometry/volumes/distance/ExactPredicateLpPowerSeparableMetric.h"
 #include "DGtal/geometry/volumes/distance/InexactPredicateLpSeparableMetric.h"
+#include "DGtal/geometry/volumes/distance/SeparableMetricTraits.h"
 ///////////////////////////////////////////////////////////////////////////////
 
 using namespace std;
@@ -364,6 +365,29 @@ bool testBinarySearch()
   trace.info() << "(" << nbok << "/" << nb << ") " << "should be >= upper bound (15)" << std::endl;
   trace.endBlock();
 
+  trace.beginBlock("l_1 closed form against a scan");
+  bool same = true;
+  for ( Abscissa lower = -6; lower <= 0; lower += 3 )
+    for ( Abscissa udim = -8; udim <= 8; ++udim )
+      for ( Abscissa vdim = udim + 1; vdim <= 9; ++vdim )
+        for ( partialA = 0; partialA <= 6; ++partialA )
+          for ( partialB = 0; partialB <= 6; ++partialB )
+            {
+              const Abscissa upper = lower + 11;
+              if ( partialA + abs( udim - lower ) >= partialB + abs( vdim - lower ) )
+                continue;
+              // last abscissa strictly closer to A
+              Abscissa last = lower;
+              for ( Abscissa x = lower; x <= upper; ++x )
+                if ( partialA + abs( udim - x ) < partialB + abs( vdim - x ) )
+                  last = x;
+              same = same && metric.binarySearchHidden( udim, vdim, partialA, partialB, lower, upper ) == last;
+            }
+  nbok += same ? 1 : 0;
+  nb++;
+  trace.info() << "(" << nbok << "/" << nb << ") " << "same as the scan" << std::endl;
+  trace.endBlock();
+
   
   trace.endBlock();
   return nbok == nb;
@@ -468,6 +492,177 @@ bool testSpecialCasesL2()
 }
 
 
+/**
+ * Brute-force reference for the line kernel along dimension 0: does
+ * the site v own a point x of the line, strictly (closer than u and
+ * w) or weakly (as close as u and w)?
+ *
+ * The sites are given by their coordinate along the line and their
+ * partial distance n to the line: the distance at x is n + |x-s|^p.
+ * The points x = k/M are scanned over [lower, upper], scaled by M^p
+ * to stay in integers (M = 1: the points of the segment).
+ */
+template <int p>
+void bruteForceOwnership( const DGtal::int64_t ud, const DGtal::int64_t nu,
+                          const DGtal::int64_t vd, const DGtal::int64_t nv,
+                          const DGtal::int64_t wd, const DGtal::int64_t nw,
+                          const DGtal::int64_t lower, const DGtal::int64_t upper,
+                          const DGtal::int64_t M,
+                          bool & strict, bool & weak )
+{
+  const DGtal::int64_t Mp = functions::power( M, p );
+  auto dist = [&] ( const DGtal::int64_t k, const DGtal::int64_t s, const DGtal::int64_t n ) {
+    return Mp * n + functions::power( std::abs( k - M * s ), p );
+  };
+  strict = weak = false;
+  for ( DGtal::int64_t k = M * lower; k <= M * upper; ++k )
+    {
+      const DGtal::int64_t du = dist( k, ud, nu ), dv = dist( k, vd, nv ), dw = dist( k, wd, nw );
+      strict = strict || ( dv < du && dv < dw );
+      weak = weak || ( dv <= du && dv <= dw );
+    }
+}
+
+/**
+ * Partial distance of a (weighted) site to the line of dimension 0
+ * through aLinePoint, computed here independently of the metrics.
+ */
+template <int p>
+DGtal::int64_t referencePartial( const Z3i::Point & aSite, const DGtal::int64_t aWeight,
+                                 const Z3i::Point & aLinePoint )
+{
+  DGtal::int64_t res = -aWeight;
+  for ( Dimension i = 1; i < 3; ++i )
+    res += functions::power( (DGtal::int64_t) std::abs( aSite[i] - aLinePoint[i] ), p );
+  return res;
+}
+
+/**
+ * Checks hiddenBy1D and closest1D of a (power) metric with the line
+ * kernel against the brute-force reference, on random sites (and
+ * weights if @a maxWeight > 0): (u,w) must hide v if v owns no point
+ * of the line, and must not if v strictly owns one (ties may go
+ * either way). The l_2 kernel decides on the whole real line, hence
+ * a finer scan of a larger segment for p = 2.
+ */
+template <int p, typename Kernel>
+bool checkLineKernel( const Kernel & kernel, const int maxWeight )
+{
+  unsigned int hidden = 0, kept = 0;
+  bool ok = true;
+  const Z3i::Point linePoint( 0, 1, -2 );
+  for ( unsigned int i = 0; i < 1000; ++i )
+    {
+      const Z3i::Point u( rand() % 4, rand() % 9 - 4, rand() % 9 - 4 );
+      const Z3i::Point v( 4 + rand() % 4, rand() % 9 - 4, rand() % 9 - 4 );
+      const Z3i::Point w( 8 + rand() % 4, rand() % 9 - 4, rand() % 9 - 4 );
+      const DGtal::int64_t wu = maxWeight > 0 ? rand() % maxWeight : 0;
+      const DGtal::int64_t wv = maxWeight > 0 ? rand() % maxWeight : 0;
+      const DGtal::int64_t ww = maxWeight > 0 ? rand() % maxWeight : 0;
+      const DGtal::int64_t nu = referencePartial<p>( u, wu, linePoint );
+      const DGtal::int64_t nv = referencePartial<p>( v, wv, linePoint );
+      const DGtal::int64_t nw = referencePartial<p>( w, ww, linePoint );
+      const DGtal::int64_t lower = rand() % 5, upper = 8 + rand() % 5;
+
+      bool strict, weak;
+      if ( p == 2 )
+        {
+          const DGtal::int64_t a = v[0] - u[0], b = w[0] - v[0];
+          const DGtal::int64_t R = std::abs( nu ) + std::abs( nv ) + std::abs( nw ) + 12;
+          bruteForceOwnership<p>( u[0], nu, v[0], nv, w[0], nw, -R, 12 + R, 4 * a * b, strict, weak );
+        }
+      else
+        bruteForceOwnership<p>( u[0], nu, v[0], nv, w[0], nw, lower, upper, 1, strict, weak );
+
+      const bool res = kernel.hiddenBy( u, wu, v, wv, w, ww, linePoint, lower, upper );
+      ok = ok && ( ! strict || ! res ) && ( weak || res );
+      hidden += ( ! weak ) ? 1 : 0;
+      kept += strict ? 1 : 0;
+
+      const Z3i::Point x( rand() % 13, 1, -2 );
+      const DGtal::int64_t du = nu + functions::power( (DGtal::int64_t) std::abs( x[0] - u[0] ), p );
+      const DGtal::int64_t dw = nw + functions::power( (DGtal::int64_t) std::abs( x[0] - w[0] ), p );
+      const DGtal::Closest expected = du < dw ? ClosestFIRST : ( du > dw ? ClosestSECOND : ClosestBOTH );
+      ok = ok && kernel.closest( x, u, wu, w, ww, linePoint ) == expected;
+    }
+  trace.info() << "l_" << p << ( maxWeight > 0 ? " power" : "" ) << ": " << hidden
+               << " hidden, " << kept << " kept" << std::endl;
+  return ok && hidden > 0 && kept > 0;
+}
+
+/// Line kernel of a separable metric, for checkLineKernel.
+template <typename Metric>
+struct SeparableLineKernel
+{
+  Metric metric;
+  bool hiddenBy( const Z3i::Point & u, DGtal::int64_t, const Z3i::Point & v, DGtal::int64_t,
+                 const Z3i::Point & w, DGtal::int64_t, const Z3i::Point & linePoint,
+                 DGtal::int64_t lower, DGtal::int64_t upper ) const
+  {
+    return metric.hiddenBy1D( u[0], metric.partialRawDistance( u, linePoint, 0 ),
+                              v[0], metric.partialRawDistance( v, linePoint, 0 ),
+                              w[0], metric.partialRawDistance( w, linePoint, 0 ),
+                              lower, upper );
+  }
+  DGtal::Closest closest( const Z3i::Point & x, const Z3i::Point & f, DGtal::int64_t,
+                          const Z3i::Point & s, DGtal::int64_t, const Z3i::Point & linePoint ) const
+  {
+    return metric.closest1D( x[0], f[0], metric.partialRawDistance( f, linePoint, 0 ),
+                             s[0], metric.partialRawDistance( s, linePoint, 0 ) );
+  }
+};
+
+/// Line kernel of a power separable metric, for checkLineKernel.
+template <typename Metric>
+struct PowerLineKernel
+{
+  Metric metric;
+  bool hiddenBy( const Z3i::Point & u, DGtal::int64_t wu, const Z3i::Point & v, DGtal::int64_t wv,
+                 const Z3i::Point & w, DGtal::int64_t ww, const Z3i::Point & linePoint,
+                 DGtal::int64_t lower, DGtal::int64_t upper ) const
+  {
+    return metric.hiddenBy1D( u[0], metric.partialPowerDistance( u, wu, linePoint, 0 ),
+                              v[0], metric.partialPowerDistance( v, wv, linePoint, 0 ),
+                              w[0], metric.partialPowerDistance( w, ww, linePoint, 0 ),
+                              lower, upper );
+  }
+  DGtal::Closest closest( const Z3i::Point & x, const Z3i::Point & f, DGtal::int64_t wf,
+                          const Z3i::Point & s, DGtal::int64_t ws, const Z3i::Point & linePoint ) const
+  {
+    return metric.closest1D( x[0], f[0], metric.partialPowerDistance( f, wf, linePoint, 0 ),
+                             s[0], metric.partialPowerDistance( s, ws, linePoint, 0 ) );
+  }
+};
+
+bool testLineKernel()
+{
+  unsigned int nbok = 0;
+  unsigned int nb = 0;
+
+  trace.beginBlock ( "Testing the line kernel of exact metrics..." );
+
+  BOOST_STATIC_ASSERT(( SeparableMetricTraits< ExactPredicateLpSeparableMetric<Z3i::Space, 2> >::HasLineKernel::value ));
+  BOOST_STATIC_ASSERT(( SeparableMetricTraits< ExactPredicateLpPowerSeparableMetric<Z3i::Space, 1> >::HasLineKernel::value ));
+  BOOST_STATIC_ASSERT(( ! SeparableMetricTraits< InexactPredicateLpSeparableMetric<Z3i::Space> >::HasLineKernel::value ));
+
+  nbok += checkLineKernel<1>( SeparableLineKernel< ExactPredicateLpSeparableMetric<Z3i::Space, 1> >(), 0 ) ? 1 : 0;
+  nb++;
+  nbok += checkLineKernel<2>( SeparableLineKernel< ExactPredicateLpSeparableMetric<Z3i::Space, 2> >(), 0 ) ? 1 : 0;
+  nb++;
+  nbok += checkLineKernel<3>( SeparableLineKernel< ExactPredicateLpSeparableMetric<Z3i::Space, 3> >(), 0 ) ? 1 : 0;
+  nb++;
+  nbok += checkLineKernel<1>( PowerLineKernel< ExactPredicateLpPowerSeparableMetric<Z3i::Space, 1> >(), 20 ) ? 1 : 0;
+  nb++;
+  nbok += checkLineKernel<2>( PowerLineKernel< ExactPredicateLpPowerSeparableMetric<Z3i::Space, 2> >(), 20 ) ? 1 : 0;
+  nb++;
+  nbok += checkLineKernel<3>( PowerLineKernel< ExactPredicateLpPowerSeparableMetric<Z3i::Space, 3> >(), 20 ) ? 1 : 0;
+  nb++;
+  trace.info() << "(" << nbok << "/" << nb << ") " << "l_1, l_2, l_3, power l_1, l_2, l_3" << std::endl;
+
+  trace.endBlock();
+  return nbok == nb;
+}
+
 bool testConcepts()
 {
   BOOST_CONCEPT_ASSERT(( concepts::CSeparableMetric<ExactPredicateLpSeparableMetric<Z2i::Space, 2> > ));
@@ -494,6 +689,7 @@ int main( int argc, char** argv )
     && testBinarySearch()
     && testSpecialCasesL2()
     && testSpecialCasesLp()
+    && testLineKernel()
     && testConcepts();
   trace.emphase() << ( res ? "Passed." : "Error." ) << endl;
   trace.endBlock();
@@ -35,6 +35,9 @@
 #include "DGtal/base/Common.h"
 #include "DGtal/helpers/StdDefs.h"
 #include "DGtal/images/CConstImage.h"
+#include "DGtal/images/ImageContainerBySTLVector.h"
+#include "DGtal/images/ImageFactoryFromImage.h"
+#include "DGtal/images/TiledImage.h"
 #include "DGtal/geometry/volumes/distance/VoronoiMap.h"
 #include "DGtal/geometry/volumes/distance/ExactPredicateLpSeparableMetric.h"
 #include "DGtal/geometry/volumes/distance/InexactPredicateLpSeparableMetric.h"
@@ -519,6 +522,33 @@ bool testVoronoiMapFromSites( const Set &aSet, std::array<bool, Set::Space::dime
   DT dt(aSet.domain(), mySet, l2, periodicity);
   trace.endBlock();
 
+  trace.beginBlock("Compact site storage (uint32_t)");
+  typedef ImageContainerBySTLVector<typename Set::Domain, DGtal::uint32_t> CompactImage;
+  typedef VoronoiMap<typename Set::Space, Set, L2Metric, CompactImage> CompactVoro2;
+  CompactVoro2 compactVoro(aSet.domain(), mySet, l2, periodicity);
+  bool same = true;
+  for ( auto const & pt : aSet.domain() )
+    same = same && compactVoro(pt) == voro(pt);
+  nbok += same ? 1 : 0;
+  nb++;
+  nbok += std::equal( compactVoro.constRange().begin(), compactVoro.constRange().end(),
+                      voro.constRange().begin() ) ? 1 : 0;
+  nb++;
+  trace.info() << "same sites: " << same << std::endl;
+  trace.endBlock();
+
+  trace.beginBlock("Raw distance transformation (uint32_t)");
+  CompactImage rawDT(aSet.domain());
+  computeRawDistanceTransformation(aSet.domain(), mySet, l2, rawDT, periodicity);
+  bool sameDT = true;
+  for ( auto const & pt : aSet.domain() )
+    sameDT = sameDT
+      && rawDT(pt) == static_cast<DGtal::uint32_t>( l2.rawDistance( pt, dt.getVoronoiVector(pt) ) );
+  nbok += sameDT ? 1 : 0;
+  nb++;
+  trace.info() << "same distances: " << sameDT << std::endl;
+  trace.endBlock();
+
   return nbok == nb;
 }
 
@@ -648,6 +678,260 @@ bool testSimpleRandom3D()
 
 
 
+/**
+ * Line sweeps by blocks of adjacent lines: a domain spanning several
+ * blocks along the first dimension, the last one incomplete.
+ */
+bool testBlockedSweeps()
+{
+  Z3i::Point a(-5, 2, -1);
+  Z3i::Point b(32, 4, 3);
+  Z3i::Domain domain(a,b);
+
+  Z3i::DigitalSet sites(domain);
+  bool ok = true;
+
+  for(unsigned int i = 0 ; i < 12; ++i)
+    sites.insert( Z3i::Point( a[0] + rand() % 38, a[1] + rand() % 3, a[2] + rand() % 5 ) );
+
+  for ( std::size_t i = 0; i < 8; ++i )
+    {
+      auto const periodicity = getPeriodicityFromInteger<3>(i);
+      trace.beginBlock( "Blocked sweeps with periodicity " + formatPeriodicity(periodicity) );
+      ok = ok && testVoronoiMapFromSites( sites, periodicity );
+      trace.endBlock();
+    }
+
+  return ok;
+}
+
+
+/**
+ * Compact site storage: small index types, no site at all, and
+ * domains too large for the index type.
+ */
+bool testCompactSites()
+{
+  unsigned int nbok = 0;
+  unsigned int nb = 0;
+
+  trace.beginBlock ( "Testing compact site storage" );
+
+  typedef ExactPredicateLpSeparableMetric<Z2i::Space, 2> L2Metric;
+  L2Metric l2;
+
+  // 8x8 points (x3 along the periodic dimension) fit in 8 bits
+  Z2i::Domain small( Z2i::Point(0,0), Z2i::Point(7,7) );
+  Z2i::DigitalSet all(small);
+  for ( auto const & pt : small )
+    all.insertNew( pt );
+  Z2i::DigitalSet set( all );
+  set.erase( Z2i::Point(3,4) );
+  set.erase( Z2i::Point(6,1) );
+
+  typedef ImageContainerBySTLVector<Z2i::Domain, DGtal::uint8_t> Image8;
+  typedef VoronoiMap<Z2i::Space, Z2i::DigitalSet, L2Metric, Image8> Voro8;
+  typedef VoronoiMap<Z2i::Space, Z2i::DigitalSet, L2Metric> Voro;
+  std::array<bool, 2> periodicity = { {false, true} };
+  Voro8 voro8( small, set, l2, periodicity );
+  Voro voro( small, set, l2, periodicity );
+  bool same = true;
+  for ( auto const & pt : small )
+    same = same && voro8(pt) == voro(pt);
+  nbok += same ? 1 : 0;
+  nb++;
+
+  // No site: every point gets the infinity site / distance
+  Voro8 none( small, all, l2 );
+  Voro noneRef( small, all, l2 );
+  nbok += none( Z2i::Point(5,5) ) == noneRef( Z2i::Point(5,5) ) ? 1 : 0;
+  nb++;
+  Image8 rawDT(small);
+  computeRawDistanceTransformation( small, all, l2, rawDT );
+  nbok += std::count( rawDT.begin(), rawDT.end(), 255 ) == (long) small.size() ? 1 : 0;
+  nb++;
+
+  // 300x300 points do not fit in 16 bits
+  Z2i::Domain large( Z2i::Point(0,0), Z2i::Point(299,299) );
+  Z2i::DigitalSet largeSet(large);
+  largeSet.insertNew( Z2i::Point(1,1) );
+  typedef ImageContainerBySTLVector<Z2i::Domain, DGtal::uint16_t> Image16;
+  bool thrown = false;
+  try
+    {
+      VoronoiMap<Z2i::Space, Z2i::DigitalSet, L2Metric, Image16> voro16( large, largeSet, l2 );
+    }
+  catch ( std::overflow_error & )
+    {
+      thrown = true;
+    }
+  nbok += thrown ? 1 : 0;
+  nb++;
+
+  trace.info() << "(" << nbok << "/" << nb << ") tests passed" << std::endl;
+  trace.endBlock();
+  return nbok == nb;
+}
+
+/**
+ * Local updates: random batches of site insertions and removals,
+ * compared with a new computation after each batch.
+ */
+bool testUpdate( std::array<bool, 3> const & periodicity )
+{
+  unsigned int nbok = 0;
+  unsigned int nb = 0;
+
+  trace.beginBlock ( "Testing local updates with periodicity " + formatPeriodicity(periodicity) );
+
+  typedef ExactPredicateLpSeparableMetric<Z3i::Space, 2> L2Metric;
+  typedef ExactPredicateLpSeparableMetric<Z3i::Space, 1> L1Metric;
+  typedef ImageContainerBySTLVector<Z3i::Domain, DGtal::uint32_t> CompactImage;
+  typedef VoronoiMap<Z3i::Space, Z3i::DigitalSet, L2Metric> Voro2;
+  typedef VoronoiMap<Z3i::Space, Z3i::DigitalSet, L2Metric, CompactImage> CompactVoro2;
+  typedef VoronoiMap<Z3i::Space, Z3i::DigitalSet, L1Metric> Voro1;
+  typedef DistanceTransformation<Z3i::Space, Z3i::DigitalSet, L2Metric> DT;
+  L2Metric l2;
+  L1Metric l1;
+
+  Z3i::Domain domain( Z3i::Point(-3,0,2), Z3i::Point(16,17,17) );
+  const Z3i::Point extent = domain.upperBound() - domain.lowerBound() + Z3i::Point::diagonal();
+  auto randomPoint = [&] () {
+    return domain.lowerBound() + Z3i::Point( rand() % extent[0], rand() % extent[1], rand() % extent[2] );
+  };
+
+  Z3i::DigitalSet set(domain);
+  for ( auto const & pt : domain )
+    set.insertNew( pt );
+  for ( unsigned int i = 0; i < 10; ++i )
+    set.erase( randomPoint() );
+
+  Voro2 voro( domain, set, l2, periodicity );
+  CompactVoro2 compactVoro( domain, set, l2, periodicity );
+  Voro1 voro1( domain, set, l1, periodicity );
+  DT dt( domain, set, l2, periodicity );
+
+  for ( unsigned int round = 0; round < 6; ++round )
+    {
+      // Round 0 is the first (full) update; the last one removes every site
+      std::vector<Z3i::Point> edited;
+      if ( round + 1 < 6 )
+        for ( unsigned int i = 0; i < 8; ++i )
+          {
+            const Z3i::Point p = randomPoint();
+            if ( set( p ) )
+              set.erase( p );
+            else
+              set.insertNew( p );
+            edited.push_back( p );
+          }
+      else
+        for ( auto const & pt : domain )
+          if ( ! set( pt ) )
+            {
+              set.insertNew( pt );
+              edited.push_back( pt );
+            }
+
+      voro.update( edited.begin(), edited.end() );
+      compactVoro.update( edited.begin(), edited.end() );
+      voro1.update( edited.begin(), edited.end() );
+      dt.update( edited.begin(), edited.end() );
+
+      Voro2 ref( domain, set, l2, periodicity );
+      Voro1 ref1( domain, set, l1, periodicity );
+      DT refDT( domain, set, l2, periodicity );
+      bool same = true;
+      for ( auto const & pt : domain )
+        same = same && voro(pt) == ref(pt) && compactVoro(pt) == ref(pt)
+          && voro1(pt) == ref1(pt) && dt.getVoronoiVector(pt) == refDT.getVoronoiVector(pt);
+      nbok += same ? 1 : 0;
+      nb++;
+      trace.info() << "round " << round << ", " << edited.size()
+                   << " edited points: same sites " << same << std::endl;
+    }
+
+  trace.info() << "(" << nbok << "/" << nb << ") tests passed" << std::endl;
+  trace.endBlock();
+  return nbok == nb;
+}
+
+/**
+ * Out-of-core computation in a TiledImage, with a cache of one slab
+ * of tiles, compared with the computation in memory.
+ */
+bool testTiledImage( std::array<bool, 3> const & periodicity )
+{
+  unsigned int nbok = 0;
+  unsigned int nb = 0;
+
+  trace.beginBlock ( "Testing tiled image with periodicity " + formatPeriodicity(periodicity) );
+
+  typedef ExactPredicateLpSeparableMetric<Z3i::Space, 2> L2Metric;
+  typedef ImageContainerBySTLVector<Z3i::Domain, DGtal::uint32_t> Image;
+  typedef ImageFactoryFromImage<Image> Factory;
+  typedef ImageCacheReadPolicyFIFO<Image, Factory> ReadPolicy;
+  typedef ImageCacheWritePolicyWB<Image, Factory> WritePolicy;
+  typedef TiledImage<Image, Factory, ReadPolicy, WritePolicy> Tiled;
+  L2Metric l2;
+
+  // 4 tiles of 16x9x9 points along x and z, 5 along y (the last one
+  // of one point)
+  Z3i::Domain domain( Z3i::Point(1,-2,0), Z3i::Point(64,34,35) );
+  Z3i::DigitalSet set(domain);
+  for ( auto const & pt : domain )
+    if ( rand() % 100 != 0 )
+      set.insertNew( pt );
+
+  Image rawDT(domain);
+  computeRawDistanceTransformation( domain, set, l2, rawDT, periodicity );
+
+  // The "disk" image, read and written by tiles
+  Image disk(domain);
+  Factory factory(disk);
+  ReadPolicy readPolicy(factory, 5);
+  WritePolicy writePolicy(factory);
+  Tiled tiled(factory, readPolicy, writePolicy, 4);
+  const unsigned int nbTiles = 4 * 5 * 4;
+
+  computeRawDistanceTransformation( domain, set, l2, tiled, periodicity );
+  trace.info() << "Cache misses: " << tiled.getCacheMissRead() << " (read), "
+               << tiled.getCacheMissWrite() << " (write), for " << nbTiles
+               << " tiles" << std::endl;
+
+  // Each tile is loaded once by the initialization, each dimension
+  // and the distances
+  nbok += tiled.getCacheMissRead() + tiled.getCacheMissWrite() <= 5 * nbTiles ? 1 : 0;
+  nb++;
+
+  bool same = true;
+  for ( auto const & pt : domain )
+    same = same && tiled(pt) == rawDT(pt);
+  nbok += same ? 1 : 0;
+  nb++;
+
+  tiled.flushCache();
+  nbok += std::equal( disk.begin(), disk.end(), rawDT.begin() ) ? 1 : 0;
+  nb++;
+
+  // Voronoi map with compact sites in tiles
+  tiled.clearCacheAndResetCacheMisses();
+  typedef VoronoiMap<Z3i::Space, Z3i::DigitalSet, L2Metric, Tiled> TiledVoro;
+  typedef VoronoiMap<Z3i::Space, Z3i::DigitalSet, L2Metric> Voro;
+  TiledVoro tiledVoro( domain, set, l2, periodicity, tiled );
+  Voro voro( domain, set, l2, periodicity );
+  same = true;
+  for ( auto const & pt : domain )
+    same = same && tiledVoro(pt) == voro(pt);
+  nbok += same ? 1 : 0;
+  nb++;
+
+  trace.info() << "(" << nbok << "/" << nb << ") tests passed" << std::endl;
+  trace.endBlock();
+  return nbok == nb;
+}
+
+
 bool testSimple4D()
 {
 
@@ -695,7 +979,13 @@ int main( int argc, char** argv )
     && testSimpleRandom2D()
     && testSimple3D()
     && testSimpleRandom3D()
+    && testBlockedSweeps()
     && testSimple4D()
+    && testCompactSites()
+    && testUpdate( { {false, false, false} } )
+    && testUpdate( { {true, false, true} } )
+    && testTiledImage( { {false, false, false} } )
+    && testTiledImage( { {true, true, false} } )
     ; // && ... other tests
 
   trace.emphase() << ( res ? "Passed." : "Error." ) << endl;
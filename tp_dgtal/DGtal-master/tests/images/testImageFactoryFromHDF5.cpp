@@ -29,12 +29,17 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 #include <iostream>
+#include <limits>
+#include <vector>
 #include "DGtal/base/Common.h"
 #include "DGtal/helpers/StdDefs.h"
 #include "DGtal/images/ImageSelector.h"
+#include "DGtal/images/ImageContainerBySTLVector.h"
 #include "DGtal/images/ImageFactoryFromHDF5.h"
 #include "DGtal/images/ImageCache.h"
 #include "DGtal/images/TiledImage.h"
+#include "DGtal/geometry/volumes/distance/ExactPredicateLpSeparableMetric.h"
+#include "DGtal/geometry/volumes/distance/DistanceTransformation.h"
 
 #include "ConfigTest.h"
 ///////////////////////////////////////////////////////////////////////////////
@@ -305,6 +310,54 @@ bool writeHDF5_3D_TILED()
     return true;
 }
 
+#define H5FILE_NAME_3D_UINT32   "testImageFactoryFromHDF5_UINT32_3D.h5"
+#define H5FILE_NAME_3D_UINT64   "testImageFactoryFromHDF5_UINT64_3D.h5"
+#define H5FILE_NAME_3D_EDT      "testImageFactoryFromHDF5_EDT_3D.h5"
+
+#define DATASETNAME_3D_UINT32   "UInt32Array3D"
+#define DATASETNAME_3D_UINT64   "UInt64Array3D"
+#define NX_3D_UNSIGNED          32      // dataset dimensions
+#define NY_3D_UNSIGNED          8
+#define NZ_3D_UNSIGNED          8
+#define RANK_3D_UNSIGNED        3
+
+/**
+ * Writes a 3D dataset of zeros of the HDF5 type aType.
+ */
+bool writeHDF5_3D_zeros(const std::string & aFilename, const std::string & aDataset, hid_t aType)
+{
+    hid_t       file, dataset;                                  // file and dataset handles
+    hid_t       dataspace;                                      // handle
+    hsize_t     dimsf[RANK_3D_UNSIGNED];                        // dataset dimensions
+    herr_t      status;
+
+    // Zeros for any type of at most 64 bits.
+    std::vector<DGtal::uint64_t> data(NX_3D_UNSIGNED*NY_3D_UNSIGNED*NZ_3D_UNSIGNED, 0);
+
+    file = H5Fcreate(aFilename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+
+    dimsf[0] = NZ_3D_UNSIGNED;
+    dimsf[1] = NY_3D_UNSIGNED;
+    dimsf[2] = NX_3D_UNSIGNED;
+    dataspace = H5Screate_simple(RANK_3D_UNSIGNED, dimsf, NULL);
+
+    dataset = H5Dcreate2(file, aDataset.c_str(), aType, dataspace,
+                        H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+    status = H5Dwrite(dataset, aType, H5S_ALL, H5S_ALL, H5P_DEFAULT, &data[0]);
+    if (status)
+    {
+      trace.error() << " H5Dwrite error" << std::endl;
+      return false;
+    }
+
+    H5Sclose(dataspace);
+    H5Dclose(dataset);
+    H5Fclose(file);
+
+    return true;
+}
+
 bool test2D_int32()
 {
   unsigned int nbok = 0;
@@ -582,6 +635,112 @@ bool testTiledImage3D_double()
     return nbok == nb;
 }
 
+/**
+ * Writes values above the largest signed integer of the same size
+ * in a sub-domain, then reads the whole dataset back.
+ */
+template <typename TValue>
+bool testRoundTrip3D_unsigned(const std::string & aFilename, const std::string & aDataset)
+{
+    unsigned int nbok = 0;
+    unsigned int nb = 0;
+
+    trace.beginBlock("Testing write/read round trip with ImageFactoryFromHDF5 (3D, " + aDataset + ")");
+
+    typedef ImageContainerBySTLVector<Z3i::Domain, TValue> Image;
+    typedef ImageFactoryFromHDF5<Image> MyImageFactoryFromHDF5;
+
+    const TValue top = std::numeric_limits<TValue>::max();
+    const Z3i::Domain subDomain(Z3i::Point(3,1,2), Z3i::Point(20,6,5));
+    auto valueAt = [&] (const Z3i::Point & aPoint) {
+      return subDomain.isInside(aPoint)
+        ? static_cast<TValue>(top - (aPoint[0] + 32*aPoint[1] + 256*aPoint[2])) : TValue(0);
+    };
+
+    {
+      MyImageFactoryFromHDF5 factImage(aFilename, aDataset);
+      Image *image = factImage.requestImage(subDomain);
+      for (auto const & pt : subDomain)
+        image->setValue(pt, valueAt(pt));
+      factImage.flushImage(image);
+      factImage.detachImage(image);
+    }
+
+    MyImageFactoryFromHDF5 factImage(aFilename, aDataset);
+    Image *image = factImage.requestImage(factImage.domain());
+    bool same = true;
+    for (auto const & pt : factImage.domain())
+      same = same && (*image)(pt) == valueAt(pt);
+    factImage.detachImage(image);
+
+    trace.info() << "Read back value for Point 3,1,2: " << valueAt(Z3i::Point(3,1,2)) << endl;
+    nbok += same ? 1 : 0;
+    nb++;
+
+    trace.info() << "(" << nbok << "/" << nb << ") " << endl;
+
+    trace.endBlock();
+
+    return nbok == nb;
+}
+
+/**
+ * Raw distance transformation into a TiledImage of uint64 site codes
+ * backed by an HDF5 file, compared with the computation in memory.
+ */
+bool testTiledRawDistanceTransformation3D_uint64()
+{
+    unsigned int nbok = 0;
+    unsigned int nb = 0;
+
+    trace.beginBlock("Testing raw distance transformation in a TiledImage with ImageFactoryFromHDF5 (3D)");
+
+    typedef ImageContainerBySTLVector<Z3i::Domain, DGtal::uint64_t> Image;
+    typedef ImageFactoryFromHDF5<Image> MyImageFactoryFromHDF5;
+    typedef ImageCacheReadPolicyFIFO<Image, MyImageFactoryFromHDF5> MyImageCacheReadPolicyFIFO;
+    typedef ImageCacheWritePolicyWB<Image, MyImageFactoryFromHDF5> MyImageCacheWritePolicyWB;
+    typedef TiledImage<Image, MyImageFactoryFromHDF5, MyImageCacheReadPolicyFIFO, MyImageCacheWritePolicyWB> MyTiledImage;
+    typedef ExactPredicateLpSeparableMetric<Z3i::Space, 2> L2Metric;
+    L2Metric l2;
+
+    const Z3i::Domain domain(Z3i::Point(0,0,0), Z3i::Point(NX_3D_UNSIGNED-1, NY_3D_UNSIGNED-1, NZ_3D_UNSIGNED-1));
+    Z3i::DigitalSet set(domain);
+    for (auto const & pt : domain)
+      if ( (pt[0]*7 + pt[1]*13 + pt[2]*29) % 61 != 0 )
+        set.insertNew(pt);
+
+    Image rawDT(domain);
+    computeRawDistanceTransformation(domain, set, l2, rawDT);
+
+    {
+      // 2x2x2 tiles of 16x4x4 points, a cache of one slab
+      MyImageFactoryFromHDF5 factImage(H5FILE_NAME_3D_EDT, DATASETNAME_3D_UINT64);
+      MyImageCacheReadPolicyFIFO imageCacheReadPolicyFIFO(factImage, 2);
+      MyImageCacheWritePolicyWB imageCacheWritePolicyWB(factImage);
+      MyTiledImage tiledImage(factImage, imageCacheReadPolicyFIFO, imageCacheWritePolicyWB, 2);
+
+      computeRawDistanceTransformation(domain, set, l2, tiledImage);
+      tiledImage.flushCache();
+      trace.info() << "Cache misses: " << tiledImage.getCacheMissRead() << " (read), "
+                   << tiledImage.getCacheMissWrite() << " (write)" << endl;
+    }
+
+    MyImageFactoryFromHDF5 factImage(H5FILE_NAME_3D_EDT, DATASETNAME_3D_UINT64);
+    Image *image = factImage.requestImage(domain);
+    bool same = true;
+    for (auto const & pt : domain)
+      same = same && (*image)(pt) == rawDT(pt);
+    factImage.detachImage(image);
+    nbok += same ? 1 : 0;
+    nb++;
+
+    trace.info() << "(" << nbok << "/" << nb << ") " << endl;
+
+    trace.endBlock();
+
+    return nbok == nb;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Standard services - public :
 
@@ -602,6 +761,13 @@ int main( int argc, char** argv )
     res = res && writeHDF5_3D_TILED();
     res = res && testTiledImage3D_double();
 
+    res = res && writeHDF5_3D_zeros(H5FILE_NAME_3D_UINT32, DATASETNAME_3D_UINT32, H5T_NATIVE_UINT32)
+      && testRoundTrip3D_unsigned<DGtal::uint32_t>(H5FILE_NAME_3D_UINT32, DATASETNAME_3D_UINT32);
+    res = res && writeHDF5_3D_zeros(H5FILE_NAME_3D_UINT64, DATASETNAME_3D_UINT64, H5T_NATIVE_UINT64)
+      && testRoundTrip3D_unsigned<DGtal::uint64_t>(H5FILE_NAME_3D_UINT64, DATASETNAME_3D_UINT64);
+    res = res && writeHDF5_3D_zeros(H5FILE_NAME_3D_EDT, DATASETNAME_3D_UINT64, H5T_NATIVE_UINT64)
+      && testTiledRawDistanceTransformation3D_uint64();
+
     trace.emphase() << ( res ? "Passed." : "Error." ) << endl;
     trace.endBlock();
     return res ? 0 : 1;